@@ -3,51 +3,61 @@
 #include "EventBus.h"
 #include "InputSystem.h"
 #include <string>
+#include <stdexcept>
 #include <typeindex>
 #include "BaseComponent.h"
+#include "Registry.h"
+#include "World.h"
 
 
 class Actor2D : public Transform2D {
 public:
-    std::vector<std::shared_ptr<BaseComponent>> components;
     std::string spriteName;
 
+    // The world this actor lives in, the one current on its thread when it was built
+    World* world = World::current();
+
     Actor2D() = default;
-    virtual ~Actor2D() = default;
+    Actor2D(const Actor2D&) = delete;
+    Actor2D& operator=(const Actor2D&) = delete;
+
+    virtual ~Actor2D() {
+        if (registry) registry->destroy(entity);
+    }
 
+    // Components live in the registry, the actor only keeps its entity.
+    // The returned handle stays valid while the storage behind it moves.
     template <typename T, typename... Args>
-    std::shared_ptr<T> addComponent(Args&&... args) {
+    ComponentRef<T> addComponent(Args&&... args) {
         static_assert(std::is_base_of<BaseComponent, T>::value,
             "T must inherit BaseComponent");
 
-        auto comp = std::make_shared<T>(std::forward<Args>(args)...);
-        comp->owner = this;
-        components.push_back(comp);
-        return comp;
+        if (!registry) {
+            // Components live in a world's registry, there has to be one
+            if (!world)
+                throw std::logic_error("Actor2D::addComponent: the actor has no World, build it inside a World::Scope");
+            registry = world->registry.get();
+            entity = registry->create();
+        }
+
+        T& comp = registry->add<T>(entity, std::forward<Args>(args)...);
+        comp.owner = this;
+        comp.world = world;
+        return ComponentRef<T>(registry, entity);
     }
 
     template <typename T>
     void removeComponent() {
-        components.erase(
-            std::remove_if(
-                components.begin(),
-                components.end(),
-                [&](const std::shared_ptr<BaseComponent>& c) {
-                    return dynamic_cast<T*>(c.get()) != nullptr;
-                }),
-            components.end()
-        );
+        if (registry) registry->remove<T>(entity);
     }
 
     template <typename T>
-    std::shared_ptr<T> getComponent(){
-        for (auto& c : components) {
-            if (auto t = std::dynamic_pointer_cast<T>(c))
-                return t;
-        }
-        return nullptr;
+    ComponentRef<T> getComponent() {
+        return ComponentRef<T>(registry, entity);
     }
 
+    Entity getEntity() const { return entity; }
+
     // Pure virtual update
     virtual void update(double dt) {};
 
@@ -61,6 +71,24 @@ public:
         float rot = - getWorldRotation() - radians(90.0f);
         return vec2(cos(rot), sin(rot));
     }
+
+protected:
+    // Transform plus every registry component that supports snapshots
+    void saveOwnState(SnapshotWriter& out) const override {
+        Transform2D::saveOwnState(out);
+        if (registry) registry->saveComponents(entity, out);
+        else out.write(uint32_t(0));
+    }
+
+    void loadOwnState(SnapshotReader& in) override {
+        Transform2D::loadOwnState(in);
+        if (registry) registry->loadComponents(entity, in);
+        else in.expect(uint32_t(0));
+    }
+
+private:
+    Registry* registry = nullptr;
+    Entity entity;
 };
 
 
@@ -0,0 +1,76 @@
+#include "AllocationCounter.h"
+
+#ifdef COUNT_ALLOCATIONS
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Counts every heap allocation made through operator new, used by the headless
+// benchmark to check that steady-state gameplay doesn't allocate. All the replaceable
+// forms are covered so nothing slips past: plain, array, aligned and nothrow.
+namespace {
+    std::atomic<size_t> allocations{ 0 };
+    std::atomic<size_t> allocatedBytes{ 0 };
+
+    void count(size_t size) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+
+    void* countedAlloc(size_t size) noexcept {
+        count(size);
+        return std::malloc(size ? size : 1);
+    }
+
+    void* countedAlignedAlloc(size_t size, std::align_val_t alignment) noexcept {
+        count(size);
+        size_t align = static_cast<size_t>(alignment);
+        size = (size ? size + align - 1 : align) / align * align;
+#ifdef _WIN32
+        return _aligned_malloc(size, align);
+#else
+        return std::aligned_alloc(align, size);
+#endif
+    }
+
+    void alignedFree(void* p) noexcept {
+#ifdef _WIN32
+        _aligned_free(p);
+#else
+        std::free(p);
+#endif
+    }
+
+    void* orThrow(void* p) {
+        if (!p) throw std::bad_alloc();
+        return p;
+    }
+}
+
+size_t AllocationCounter::count() { return allocations.load(std::memory_order_relaxed); }
+size_t AllocationCounter::bytes() { return allocatedBytes.load(std::memory_order_relaxed); }
+
+void* operator new(size_t size) { return orThrow(countedAlloc(size)); }
+void* operator new[](size_t size) { return orThrow(countedAlloc(size)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return countedAlloc(size); }
+
+void* operator new(size_t size, std::align_val_t align) { return orThrow(countedAlignedAlloc(size, align)); }
+void* operator new[](size_t size, std::align_val_t align) { return orThrow(countedAlignedAlloc(size, align)); }
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, align); }
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept { return countedAlignedAlloc(size, align); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+
+void operator delete(void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { alignedFree(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { alignedFree(p); }
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstddef>
+
+// Global heap allocation counter. Only the Bench configuration defines COUNT_ALLOCATIONS
+// and gets the operator new/delete replacements in AllocationCounter.cpp; every other
+// build uses the default allocator and counts nothing.
+namespace AllocationCounter {
+#ifdef COUNT_ALLOCATIONS
+    constexpr bool enabled = true;
+    size_t count();
+    size_t bytes();
+#else
+    constexpr bool enabled = false;
+    inline size_t count() { return 0; }
+    inline size_t bytes() { return 0; }
+#endif
+}
@@ -44,12 +44,17 @@ public:
 	}
 
 	void setStickPosition(vec2 pos) {
+		position = displacedPosition(pos);
+		markDirty();
+	}
+
+	// Where the head sits (in the parent's space) for a stick value
+	vec2 displacedPosition(vec2 pos) const {
 		// Clamp position to unit circle
 		if (length(pos) > 1.0f) {
 			pos = normalize(pos);
 		}
-		position = stickPosition + pos * displacementFactor * scale;
-		markDirty();
+		return stickPosition + pos * displacementFactor * scale;
 	}
 
 };
\ No newline at end of file
@@ -1,9 +1,11 @@
 #pragma once
 class Actor2D;
+class World;
 
 class BaseComponent {
 public:
     Actor2D* owner = nullptr;
+    World* world = nullptr;
 
     virtual ~BaseComponent() = default;
     virtual void update(double dt) {}
@@ -0,0 +1,325 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "World.h"
+#include "ShipFactory.h"
+#include "Guns.h"
+#include "SimpleShootingAi.h"
+#include "SystemScheduler.h"
+#include "ProjectileSystem.h"
+#include "CollisionSystem.h"
+#include "DamageSystem.h"
+#include "EventBus.h"
+#include "Registry.h"
+#include "Random.h"
+
+// Headless AI-vs-AI duels over a grid of tuning values, run with:
+//   V3.exe --batch grid.txt results.csv [threads]
+//
+// Each grid point plays `matches` duels of a tuned ship against one with the default
+// values. Both are flown by SimpleShootingAi and carry an EnemyGun, and every match runs
+// in a World of its own on one of the worker threads. All grid points replay the same
+// match seeds, so differences between rows come from the values and not the layouts.
+//
+// Grid file, one list per line, values not listed keep their defaults:
+//   pd_p = 400, 800, 1600
+//   preferred_distance = 300:700:100       # start:end:step
+//   matches = 200
+//   max_seconds = 60
+//   seed = 1
+namespace BatchRunner {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct TuningParams {
+        float pdP;                  // Ship::PD_p
+        float pdD;                  // Ship::PD_d
+        float preferredDistance;    // SimpleShootingAi
+        float shotInterval;         // EnemyGun
+        float damage;
+        float shotSpeed;
+    };
+
+    struct ParamInfo {
+        const char* name;
+        float TuningParams::* field;
+    };
+
+    inline constexpr ParamInfo params[] = {
+        { "pd_p", &TuningParams::pdP },
+        { "pd_d", &TuningParams::pdD },
+        { "preferred_distance", &TuningParams::preferredDistance },
+        { "shot_interval", &TuningParams::shotInterval },
+        { "damage", &TuningParams::damage },
+        { "shot_speed", &TuningParams::shotSpeed },
+    };
+    inline constexpr size_t paramCount = sizeof(params) / sizeof(params[0]);
+
+    // What a ship, gun and pilot start with, the baseline every match is played against
+    inline TuningParams defaultParams() {
+        World world(0);
+        World::Scope scope(world);
+        Ship ship;
+        EnemyGun gun;
+        SimpleShootingAi pilot;
+        return { ship.PD_p, ship.PD_d, pilot.preferredDistance, static_cast<float>(gun.shotInterval), gun.damage, gun.shotSpeed };
+    }
+
+    inline void apply(const TuningParams& p, Ship& ship, EnemyGun& gun, SimpleShootingAi& pilot) {
+        ship.PD_p = p.pdP;
+        ship.PD_d = p.pdD;
+        pilot.preferredDistance = p.preferredDistance;
+        gun.shotInterval = p.shotInterval;
+        gun.damage = p.damage;
+        gun.shotSpeed = p.shotSpeed;
+    }
+
+    struct Grid {
+        std::vector<float> values[paramCount];  // empty keeps the default
+        int matches = 100;
+        double maxSeconds = 60.0;
+        uint64_t seed = 1;
+
+        // Every combination, the first parameter changing slowest
+        std::vector<TuningParams> points(const TuningParams& defaults) const {
+            std::vector<TuningParams> out{ defaults };
+            for (size_t i = 0; i < paramCount; i++) {
+                if (values[i].empty()) continue;
+                std::vector<TuningParams> expanded;
+                expanded.reserve(out.size() * values[i].size());
+                for (const TuningParams& p : out)
+                    for (float v : values[i]) {
+                        expanded.push_back(p);
+                        expanded.back().*params[i].field = v;
+                    }
+                out.swap(expanded);
+            }
+            return out;
+        }
+    };
+
+    // "a, b, c" or "start:end:step"
+    inline bool parseValues(const std::string& text, std::vector<float>& out) {
+        out.clear();
+        if (text.find(':') != std::string::npos) {
+            float start, end, step;
+            char c1, c2;
+            std::istringstream in(text);
+            if (!(in >> start >> c1 >> end >> c2 >> step) || c1 != ':' || c2 != ':' || step <= 0.0f || end < start)
+                return false;
+            for (int i = 0; start + i * step <= end + step * 1e-3f; i++)
+                out.push_back(start + i * step);
+            return true;
+        }
+
+        std::istringstream in(text);
+        std::string item;
+        while (std::getline(in, item, ',')) {
+            char* parsedTo = nullptr;
+            float v = std::strtof(item.c_str(), &parsedTo);
+            if (parsedTo == item.c_str()) return false;
+            out.push_back(v);
+        }
+        return !out.empty();
+    }
+
+    inline bool parseGrid(const char* path, Grid& grid, std::string& error) {
+        std::ifstream file(path);
+        if (!file) {
+            error = std::string("Couldn't open grid ") + path;
+            return false;
+        }
+
+        std::string line;
+        for (int lineNumber = 1; std::getline(file, line); lineNumber++) {
+            line = line.substr(0, line.find('#'));
+            size_t eq = line.find('=');
+            if (eq == std::string::npos) {
+                if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+                error = "Line " + std::to_string(lineNumber) + ": expected name = values";
+                return false;
+            }
+
+            std::string key = line.substr(0, eq);
+            key.erase(std::remove_if(key.begin(), key.end(), [](char c) { return c == ' ' || c == '\t'; }), key.end());
+            std::vector<float> values;
+            if (!parseValues(line.substr(eq + 1), values)) {
+                error = "Line " + std::to_string(lineNumber) + ": bad values for " + key;
+                return false;
+            }
+
+            if (key == "matches") grid.matches = std::max(1, static_cast<int>(values[0]));
+            else if (key == "max_seconds") grid.maxSeconds = values[0];
+            else if (key == "seed") grid.seed = static_cast<uint64_t>(values[0]);
+            else {
+                auto it = std::find_if(std::begin(params), std::end(params), [&](const ParamInfo& p) { return key == p.name; });
+                if (it == std::end(params)) {
+                    error = "Line " + std::to_string(lineNumber) + ": unknown parameter " + key;
+                    return false;
+                }
+                grid.values[it - std::begin(params)] = values;
+            }
+        }
+        return true;
+    }
+
+    struct MatchResult {
+        int winner = -1;            // 0 tuned, 1 baseline, -1 draw
+        double seconds = 0.0;       // until the kill, or the time limit
+        uint64_t shots[2] = {};
+    };
+
+    // One duel, tuned ship on the left against the baseline on the right
+    inline MatchResult playMatch(const TuningParams& tuned, uint64_t seed, double maxSeconds) {
+        const double dt = 1.0 / 60.0;
+
+        World world(seed);
+        World::Scope scope(world);
+        Pcg32 layout(seed, 7);
+
+        SystemScheduler systems;
+        addGameplayPasses(systems);
+
+        std::shared_ptr<Ship> ships[2];
+        std::shared_ptr<EnemyGun> guns[2];
+        SimpleShootingAi pilots[2];
+        for (int side = 0; side < 2; side++) {
+            vec2 at(side == 0 ? layout.uniform(200.0f, 700.0f) : layout.uniform(1220.0f, 1720.0f), layout.uniform(150.0f, 930.0f));
+            ships[side] = ShipFactory::spawnEnemy(world, at);
+            guns[side] = std::dynamic_pointer_cast<EnemyGun>(ships[side]->hardpoints[0]->weapon);
+            pilots[side].possess(ships[side].get());
+        }
+
+        ships[0]->setTeam(0);
+        ships[0]->collider->layer = CollisionLayer::Player;
+        guns[0]->team = 0;
+        apply(tuned, *ships[0], *guns[0], pilots[0]);
+
+        MatchResult result;
+        int ticks = static_cast<int>(maxSeconds / dt);
+        result.seconds = ticks * dt;
+        for (int t = 0; t < ticks; t++) {
+            for (int side = 0; side < 2; side++) {
+                Ship& target = *ships[1 - side];
+                pilots[side].setTarget(target.getWorldPosition(), target.getVelocity());
+                pilots[side].update(dt);
+            }
+            for (auto& ship : ships) ship->update(dt);
+
+            systems.update(*world.registry, dt);
+            world.projectiles->update(dt);
+            world.collisions->update();
+            world.damage->flush(*world.registry);
+            world.eventBus->clear();
+
+            bool lost[2] = { ships[0]->isDead(), ships[1]->isDead() };
+            if (lost[0] || lost[1]) {
+                result.winner = lost[0] == lost[1] ? -1 : (lost[1] ? 0 : 1);
+                result.seconds = (t + 1) * dt;
+                break;
+            }
+        }
+
+        for (int side = 0; side < 2; side++)
+            result.shots[side] = guns[side]->shotsFired;
+        return result;
+    }
+
+    inline bool writeCsv(const char* path, const std::vector<TuningParams>& points, const std::vector<MatchResult>& results, int matches) {
+        std::ofstream out(path, std::ios::trunc);
+        if (!out) return false;
+
+        for (const ParamInfo& p : params) out << p.name << ',';
+        out << "matches,wins,losses,draws,win_rate,avg_time_to_kill,avg_shots_fired,avg_enemy_shots_fired\n";
+
+        char line[256];
+        for (size_t i = 0; i < points.size(); i++) {
+            int wins = 0, losses = 0, draws = 0;
+            double killSeconds = 0.0;
+            uint64_t shots = 0, enemyShots = 0;
+            for (int m = 0; m < matches; m++) {
+                const MatchResult& r = results[i * matches + m];
+                if (r.winner == 0) {
+                    wins++;
+                    killSeconds += r.seconds;
+                }
+                else if (r.winner == 1) losses++;
+                else draws++;
+                shots += r.shots[0];
+                enemyShots += r.shots[1];
+            }
+
+            for (const ParamInfo& p : params) {
+                std::snprintf(line, sizeof(line), "%g,", points[i].*p.field);
+                out << line;
+            }
+            // Time to kill only counts the matches the tuned ship won
+            std::snprintf(line, sizeof(line), "%d,%d,%d,%d,%.4f,", matches, wins, losses, draws, double(wins) / matches);
+            out << line;
+            if (wins) {
+                std::snprintf(line, sizeof(line), "%.3f", killSeconds / wins);
+                out << line;
+            }
+            std::snprintf(line, sizeof(line), ",%.2f,%.2f\n", double(shots) / matches, double(enemyShots) / matches);
+            out << line;
+        }
+        return bool(out);
+    }
+
+    inline int run(int argc, char** argv) {
+        if (argc < 4) {
+            printf("usage: V3.exe --batch grid.txt results.csv [threads]\n");
+            return 1;
+        }
+
+        Grid grid;
+        std::string error;
+        if (!parseGrid(argv[2], grid, error)) {
+            printf("%s\n", error.c_str());
+            return 1;
+        }
+
+        unsigned threads = argc > 4 ? static_cast<unsigned>(std::atoi(argv[4])) : std::thread::hardware_concurrency();
+        threads = std::max(1u, threads);
+
+        std::vector<TuningParams> points = grid.points(defaultParams());
+        size_t total = points.size() * grid.matches;
+        std::vector<MatchResult> results(total);
+        printf("batch: %zu grid points x %d matches on %u threads\n", points.size(), grid.matches, threads);
+
+        // Workers take the next match until none are left
+        std::atomic<size_t> next{ 0 };
+        auto worker = [&] {
+            for (size_t job; (job = next.fetch_add(1, std::memory_order_relaxed)) < total;) {
+                uint64_t matchSeed = grid.seed * 0x9e3779b97f4a7c15ULL + job % grid.matches;
+                results[job] = playMatch(points[job / grid.matches], matchSeed, grid.maxSeconds);
+            }
+        };
+
+        auto start = Clock::now();
+        std::vector<std::thread> pool;
+        for (unsigned i = 1; i < threads; i++) pool.emplace_back(worker);
+        worker();
+        for (auto& t : pool) t.join();
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        if (!writeCsv(argv[3], points, results, grid.matches)) {
+            printf("Couldn't write %s\n", argv[3]);
+            return 1;
+        }
+
+        printf("  %zu matches in %.2f s, %.1f matches/s, %.1f matches/s per core\n",
+            total, seconds, total / seconds, total / seconds / threads);
+        printf("  results in %s\n", argv[3]);
+        return 0;
+    }
+}
@@ -0,0 +1,1538 @@
+#pragma once
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <memory>
+#include <queue>
+#include <thread>
+
+#include "ShipFactory.h"
+#include "Guns.h"
+#include "Services.h"
+#include "InputSystem.h"
+#include "EventBus.h"
+#include "EventHandler.h"
+#include "ProjectileSystem.h"
+#include "CollisionSystem.h"
+#include "Random.h"
+#include "Registry.h"
+#include "SystemScheduler.h"
+#include "DamageSystem.h"
+#include "PhysicalActor2D.h"
+#include "HealthComponent.h"
+#include "BindingGenerator.h"
+#include "GamepadSampler.h"
+#include "InputTiming.h"
+#include "InputRecording.h"
+#include "PlayerController.h"
+#include "AllocationCounter.h"
+#include "WorldSnapshot.h"
+#include "Rollback.h"
+#include "SpectatorStream.h"
+#include "Director.h"
+#include "SwarmController.h"
+#include "FlowField.h"
+#include "Flocking.h"
+#include "WaveSpawner.h"
+
+// Headless benchmarks, run with: V3.exe --bench [shipsPerSide] [frames] [actors]
+// No window, GL context or sound device is created.
+
+namespace Benchmark {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Correctness checks, --bench exits non-zero when any of them failed
+    inline int failedChecks = 0;
+
+    inline bool check(bool ok, const char* what) {
+        if (!ok) {
+            failedChecks++;
+            printf("  FAILED: %s\n", what);
+        }
+        return ok;
+    }
+
+    // A fresh world for the benchmarks that follow, current on this thread
+    inline World& initHeadlessServices(uint64_t seed) {
+        World* world = new World(seed);
+        World::makeCurrent(world);
+        Services::init(
+            new InputSystem,
+            nullptr,
+            nullptr,
+            new EventHandler,
+            *world
+        );
+        return *world;
+    }
+
+    struct CombatScene {
+        World* world = nullptr;
+        std::vector<std::shared_ptr<Ship>> left;
+        std::vector<std::shared_ptr<Ship>> right;
+        SystemScheduler systems;
+        size_t deaths = 0;
+    };
+
+    // Minigun ships (projectile mode) facing a line of enemies
+    inline CombatScene buildCombatScene(World& world, int shipsPerSide) {
+        World::Scope scope(world);
+        CombatScene scene;
+        scene.world = &world;
+        addGameplayPasses(scene.systems);
+
+        for (int i = 0; i < shipsPerSide; i++) {
+            float y = 100.0f + i * (880.0f / glm::max(1, shipsPerSide - 1));
+
+            auto ship = ShipFactory::spawnPlayer(world, vec2(300.0f, y));
+            auto hp = std::make_shared<Hardpoint>();
+            hp->position = vec2(0, -1.0f);
+            auto gun = std::make_shared<LaserMinigun>();
+            gun->fireMode = FireMode::Projectile;
+            hp->attachWeapon(gun);
+            ship->addHardpoint(hp, 0);
+            scene.left.push_back(ship);
+
+            scene.right.push_back(ShipFactory::spawnEnemy(world, vec2(1600.0f, y)));
+        }
+
+        return scene;
+    }
+
+    inline void stepCombat(CombatScene& scene, double dt, bool fire = true) {
+        auto drive = [&](std::vector<std::shared_ptr<Ship>>& ships, std::vector<std::shared_ptr<Ship>>& targets) {
+            for (size_t i = 0; i < ships.size(); i++) {
+                auto& ship = ships[i];
+                if (ship->isDead()) ship->respawnHealth();
+
+                ship->setMoveDirection(vec2(0.0f));
+                ship->setAimDirection(targets[i]->getWorldPosition() - ship->getWorldPosition());
+                ship->useAbility(0, fire);
+            }
+        };
+
+        drive(scene.left, scene.right);
+        drive(scene.right, scene.left);
+
+        for (auto& s : scene.left) s->update(dt);
+        for (auto& s : scene.right) s->update(dt);
+
+        World& world = *scene.world;
+        scene.systems.update(*world.registry, dt);
+
+        world.projectiles->update(dt);
+        world.collisions->update();
+        world.damage->flush(*world.registry);
+
+        Services::eventHandler->processEvents(*world.eventBus);
+        world.eventBus->process<DeathEvent>([&](const DeathEvent&) { scene.deaths++; });
+        world.eventBus->clear();
+    }
+
+    // Reports frame cost and heap allocations once the pools are warm
+    inline void runCombat(int shipsPerSide, int frames) {
+        const double dt = 1.0 / 75.0;
+        const int warmupFrames = 900; // long enough for every gun to fire, overheat and cool down once
+
+        Services::projectiles->prewarm(256 * shipsPerSide);
+        CombatScene scene = buildCombatScene(*World::current(), shipsPerSide);
+
+        for (int i = 0; i < warmupFrames; i++)
+            stepCombat(scene, dt);
+
+        size_t allocsBefore = AllocationCounter::count();
+        size_t projectileSum = 0;
+        scene.deaths = 0;
+        auto start = Clock::now();
+
+        for (int i = 0; i < frames; i++) {
+            stepCombat(scene, dt);
+            projectileSum += Services::projectiles->projectiles.size();
+        }
+
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        size_t allocs = AllocationCounter::count() - allocsBefore;
+
+        printf("combat: %d vs %d ships, %d frames\n", shipsPerSide, shipsPerSide, frames);
+        printf("  %.3f ms/frame, avg %.0f live projectiles, %zu ships destroyed\n",
+            seconds * 1000.0 / frames, double(projectileSum) / frames, scene.deaths);
+        if (AllocationCounter::enabled)
+            printf("  %zu heap allocations (%.2f per frame)\n", allocs, double(allocs) / frames);
+        else
+            printf("  heap allocations not counted, build the Bench configuration\n");
+    }
+
+    // Per-actor virtual component updates against one batched pass per component type
+    inline void runComponentUpdates(int actorCount, int frames) {
+        const double dt = 1.0 / 75.0;
+
+        std::vector<std::shared_ptr<PhysicalActor2D>> actors;
+        for (int i = 0; i < actorCount; i++) {
+            auto actor = std::make_shared<PhysicalActor2D>();
+            actor->addComponent<HealthComponent>(100.0f, 0.0f, 0);
+            actor->physics->velocity = vec2(float(i % 7), float(i % 5));
+            actors.push_back(actor);
+        }
+
+        SystemScheduler systems;
+        addGameplayPasses(systems);
+
+        // What every actor used to do: walk its own component list through the vtable
+        std::vector<std::vector<BaseComponent*>> componentLists;
+        for (auto& actor : actors)
+            componentLists.push_back({ actor->physics.get(), actor->getComponent<HealthComponent>().get() });
+
+        auto start = Clock::now();
+        for (int f = 0; f < frames; f++) {
+            for (auto& components : componentLists)
+                for (BaseComponent* c : components)
+                    c->update(dt);
+        }
+        double perActor = std::chrono::duration<double>(Clock::now() - start).count();
+
+        start = Clock::now();
+        for (int f = 0; f < frames; f++)
+            systems.update(*Services::registry, dt);
+        double batched = std::chrono::duration<double>(Clock::now() - start).count();
+
+        double updates = double(actorCount) * frames;
+        printf("component updates: %d actors, %d frames, %zu passes\n", actorCount, frames, systems.passCount());
+        printf("  per actor: %.1f ns/actor\n", perActor * 1e9 / updates);
+        printf("  batched:   %.1f ns/actor\n", batched * 1e9 / updates);
+    }
+
+    // InputSystem player evaluation with a changing synthetic raw state
+    inline void runInputUpdate(int playerCount, int iterations) {
+        InputSystem input;
+
+        for (int i = 0; i < playerCount; i++) {
+            PlayerInput player;
+            if (i % 2 == 0) {
+                bindKeyboardAndMouse({ DeviceType::Keyboard, 0 }, { DeviceType::Mouse, 0 }, player, 1080);
+            }
+            else {
+                bindGamepad({ DeviceType::Gamepad, (i / 2) % 4 }, player);
+            }
+            input.players.push_back(player);
+        }
+
+        Pcg32 rng(0x1a9u);
+        const int keys[] = { GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D };
+        size_t pressed = 0;
+
+        // Keyboard and mouse arrive as synthetic callback events, gamepads as raw state
+        auto start = Clock::now();
+        for (int it = 0; it < iterations; it++) {
+            RawInputData& raw = input.raw;
+            input.events.onKey(keys[it & 3], (rng.nextU32() & 1) ? GLFW_PRESS : GLFW_RELEASE);
+            input.events.onMouseButton(it & 1, (rng.nextU32() & 1) ? GLFW_PRESS : GLFW_RELEASE);
+            input.events.onCursorPos(rng.uniform(0.0f, 1920.0f), rng.uniform(0.0f, 1080.0f));
+            for (int pad = 0; pad < 4; pad++) {
+                raw.gamepadAxes[pad][it % GLFW_GAMEPAD_AXIS_LAST] = rng.uniform(-1.0f, 1.0f);
+                raw.gamepadButtons[pad][GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER] = (rng.nextU32() & 1);
+            }
+
+            input.events.apply(raw);
+            input.updatePlayers();
+
+            for (auto& player : input.players)
+                pressed += player.isPressed(Action::PrimaryAbility);
+        }
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        // A click that starts and ends between two updates must still register once
+        input.events.onMouseButton(GLFW_MOUSE_BUTTON_1, GLFW_RELEASE);
+        input.events.apply(input.raw);
+        input.updatePlayers();
+        input.events.onMouseButton(GLFW_MOUSE_BUTTON_1, GLFW_PRESS);
+        input.events.onMouseButton(GLFW_MOUSE_BUTTON_1, GLFW_RELEASE);
+        input.events.apply(input.raw);
+        input.updatePlayers();
+        bool tapSeen = input.players[0].isPressed(Action::PrimaryAbility);
+        input.events.apply(input.raw);
+        input.updatePlayers();
+        bool tapEnded = input.players[0].isReleased(Action::PrimaryAbility);
+
+        // Nothing moving: no action needs evaluating
+        start = Clock::now();
+        size_t idleEvaluated = 0;
+        for (int it = 0; it < iterations; it++) {
+            input.events.apply(input.raw);
+            input.updatePlayers();
+            for (auto& player : input.players)
+                idleEvaluated += player.lastEvaluated();
+        }
+        double idleSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        // Against players that evaluate every action each update (compile marks all stale)
+        std::vector<PlayerInput> reference = input.players;
+        size_t compared = 0, mismatches = 0, evaluated = 0;
+        for (int it = 0; it < 20000; it++) {
+            RawInputData& raw = input.raw;
+            if (rng.nextU32() % 4 == 0) input.events.onKey(keys[rng.nextU32() & 3], (rng.nextU32() & 1) ? GLFW_PRESS : GLFW_RELEASE);
+            if (rng.nextU32() % 8 == 0) input.events.onMouseButton(rng.nextU32() & 1, (rng.nextU32() & 1) ? GLFW_PRESS : GLFW_RELEASE);
+            if (rng.nextU32() % 4 == 0) input.events.onCursorPos(rng.uniform(0.0f, 1920.0f), rng.uniform(0.0f, 1080.0f));
+            int pad = rng.nextU32() % 4;
+            if (rng.nextU32() % 4 == 0) raw.gamepadAxes[pad][rng.nextU32() % GLFW_GAMEPAD_AXIS_LAST] = rng.uniform(-1.0f, 1.0f);
+            if (rng.nextU32() % 8 == 0) raw.gamepadButtons[pad][rng.nextU32() % GLFW_GAMEPAD_BUTTON_LAST] ^= 1;
+
+            input.events.apply(raw);
+            input.updatePlayers();
+            for (size_t p = 0; p < reference.size(); p++) {
+                reference[p].compile();
+                reference[p].update(raw);
+                evaluated += input.players[p].lastEvaluated();
+                for (size_t a = 0; a < ActionCount; a++) {
+                    Action action = static_cast<Action>(a);
+                    compared++;
+                    mismatches += input.players[p].isDown(action) != reference[p].isDown(action) ||
+                        input.players[p].isPressed(action) != reference[p].isPressed(action) ||
+                        input.players[p].getAnalog(action) != reference[p].getAnalog(action);
+                }
+            }
+        }
+
+        printf("input update: %d players, %d iterations\n", playerCount, iterations);
+        printf("  %.1f ns per InputSystem update with every source moving (%zu presses seen)\n", seconds * 1e9 / iterations, pressed);
+        printf("  %.1f ns per update when idle, %zu actions evaluated\n", idleSeconds * 1e9 / iterations, idleEvaluated);
+        printf("  changed sources only: %zu/%zu action states match full evaluation, %.2f of %zu actions evaluated per player update\n",
+            compared - mismatches, compared, double(evaluated) / (20000.0 * reference.size()), ActionCount);
+        printf("  short tap between updates: %s\n", tapSeen && tapEnded ? "pressed and released" : "LOST");
+        check(mismatches == 0, "incremental input evaluation differs from full evaluation");
+        check(tapSeen && tapEnded, "short tap between updates lost");
+    }
+
+    // Background sampler fed by a noisy synthetic pad while the main thread drains once per 75 Hz frame
+    inline void runGamepadSampler(double rateHz, double seconds) {
+        InputSystem input;
+        GamepadSampler sampler;
+        input.setGamepadSampler(&sampler);
+
+        auto source = std::make_unique<SyntheticGamepadSource>();
+        source->noise = 0.01f;
+        source->restDuty = 0.5f;
+        sampler.start(std::move(source), rateHz, 0xF);
+
+        auto timing = std::make_unique<InputTiming>();
+        size_t maxPerFrame = 0;
+
+        auto end = Clock::now() + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+        while (Clock::now() < end) {
+            std::this_thread::sleep_for(std::chrono::microseconds(13333));
+            input.update();
+            maxPerFrame = std::max(maxPerFrame, input.gamepadSamples[0].size());
+            timing->onTick(input.gamepadSamples[0], sampler.now());
+            timing->onSwap(sampler.now());
+        }
+        // Only pad 0 is connected, the others stay on GLFW polling
+        bool sampledOnlyPad0 = input.isSampled(0) && !input.isSampled(1) && !input.isSampled(2) && !input.isSampled(3);
+        sampler.stop();
+
+        const auto& poll = timing->pollInterval;
+        printf("gamepad sampler: %.0f Hz for %.2f s\n", rateHz, seconds);
+        printf("  %llu intervals, up to %zu samples per frame, %zu dropped, %llu lost\n",
+            static_cast<unsigned long long>(poll.count()), maxPerFrame, sampler.droppedCount(0),
+            static_cast<unsigned long long>(timing->lostSampleCount()));
+
+        char summary[512];
+        timing->formatSummary(summary, sizeof(summary));
+        printf("  %s\n", summary);
+        printf("  rest noise samples L %llu (set sd 0.0100)\n", static_cast<unsigned long long>(timing->leftNoise.n));
+        printf("  pads the source doesn't report fall back to GLFW: %s\n", sampledOnlyPad0 ? "yes" : "NO");
+        check(sampledOnlyPad0, "unreported pads not handed back to GLFW polling");
+    }
+
+    // Player-like raw input: WASD held for a while, mouse drifting, clicks, one pad's sticks
+    struct SyntheticPlayer {
+        Pcg32 rng{ 0x77u };
+        double mouseX = 960.0, mouseY = 540.0;
+        int heldKey = -1;
+
+        void step(RawInputData& raw, int tick) {
+            const int keys[] = { GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_S, GLFW_KEY_D };
+            if (rng.nextU32() % 40 == 0) {
+                if (heldKey >= 0) raw.keyDown[heldKey] = false;
+                heldKey = (rng.nextU32() & 1) ? keys[rng.nextU32() & 3] : -1;
+                if (heldKey >= 0) raw.keyDown[heldKey] = true;
+            }
+            if (rng.nextU32() % 30 == 0)
+                raw.mouseDown[GLFW_MOUSE_BUTTON_1] = !raw.mouseDown[GLFW_MOUSE_BUTTON_1];
+
+            mouseX = glm::clamp(mouseX + rng.uniform(-6.0f, 6.0f), 0.0, 1920.0);
+            mouseY = glm::clamp(mouseY + rng.uniform(-6.0f, 6.0f), 0.0, 1080.0);
+            raw.mouseX = mouseX;
+            raw.mouseY = mouseY;
+
+            float phase = tick * 0.05f;
+            raw.gamepadAxes[0][GLFW_GAMEPAD_AXIS_LEFT_X] = (tick / 300) % 2 ? std::cos(phase) : 0.0f;
+            raw.gamepadAxes[0][GLFW_GAMEPAD_AXIS_LEFT_Y] = (tick / 300) % 2 ? std::sin(phase) : 0.0f;
+        }
+    };
+
+    inline uint64_t hashRaw(const RawInputData& raw) {
+        uint64_t h = 1469598103934665603ull;
+        auto mix = [&](const void* data, size_t size) {
+            const uint8_t* p = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; i++) h = (h ^ p[i]) * 1099511628211ull;
+        };
+        mix(raw.keyDown, sizeof(raw.keyDown));
+        mix(raw.mouseDown, sizeof(raw.mouseDown));
+        mix(&raw.mouseX, sizeof(raw.mouseX));
+        mix(&raw.mouseY, sizeof(raw.mouseY));
+        mix(raw.gamepadAxes, sizeof(raw.gamepadAxes));
+        mix(raw.gamepadButtons, sizeof(raw.gamepadButtons));
+        return h;
+    }
+
+    // One player ship steered by recorded or live input against a stationary target
+    inline uint64_t runInputDrivenFight(InputRecorder* recorder, InputReplayer* replayer, int ticks) {
+        initHeadlessServices(0xf16u);
+        InputSystem& input = *Services::inputSystem;
+
+        PlayerInput playerInput;
+        bindKeyboardAndMouse({ DeviceType::Keyboard, 0 }, { DeviceType::Mouse, 0 }, playerInput, 1080);
+        input.players.push_back(playerInput);
+
+        SystemScheduler systems;
+        addGameplayPasses(systems);
+
+        auto makeShip = [](vec2 at, int layer) {
+            auto ship = std::make_shared<Ship>();
+            ship->setScreenBounds(vec2(0.0f), vec2(1920.0f, 1080.0f));
+            ship->respawn(at);
+            ship->scale = vec2(50.0f);
+            auto collider = std::make_shared<Collider2D>(Collider2D::ShapeType::Circle);
+            collider->mask = CollisionLayer::All;
+            collider->layer = layer;
+            collider->scale = vec2(0.8f);
+            Services::collisions->addCollider(collider);
+            ship->attachCollider(collider);
+            return ship;
+        };
+
+        auto player = makeShip(vec2(500.0f, 500.0f), CollisionLayer::Player);
+        player->setTeam(0);
+        auto hardpoint = std::make_shared<Hardpoint>();
+        hardpoint->position = vec2(0, -0.9f);
+        hardpoint->attachWeapon(std::make_shared<LaserGun>());
+        player->addHardpoint(hardpoint, 0);
+
+        auto target = makeShip(vec2(1400.0f, 600.0f), CollisionLayer::Enemy);
+        target->setTeam(1);
+
+        PlayerController controller(&input.players[0]);
+        controller.possess(player.get());
+
+        SyntheticPlayer synthetic;
+        uint64_t h = 1469598103934665603ull;
+        for (int t = 0; t < ticks; t++) {
+            double dt = 1.0 / 75.0 + 0.002 * std::sin(t * 0.1);    // uneven frame times, like a real session
+
+            if (replayer) {
+                if (!replayer->next(input.raw, dt)) break;
+            }
+            else {
+                synthetic.step(input.raw, t);
+                dt = recorder->record(input.raw, dt);
+            }
+            input.updatePlayers();
+
+            controller.update(dt);
+            player->update(dt);
+            target->update(dt);
+            systems.update(*Services::registry, dt);
+            Services::projectiles->update(dt);
+            Services::collisions->update();
+            Services::damage->flush(*Services::registry);
+            Services::eventHandler->processEvents();
+            Services::eventBus->clear();
+
+            vec2 p = player->getWorldPosition();
+            float state[4] = { p.x, p.y, target->getComponent<HealthComponent>()->health, float(Services::projectiles->projectiles.size()) };
+            const uint8_t* bytes = reinterpret_cast<const uint8_t*>(state);
+            for (size_t i = 0; i < sizeof(state); i++) h = (h ^ bytes[i]) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    // Size of an hour of input, exact round trip through the mapped file, and a fight replayed from it
+    inline void runInputRecording(const char* path) {
+        const int hourTicks = 75 * 3600;
+
+        InputRecorder recorder;
+        const uint32_t arenaWidth = static_cast<uint32_t>(World::ArenaWidth), arenaHeight = static_cast<uint32_t>(World::ArenaHeight);
+        if (!recorder.open(path, 0x5eed, arenaWidth, arenaHeight)) {
+            printf("input recording: couldn't write %s\n", path);
+            return;
+        }
+
+        std::vector<uint64_t> recorded;
+        recorded.reserve(hourTicks);
+        RawInputData raw;
+        SyntheticPlayer synthetic;
+        auto start = Clock::now();
+        for (int t = 0; t < hourTicks; t++) {
+            synthetic.step(raw, t);
+            recorder.record(raw, 1.0 / 75.0);
+            recorded.push_back(hashRaw(raw));
+        }
+        double recordSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        recorder.close();
+        uint64_t bytes = recorder.bytesWritten();
+
+        InputReplayer replayer;
+        size_t mismatches = 0, replayed = 0;
+        start = Clock::now();
+        if (replayer.open(path)) {
+            check(replayer.arenaWidth() == arenaWidth && replayer.arenaHeight() == arenaHeight, "recording lost its arena size");
+            double dt;
+            while (replayer.next(raw, dt)) {
+                if (replayed >= recorded.size() || hashRaw(raw) != recorded[replayed]) mismatches++;
+                replayed++;
+            }
+        }
+        double replaySeconds = std::chrono::duration<double>(Clock::now() - start).count();
+        replayer.close();
+
+        printf("input recording: 1 h at 75 Hz (%d ticks)\n", hourTicks);
+        printf("  %.2f MB, %.1f bytes/tick, record %.0f ns/tick, replay %.0f ns/tick\n",
+            bytes / (1024.0 * 1024.0), double(bytes) / hourTicks, recordSeconds * 1e9 / hourTicks, replaySeconds * 1e9 / hourTicks);
+        printf("  replayed %zu ticks, %zu mismatches\n", replayed, mismatches);
+        check(mismatches == 0 && replayed == static_cast<size_t>(hourTicks), "replayed input differs from the recording");
+
+        // Same fight twice: live synthetic input while recording, then from the file
+        const int fightTicks = 75 * 60;
+        InputRecorder fightRecorder;
+        fightRecorder.open(path, 0xf16u, arenaWidth, arenaHeight);
+        uint64_t live = runInputDrivenFight(&fightRecorder, nullptr, fightTicks);
+        fightRecorder.close();
+
+        InputReplayer fightReplayer;
+        fightReplayer.open(path);
+        uint64_t replay = runInputDrivenFight(nullptr, &fightReplayer, fightTicks);
+        printf("  recorded fight replay: %s\n", live == replay ? "identical" : "DIVERGED");
+        check(live == replay, "recorded fight replay diverged");
+
+        fightReplayer.close();
+        std::remove(path);
+    }
+
+    // Save/restore cost on a busy combat scene, byte-exact round trip and a rollback re-simulation
+    inline void runSnapshot(int shipsPerSide, int iterations) {
+        const double dt = 1.0 / 75.0;
+        const int rollbackTicks = 60;
+
+        World& headless = initHeadlessServices(0x5a9u);
+        headless.projectiles->prewarm(512 * shipsPerSide);
+        CombatScene scene = buildCombatScene(headless, shipsPerSide);
+
+        WorldSnapshot world(headless);
+        for (auto& s : scene.left) world.track(s.get());
+        for (auto& s : scene.right) world.track(s.get());
+
+        // Long enough for the miniguns to spool up and fill the pool
+        for (int i = 0; i < 300; i++)
+            stepCombat(scene, dt);
+
+        std::vector<uint8_t> snapshot, again;
+        world.save(snapshot);
+        snapshot.reserve(snapshot.size() * 2);
+        again.reserve(snapshot.capacity());
+
+        auto start = Clock::now();
+        for (int i = 0; i < iterations; i++)
+            world.save(snapshot);
+        double saveSeconds = std::chrono::duration<double>(Clock::now() - start).count() / iterations;
+
+        bool restored = true;
+        start = Clock::now();
+        for (int i = 0; i < iterations; i++)
+            restored &= world.restore(snapshot);
+        double restoreSeconds = std::chrono::duration<double>(Clock::now() - start).count() / iterations;
+
+        world.save(again);
+        bool roundTrip = restored && again == snapshot;
+
+        // Same ticks twice from the same snapshot must land on the same world
+        size_t entities = scene.left.size() + scene.right.size() + headless.projectiles->projectiles.size();
+        for (int i = 0; i < rollbackTicks; i++) stepCombat(scene, dt);
+        uint64_t first = world.checksum();
+        size_t liveAfter = headless.projectiles->projectiles.size();
+
+        bool rolledBack = world.restore(snapshot);
+        for (int i = 0; i < rollbackTicks; i++) stepCombat(scene, dt);
+        uint64_t second = world.checksum();
+
+        printf("snapshot: %zu entities (%zu ships + projectiles), %zu bytes\n",
+            entities, scene.left.size() + scene.right.size(), snapshot.size());
+        printf("  save %.3f ms, restore %.3f ms\n", saveSeconds * 1e3, restoreSeconds * 1e3);
+        printf("  save -> restore -> save: %s\n", roundTrip ? "identical" : "DIFFERENT");
+        printf("  rollback %d ticks (%zu live after): %s\n", rollbackTicks, liveAfter,
+            rolledBack && first == second ? "identical" : "DIVERGED");
+        check(roundTrip, "snapshot save -> restore -> save differs");
+        check(rolledBack && first == second, "re-simulating from a snapshot diverged");
+    }
+
+    // One side of a networked duel in a world of its own
+    struct VersusPeer {
+        World world;
+        SystemScheduler systems;
+        std::shared_ptr<Ship> ships[2];
+        PlayerController controllers[2] = { PlayerController(nullptr), PlayerController(nullptr) };
+        WorldSnapshot snapshot;
+
+        UdpSocket socket;
+        LinkConditioner link;
+        std::unique_ptr<RollbackSession> session;
+
+        explicit VersusPeer(uint64_t seed) : world(seed), snapshot(world) {
+            World::Scope scope(world);
+            addGameplayPasses(systems);
+            world.projectiles->prewarm(1024);
+
+            for (int p = 0; p < 2; p++) {
+                auto ship = std::make_shared<Ship>();
+                ship->setScreenBounds(vec2(0.0f), vec2(World::ArenaWidth, World::ArenaHeight));
+                ship->respawn(p == 0 ? vec2(500.0f, 540.0f) : vec2(1400.0f, 540.0f));
+                ship->scale = vec2(50.0f);
+                auto collider = std::make_shared<Collider2D>(Collider2D::ShapeType::Circle);
+                collider->mask = CollisionLayer::All;
+                collider->layer = p == 0 ? CollisionLayer::Player : CollisionLayer::Enemy;
+                collider->scale = vec2(0.8f);
+                world.collisions->addCollider(collider);
+                ship->attachCollider(collider);
+                ship->setTeam(p);
+
+                auto hardpoint = std::make_shared<Hardpoint>();
+                hardpoint->position = vec2(0, -0.9f);
+                auto gun = std::make_shared<LaserGun>();
+                gun->team = p;
+                hardpoint->attachWeapon(gun);
+                ship->addHardpoint(hardpoint, 0);
+
+                ships[p] = ship;
+                controllers[p].possess(ship.get());
+                snapshot.track(ship.get());
+            }
+        }
+
+        void step(const PlayerCommand (&commands)[2], double dt) {
+            for (int p = 0; p < 2; p++) {
+                if (ships[p]->isDead()) ships[p]->respawnHealth();
+                controllers[p].apply(commands[p]);
+            }
+            for (auto& ship : ships) ship->update(dt);
+            systems.update(*world.registry, dt);
+            world.projectiles->update(dt);
+            world.collisions->update();
+            world.damage->flush(*world.registry);
+            world.eventBus->clear();
+        }
+    };
+
+    // Scripted player: a new move and fire decision every few ticks, aim sweeping every tick
+    inline PlayerCommand scriptedCommand(int player, int64_t tick) {
+        Pcg32 rng(static_cast<uint64_t>(tick / (9 + player * 4)), 11 + player);
+        float t = tick / 60.0f + player * 1.7f;
+
+        PlayerCommand c;
+        c.setMove(vec2(rng.uniform(-1.0f, 1.0f), rng.uniform(-1.0f, 1.0f)));
+        c.setAim(vec2(std::cos(t * 1.3f), std::sin(t * 0.9f)));
+        c.setButton(0, rng.nextFloat() < 0.7f);
+        return c;
+    }
+
+    // Two peers over loopback UDP with simulated latency and loss, checked against an offline run
+    inline void runRollback(double rttSeconds, double loss, int ticks) {
+        const uint64_t seed = 0x7e55u;
+        const double tickSeconds = 1.0 / 60.0;
+
+        // Peers that would simulate different arenas don't share a session
+        check(RollbackConfig::makeSessionId("bench", seed, 1920.0f, 1080.0f, tickSeconds) !=
+            RollbackConfig::makeSessionId("bench", seed, 2560.0f, 1440.0f, tickSeconds), "session id ignores the arena size");
+
+        VersusPeer peers[2] = { VersusPeer(seed), VersusPeer(seed) };
+        bool connected = true;
+        for (auto& peer : peers) connected &= peer.socket.open(0);
+        connected = connected &&
+            peers[0].socket.setPeer("127.0.0.1", peers[1].socket.localPort()) &&
+            peers[1].socket.setPeer("127.0.0.1", peers[0].socket.localPort());
+        if (!connected) {
+            printf("rollback: couldn't open loopback sockets\n");
+            return;
+        }
+
+        for (int p = 0; p < 2; p++) {
+            VersusPeer& peer = peers[p];
+            peer.link.latency = rttSeconds / 2.0;
+            peer.link.jitter = rttSeconds * 0.05;
+            peer.link.loss = loss;
+            peer.link.seed(p + 1);
+
+            RollbackConfig config;
+            config.localPlayer = p;
+            config.tickSeconds = tickSeconds;
+            config.sessionId = RollbackConfig::makeSessionId("bench", seed, World::ArenaWidth, World::ArenaHeight, tickSeconds);
+            peer.session = std::make_unique<RollbackSession>(peer.snapshot, peer.socket, peer.link, config,
+                [&peer, tickSeconds](const PlayerCommand (&commands)[2], bool) { peer.step(commands, tickSeconds); });
+        }
+
+        // Shared simulated clock, both peers tick in lockstep with the shim's delays
+        double now = 0.0;
+        double worstAdvance = 0.0, totalAdvance = 0.0;
+        uint64_t advances = 0;
+        int64_t offeredTick[2] = { -1, -1 };
+        int offeredAt[2] = {};
+        int worstLatency = 0;       // ticks from first offering a command to simulating it
+
+        for (int i = 0; i < ticks * 4; i++) {
+            if (peers[0].session->confirmedTick() >= ticks && peers[1].session->confirmedTick() >= ticks) break;
+            now += tickSeconds;
+
+            for (int p = 0; p < 2; p++) {
+                RollbackSession& session = *peers[p].session;
+                int64_t inputTick = session.localInputTick();
+                if (inputTick != offeredTick[p]) {
+                    offeredTick[p] = inputTick;
+                    offeredAt[p] = i;
+                }
+
+                auto start = Clock::now();
+                bool simulated = session.advance(scriptedCommand(p, inputTick), now);
+                double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                worstAdvance = std::max(worstAdvance, seconds);
+                totalAdvance += seconds;
+                advances++;
+
+                if (simulated) worstLatency = std::max(worstLatency, i - offeredAt[p]);
+            }
+        }
+
+        // Same commands without a network
+        VersusPeer offline(seed);
+        for (int64_t t = 0; t < ticks; t++) {
+            PlayerCommand commands[2] = { scriptedCommand(0, t), scriptedCommand(1, t) };
+            offline.step(commands, tickSeconds);
+        }
+        uint64_t expected = offline.snapshot.checksum();
+
+        uint64_t reached[2] = {};
+        bool match = true;
+        for (int p = 0; p < 2; p++)
+            match &= peers[p].session->checksumAt(ticks, reached[p]) && reached[p] == expected;
+
+        printf("rollback versus: %.0f ms RTT, %.0f%% loss, %d ticks at 60 Hz over loopback UDP\n", rttSeconds * 1e3, loss * 100.0, ticks);
+        for (int p = 0; p < 2; p++) {
+            const RollbackSession& s = *peers[p].session;
+            printf("  peer %d: %llu rollbacks, %.1f ticks avg, %lld max, %llu stalls, %llu/%llu packets lost, %llu checksums compared\n", p + 1,
+                static_cast<unsigned long long>(s.rollbackCount()),
+                s.rollbackCount() ? double(s.resimulatedTickCount()) / s.rollbackCount() : 0.0,
+                static_cast<long long>(s.maxRollbackDepth()),
+                static_cast<unsigned long long>(s.stallCount()),
+                static_cast<unsigned long long>(peers[p].link.dropped()), static_cast<unsigned long long>(peers[p].link.sent()),
+                static_cast<unsigned long long>(s.checksumsCompared()));
+        }
+        printf("  added local input latency: %d ticks worst, advance %.3f ms avg, %.3f ms worst\n",
+            worstLatency, totalAdvance * 1e3 / advances, worstAdvance * 1e3);
+        printf("  desync: %s, tick %d matches the offline run: %s\n",
+            peers[0].session->desyncTick() < 0 && peers[1].session->desyncTick() < 0 ? "none" : "DETECTED",
+            ticks, match ? "yes" : "NO");
+        check(peers[0].session->desyncTick() < 0 && peers[1].session->desyncTick() < 0, "rollback peers desynced");
+        check(match, "rollback peers don't match the offline run");
+    }
+
+    // A running fight streamed to headless spectators over loopback UDP. Every view a client
+    // decodes is checked against the one the server built for it, then the ships cease fire
+    // and once the shots have run out each client has to hold the world as it is. The right
+    // side is streamed as dynamic actors, one of them leaving and coming back every second.
+    inline void runSpectators(int clientCount, int shipsPerSide, int frames) {
+        const double dt = 1.0 / 60.0;
+        const double latency = 0.025, loss = 0.02;
+
+        CombatScene scene = buildCombatScene(*World::current(), shipsPerSide);
+        for (int i = 0; i < 300; i++) stepCombat(scene, dt);
+
+        SpectatorServer server(*scene.world);
+        if (!server.open(0)) {
+            printf("spectators: couldn't open a loopback socket\n");
+            return;
+        }
+        server.link.latency = latency;
+        server.link.jitter = latency * 0.2;
+        server.link.loss = loss;
+        for (auto& ship : scene.left) server.track(ship.get());
+        server.reserveDynamic(scene.right.size());
+        for (auto& ship : scene.right) server.addDynamic(ship.get());
+
+        std::vector<std::unique_ptr<SpectatorClient>> clients;
+        std::vector<NetAddress> addresses(clientCount);
+        for (int i = 0; i < clientCount; i++) {
+            auto client = std::make_unique<SpectatorClient>();
+            if (!client->connect("127.0.0.1", server.localPort()) ||
+                !NetAddress::resolve("127.0.0.1", client->localPort(), addresses[i])) {
+                printf("spectators: couldn't open a loopback socket\n");
+                return;
+            }
+            client->link.latency = latency;
+            client->link.loss = loss;
+            client->link.seed(10 + i);
+            clients.push_back(std::move(client));
+        }
+
+        std::vector<uint32_t> checkedSeq(clientCount, Spectator::NoSeq);
+        uint64_t viewsChecked = 0, viewsIdentical = 0;
+        auto checkViews = [&]() {
+            for (int i = 0; i < clientCount; i++) {
+                uint32_t seq = clients[i]->sequence();
+                int index = server.findClient(addresses[i]);
+                if (seq == Spectator::NoSeq || seq == checkedSeq[i] || index < 0) continue;
+                checkedSeq[i] = seq;
+
+                const auto* sent = server.sentView(index, seq);
+                const auto& held = clients[i]->entities();
+                bool same = sent != nullptr;
+                for (size_t id = 0; same && id < std::max(held.size(), sent->size()); id++)
+                    same = Spectator::stateAt(held, id).sameAs(Spectator::stateAt(*sent, id));
+                viewsChecked++;
+                viewsIdentical += same;
+            }
+        };
+
+        // The world as each recent packet saw it, to hold clients against
+        std::vector<std::vector<Spectator::EntityState>> truth(Spectator::Window);
+        double now = 0.0, publishSeconds = 0.0;
+        uint64_t publishes = 0, entitySum = 0;
+        auto publish = [&]() {
+            auto start = Clock::now();
+            server.publish(now);
+            publishSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+            publishes++;
+            for (auto& e : server.world()) entitySum += e.present;
+            truth[(server.sequence() - 1) % Spectator::Window] = server.world();
+        };
+
+        auto clientStats = [&]() {
+            std::vector<SpectatorServer::ClientStats> stats;
+            for (auto& address : addresses) {
+                int index = server.findClient(address);
+                stats.push_back(index >= 0 ? server.clientStats(index) : SpectatorServer::ClientStats{});
+            }
+            return stats;
+        };
+
+        // 60 Hz fight, 30 Hz stream; measured after the first two seconds, when joining
+        // clients receive the whole world at once
+        const int joinFrames = 120;
+        std::vector<SpectatorServer::ClientStats> joined;
+        uint64_t joinedPublishes = 0;
+        for (int f = 0; f < joinFrames + frames; f++) {
+            if (f == joinFrames) {
+                joined = clientStats();
+                joinedPublishes = publishes;
+            }
+            now += dt;
+            stepCombat(scene, dt);
+            Ship* leaving = scene.right[(f / 60) % scene.right.size()].get();
+            if (f % 60 == 30) server.removeDynamic(leaving);
+            if (f % 60 == 40) server.addDynamic(leaving);
+            if (f % 2 == 0) publish();
+            for (auto& client : clients) client->update(now);
+            checkViews();
+        }
+        std::vector<SpectatorServer::ClientStats> streamed = clientStats();
+        double streamSeconds = frames * dt;
+        uint64_t streamedPublishes = publishes - joinedPublishes;
+        double entitiesStreamed = double(entitySum) / publishes;
+
+        // Cease fire on a clean link until every shot has expired
+        server.link.loss = 0.0;
+        for (auto& client : clients) client->link.loss = 0.0;
+        for (int f = 0; f < 480; f++) {
+            now += dt;
+            stepCombat(scene, dt, false);
+            if (f % 2 == 0) publish();
+            for (auto& client : clients) client->update(now);
+            checkViews();
+        }
+
+        int converged = 0;
+        for (auto& client : clients) {
+            uint32_t seq = client->sequence();
+            if (seq == Spectator::NoSeq || server.sequence() - seq >= Spectator::Window) continue;
+            const auto& held = client->entities();
+            const auto& world = truth[seq % Spectator::Window];
+            bool same = true;
+            for (size_t id = 0; same && id < std::max(held.size(), world.size()); id++) {
+                const auto& t = Spectator::stateAt(world, id);
+                const auto& h = Spectator::stateAt(held, id);
+                same = t.present == h.present && (!t.present ||
+                    (std::abs(h.predictedX(seq) - t.x) <= server.settings.positionTolerance &&
+                     std::abs(h.predictedY(seq) - t.y) <= server.settings.positionTolerance &&
+                     std::abs(Spectator::angleDelta(h.rotation, t.rotation)) <= server.settings.angleTolerance &&
+                     h.team == t.team && h.health == t.health));
+            }
+            converged += same;
+        }
+
+        SpectatorServer::ClientStats total;
+        for (size_t i = 0; i < streamed.size(); i++) {
+            const auto& s = streamed[i];
+            const auto& j = joined[i];
+            total.packets += s.packets - j.packets;
+            total.bytes += s.bytes - j.bytes;
+            total.records += s.records - j.records;
+            total.deferred += s.deferred - j.deferred;
+            total.positionError += s.positionError - j.positionError;
+            total.compared += s.compared - j.compared;
+            total.missing += s.missing - j.missing;
+            total.stale += s.stale - j.stale;
+        }
+        double perClient = 1.0 / std::max(1, clientCount);
+        uint64_t pictured = total.compared + total.missing + total.stale;
+
+        printf("spectators: %d clients at %.0f Hz, %.0f KB/s cap, %.0f ms RTT, %.0f%% loss, %d frames\n",
+            clientCount, server.settings.sendRate, server.settings.bytesPerSecond / 1024.0, latency * 2e3, loss * 100.0, frames);
+        printf("  world %.0f entities avg (%zu ships), publish %.3f ms for all clients\n",
+            entitiesStreamed, scene.left.size() + scene.right.size(), publishSeconds * 1e3 / publishes);
+        printf("  per client %.1f KB/s, %.0f bytes/packet, %.1f records/packet, %.1f deferred/packet\n",
+            total.bytes * perClient / streamSeconds / 1024.0,
+            double(total.bytes) / std::max<uint64_t>(1, total.packets),
+            double(total.records) / std::max<uint64_t>(1, total.packets),
+            double(total.deferred) / std::max<uint64_t>(1, total.packets));
+        printf("  client picture: %.2f px avg error, %.2f%% missing, %.2f%% stale (%llu publishes)\n",
+            total.positionError / std::max<uint64_t>(1, total.compared),
+            100.0 * total.missing / std::max<uint64_t>(1, pictured), 100.0 * total.stale / std::max<uint64_t>(1, pictured),
+            static_cast<unsigned long long>(streamedPublishes));
+        printf("  decoded views identical to the server's: %llu/%llu, after the cease-fire %d/%d clients hold the world\n",
+            static_cast<unsigned long long>(viewsIdentical), static_cast<unsigned long long>(viewsChecked), converged, clientCount);
+        check(viewsIdentical == viewsChecked, "spectator views differ from the server's");
+        check(converged == clientCount, "spectators don't hold the world after the cease-fire");
+    }
+
+    // One headless match start to finish in its own world, returns the final checksum
+    inline uint64_t playMatch(uint64_t seed, int shipsPerSide, int frames) {
+        const double dt = 1.0 / 75.0;
+
+        World world(seed);
+        World::Scope scope(world);
+        world.projectiles->prewarm(256 * shipsPerSide);
+
+        CombatScene scene = buildCombatScene(world, shipsPerSide);
+        WorldSnapshot snapshot(world);
+        for (auto& s : scene.left) snapshot.track(s.get());
+        for (auto& s : scene.right) snapshot.track(s.get());
+
+        for (int i = 0; i < frames; i++)
+            stepCombat(scene, dt);
+        return snapshot.checksum() ^ scene.deaths;
+    }
+
+    // The same matches one after another and then all at once, one thread each.
+    // Worlds share nothing, so every match has to end the same both ways.
+    inline void runParallelWorlds(int matches, int shipsPerSide, int frames) {
+        std::vector<uint64_t> sequential(matches), parallel(matches);
+
+        auto start = Clock::now();
+        for (int i = 0; i < matches; i++)
+            sequential[i] = playMatch(0x3a7c4u + i, shipsPerSide, frames);
+        double sequentialSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        start = Clock::now();
+        std::vector<std::thread> threads;
+        for (int i = 0; i < matches; i++)
+            threads.emplace_back([&, i] { parallel[i] = playMatch(0x3a7c4u + i, shipsPerSide, frames); });
+        for (auto& t : threads) t.join();
+        double parallelSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        int identical = 0, distinct = 0;
+        for (int i = 0; i < matches; i++) {
+            identical += sequential[i] == parallel[i];
+            distinct += i == 0 || sequential[i] != sequential[i - 1];
+        }
+
+        printf("parallel worlds: %d matches, %d ships per side, %d frames each\n", matches, shipsPerSide, frames);
+        printf("  sequential %.1f ms, parallel %.1f ms, %.2fx on %u hardware threads\n",
+            sequentialSeconds * 1e3, parallelSeconds * 1e3, sequentialSeconds / parallelSeconds, std::thread::hardware_concurrency());
+        printf("  same result on their own thread: %d/%d, seeds telling matches apart: %d/%d\n", identical, matches, distinct, matches);
+        check(identical == matches, "a match ended differently on its own thread");
+        check(distinct == matches, "different seeds gave the same match");
+    }
+
+    // Stands in for a ship under AI control, only its position matters
+    struct MarkerPawn : public Actor2D, public IControllable {
+        void setMoveDirection(const glm::vec2) override {}
+        void setAimDirection(const glm::vec2) override {}
+        void useAbility(int, bool) override {}
+        void dash(bool) override {}
+    };
+
+    // Target assignment for a crowd of AIs: the per-AI scan over every opponent
+    // against the Director's grid, plain nearest and with a cap per opponent
+    inline void runDirector(int aiCount, int opponentCount, int iterations) {
+        Pcg32 rng(0xd1ec7u);
+        const vec2 area(8000.0f, 6000.0f);
+
+        std::vector<std::unique_ptr<MarkerPawn>> pawns;
+        std::vector<std::unique_ptr<SimpleShootingAi>> ais;
+        std::vector<std::shared_ptr<PhysicalActor2D>> opponents;
+        Director director;
+
+        for (int i = 0; i < opponentCount; i++) {
+            auto opponent = std::make_shared<PhysicalActor2D>();
+            opponent->position = vec2(rng.uniform(0.0f, area.x), rng.uniform(0.0f, area.y));
+            opponent->physics->velocity = vec2(rng.uniform(-100.0f, 100.0f), rng.uniform(-100.0f, 100.0f));
+            director.addOpponent(opponent.get());
+            opponents.push_back(opponent);
+        }
+        for (int i = 0; i < aiCount; i++) {
+            auto pawn = std::make_unique<MarkerPawn>();
+            pawn->position = vec2(rng.uniform(0.0f, area.x), rng.uniform(0.0f, area.y));
+            auto ai = std::make_unique<SimpleShootingAi>();
+            ai->possess(pawn.get());
+            director.addAI(ai.get());
+            pawns.push_back(std::move(pawn));
+            ais.push_back(std::move(ai));
+        }
+
+        // What Director::update used to do for every AI
+        std::vector<Actor2D*> scanned(aiCount);
+        auto start = Clock::now();
+        for (int it = 0; it < iterations; it++) {
+            for (int a = 0; a < aiCount; a++) {
+                Actor2D* closest = nullptr;
+                float minDistSqr = std::numeric_limits<float>::max();
+                for (Actor2D* opp : director.opponents) {
+                    glm::vec2 diff = opp->getWorldPosition() - ais[a]->pawnPosition();
+                    float distSqr = glm::dot(diff, diff);
+                    if (distSqr < minDistSqr) {
+                        minDistSqr = distSqr;
+                        closest = opp;
+                    }
+                }
+                glm::vec2 velocity(0.0f);
+                if (auto phys = dynamic_cast<PhysicalActor2D*>(closest)) velocity = phys->getVelocity();
+                ais[a]->setTarget(closest->getWorldPosition(), velocity);
+                scanned[a] = closest;
+            }
+        }
+        double scanSeconds = std::chrono::duration<double>(Clock::now() - start).count() / iterations;
+
+        director.settings.maxAttackersPerOpponent = 0;
+        start = Clock::now();
+        for (int it = 0; it < iterations; it++) director.assignTargets();
+        double nearestSeconds = std::chrono::duration<double>(Clock::now() - start).count() / iterations;
+
+        int agree = 0;
+        for (int a = 0; a < aiCount; a++) {
+            int t = director.targetOf(a);
+            float dGrid = glm::length(opponents[t]->getWorldPosition() - pawns[a]->getWorldPosition());
+            float dScan = glm::length(scanned[a]->getWorldPosition() - pawns[a]->getWorldPosition());
+            agree += dGrid == dScan;
+        }
+        int pileUp = 0;
+        for (int o = 0; o < opponentCount; o++) pileUp = std::max(pileUp, director.attackersOf(o));
+
+        int cap = (aiCount + opponentCount - 1) / opponentCount * 3 / 2;
+        director.settings.maxAttackersPerOpponent = cap;
+        start = Clock::now();
+        for (int it = 0; it < iterations; it++) director.assignTargets();
+        double balancedSeconds = std::chrono::duration<double>(Clock::now() - start).count() / iterations;
+
+        int balancedMax = 0, overCap = 0;
+        for (int o = 0; o < opponentCount; o++) {
+            balancedMax = std::max(balancedMax, director.attackersOf(o));
+            overCap += director.attackersOf(o) > cap;
+        }
+
+        printf("director: %d AIs vs %d opponents\n", aiCount, opponentCount);
+        printf("  scan every opponent: %.3f ms, grid nearest: %.3f ms, same target for %d/%d AIs\n",
+            scanSeconds * 1e3, nearestSeconds * 1e3, agree, aiCount);
+        check(agree == aiCount, "grid nearest picked another target than the full scan");
+        printf("  nearest piles up to %d AIs on one opponent; capped at %d (%d nearest): %.3f ms, %d at most, %d over\n",
+            pileUp, cap, director.settings.candidates, balancedSeconds * 1e3, balancedMax, overCap);
+    }
+
+    // Director::update cost as the AI count grows: every AI thinking every tick, level of
+    // detail (on screen or near a target every tick, others every 8), and LOD with a budget
+    inline void runAiScheduling(int opponentCount, int frames) {
+        const double dt = 1.0 / 60.0;
+        const vec2 area(8000.0f, 6000.0f);
+
+        printf("ai scheduling: %d opponents, %d frames, 1920x1080 view in a %.0fx%.0f area\n", opponentCount, frames, area.x, area.y);
+        for (int aiCount : { 500, 2000, 5000 }) {
+            Pcg32 rng(0xa1u + aiCount);
+            std::vector<std::unique_ptr<MarkerPawn>> pawns;
+            std::vector<std::unique_ptr<SimpleShootingAi>> ais;
+            std::vector<std::shared_ptr<PhysicalActor2D>> opponents;
+            for (int i = 0; i < opponentCount; i++) {
+                auto opponent = std::make_shared<PhysicalActor2D>();
+                opponent->position = vec2(rng.uniform(0.0f, area.x), rng.uniform(0.0f, area.y));
+                opponent->physics->velocity = vec2(rng.uniform(-100.0f, 100.0f), rng.uniform(-100.0f, 100.0f));
+                opponents.push_back(opponent);
+            }
+            for (int i = 0; i < aiCount; i++) {
+                auto pawn = std::make_unique<MarkerPawn>();
+                pawn->position = vec2(rng.uniform(0.0f, area.x), rng.uniform(0.0f, area.y));
+                auto ai = std::make_unique<SimpleShootingAi>();
+                ai->possess(pawn.get());
+                pawns.push_back(std::move(pawn));
+                ais.push_back(std::move(ai));
+            }
+
+            struct Mode { const char* name; int interval; float nearRadius; double budget; };
+            const Mode modes[] = {
+                { "every tick", 1, 0.0f, 0.0 },
+                { "lod", 8, 600.0f, 0.0 },
+                { "lod+budget", 8, 600.0f, 0.25e-3 },
+            };
+            printf("  %d AIs:\n", aiCount);
+            for (const Mode& mode : modes) {
+                Director director;
+                director.settings.farInterval = mode.interval;
+                director.settings.nearRadius = mode.nearRadius;
+                director.settings.thinkBudgetSeconds = mode.budget;
+                director.setView(area * 0.5f - vec2(960.0f, 540.0f), area * 0.5f + vec2(960.0f, 540.0f));
+                for (auto& o : opponents) director.addOpponent(o.get());
+                for (auto& ai : ais) director.addAI(ai.get());
+
+                double total = 0.0, worst = 0.0;
+                uint64_t thinks = 0;
+                int64_t oldest = 0;
+                for (int f = 0; f < frames; f++) {
+                    auto start = Clock::now();
+                    director.update(dt);
+                    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                    total += seconds;
+                    worst = std::max(worst, seconds);
+                    thinks += director.thinkStats().thinks;
+                    oldest = std::max(oldest, director.thinkStats().oldestThink);
+                }
+                printf("    %-11s %.3f ms avg, %.3f ms worst, %.0f thinks/tick, %llu deferred, stalest %lld ticks\n",
+                    mode.name, total * 1e3 / frames, worst * 1e3, double(thinks) / frames,
+                    static_cast<unsigned long long>(director.thinkStats().totalDeferred), static_cast<long long>(oldest));
+            }
+        }
+    }
+
+    // Remembers what it was last told, to compare controllers by
+    struct RecordingPawn : public Actor2D, public IControllable {
+        glm::vec2 move = glm::vec2(0.0f), aim = glm::vec2(0.0f);
+        bool fire = false;
+        void setMoveDirection(const glm::vec2 dir) override { move = dir; }
+        void setAimDirection(const glm::vec2 dir) override { aim = dir; }
+        void useAbility(int, bool pressed) override { fire = pressed; }
+        void dash(bool) override {}
+    };
+
+    // SwarmController against one SimpleShootingAi per pawn: the same decisions for random
+    // placements and right on every distance threshold, then the same ship inputs for a
+    // swarm of ships, and what each costs per tick
+    inline void runSwarm(int shipCount, int frames) {
+        const double dt = 1.0 / 60.0;
+        Pcg32 rng(0x5a4du);
+
+        int cases = 0, same = 0;
+        {
+            std::vector<std::unique_ptr<RecordingPawn>> single, batched;
+            std::vector<SimpleShootingAi> ais(4096);
+            SwarmController swarm;
+
+            // A third of the pawns close in along a field, with a wall across it to go around
+            FlowField field(vec2(-5000.0f), vec2(5000.0f), 128.0f, 1);
+            for (int x = 10; x < 70; x++) field.setCost(x, 40, FlowField::Blocked);
+            field.rebuild({ vec2(0.0f, -2500.0f) });
+            for (size_t i = 0; i < ais.size(); i++) {
+                float preferred = rng.uniform(100.0f, 900.0f);
+                vec2 at(rng.uniform(-2000.0f, 2000.0f), rng.uniform(-2000.0f, 2000.0f));
+                vec2 target = at + vec2(rng.uniform(-3000.0f, 3000.0f), rng.uniform(-3000.0f, 3000.0f));
+
+                // Every threshold think() compares against, and a target right on the pawn
+                const float edges[] = { preferred + 20.0f, preferred - 20.0f, preferred * 0.7f, preferred * 3.0f, 0.0f, 0.0005f };
+                if (i % 4 == 0) {
+                    float angle = rng.uniform(0.0f, 6.2831853f);
+                    target = at + edges[(i / 4) % 6] * vec2(std::cos(angle), std::sin(angle));
+                }
+
+                single.push_back(std::make_unique<RecordingPawn>());
+                batched.push_back(std::make_unique<RecordingPawn>());
+                single.back()->position = at;
+                batched.back()->position = at;
+
+                ais[i].preferredDistance = preferred;
+                ais[i].maxMoveSpeed = i % 3 == 0 ? 0.5f : 1.0f;
+                ais[i].possess(single.back().get());
+                const FlowField* flow = i % 3 == 1 ? &field : nullptr;
+                ais[i].setTarget(target, vec2(0.0f), flow);
+                ais[i].update(dt);
+
+                size_t slot = swarm.add(batched.back().get(), preferred, ais[i].maxMoveSpeed);
+                swarm.setTarget(slot, target, flow);
+            }
+            swarm.update();
+
+            for (size_t i = 0; i < ais.size(); i++) {
+                cases++;
+                same += single[i]->move == batched[i]->move && single[i]->aim == batched[i]->aim && single[i]->fire == batched[i]->fire;
+            }
+        }
+
+        World world(0x5a4du);
+        World::Scope scope(world);
+        std::vector<std::shared_ptr<Ship>> targets, single, batched;
+        std::vector<SimpleShootingAi> ais(shipCount);
+        SwarmController swarm;
+        for (int i = 0; i < 8; i++)
+            targets.push_back(ShipFactory::spawnEnemy(world, vec2(rng.uniform(0.0f, 8000.0f), rng.uniform(0.0f, 6000.0f))));
+        for (int i = 0; i < shipCount; i++) {
+            vec2 at(rng.uniform(0.0f, 8000.0f), rng.uniform(0.0f, 6000.0f));
+            single.push_back(ShipFactory::spawnEnemy(world, at));
+            batched.push_back(ShipFactory::spawnEnemy(world, at));
+            ais[i].possess(single.back().get());
+            swarm.add(batched.back().get());
+        }
+
+        // Targets drift so the fire decision flips now and then
+        double singleSeconds = 0.0, swarmSeconds = 0.0;
+        for (int f = 0; f < frames; f++) {
+            for (auto& t : targets) t->position += vec2(std::cos(f * 0.01f), std::sin(f * 0.013f)) * 40.0f;
+
+            auto start = Clock::now();
+            for (int i = 0; i < shipCount; i++) {
+                Ship& target = *targets[i % targets.size()];
+                ais[i].setTarget(target.getWorldPosition(), target.getVelocity());
+                ais[i].update(dt);
+            }
+            singleSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+
+            start = Clock::now();
+            for (int i = 0; i < shipCount; i++)
+                swarm.setTarget(i, targets[i % targets.size()]->getWorldPosition());
+            swarm.update();
+            swarmSeconds += std::chrono::duration<double>(Clock::now() - start).count();
+        }
+
+        int sameShips = 0;
+        for (int i = 0; i < shipCount; i++) {
+            auto singleGun = std::dynamic_pointer_cast<EnemyGun>(single[i]->hardpoints[0]->weapon);
+            auto batchedGun = std::dynamic_pointer_cast<EnemyGun>(batched[i]->hardpoints[0]->weapon);
+            sameShips += single[i]->thrustDir == batched[i]->thrustDir && single[i]->targetRot == batched[i]->targetRot &&
+                singleGun->isFiring() == batchedGun->isFiring();
+        }
+
+        printf("swarm controller: %d ships, %d frames\n", shipCount, frames);
+        printf("  same decisions as SimpleShootingAi for %d/%d pawns, same ship inputs for %d/%d ships\n", same, cases, sameShips, shipCount);
+        check(same == cases, "SwarmController decided differently from SimpleShootingAi");
+        check(sameShips == shipCount, "SwarmController gave ships different inputs than SimpleShootingAi");
+        printf("  one AI per ship %.3f ms/tick, swarm %.3f ms/tick, %.2fx\n",
+            singleSeconds * 1e3 / frames, swarmSeconds * 1e3 / frames, singleSeconds / swarmSeconds);
+    }
+
+    // Reference for the flow field: plain Dijkstra over the same 4-connected cells
+    inline std::vector<uint32_t> dijkstraField(const FlowField& field, const std::vector<uint8_t>& costs, const std::vector<vec2>& targets) {
+        int w = field.columns(), h = field.rows();
+        std::vector<uint32_t> dist(size_t(w) * h, FlowField::Unreachable);
+        using Entry = std::pair<uint32_t, int>;
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> open;
+        for (const vec2& t : targets) {
+            glm::ivec2 c = field.cellOf(t);
+            int i = c.y * w + c.x;
+            if (costs[i] == FlowField::Blocked) continue;
+            dist[i] = 0;
+            open.push({ 0, i });
+        }
+        while (!open.empty()) {
+            auto [d, i] = open.top();
+            open.pop();
+            if (d != dist[i]) continue;
+            int x = i % w, y = i / w;
+            const int nx[4] = { x - 1, x + 1, x, x }, ny[4] = { y, y, y - 1, y + 1 };
+            for (int k = 0; k < 4; k++) {
+                if (nx[k] < 0 || ny[k] < 0 || nx[k] >= w || ny[k] >= h) continue;
+                int n = ny[k] * w + nx[k];
+                if (costs[n] == FlowField::Blocked || d + costs[n] >= dist[n]) continue;
+                dist[n] = d + costs[n];
+                open.push({ dist[n], n });
+            }
+        }
+        return dist;
+    }
+
+    // A wave of agents steering by flow field toward a few moving targets through a field
+    // of obstacles: build cost, field against Dijkstra and one thread against all, and the
+    // whole frame (rebuild when targets moved far enough, every agent sampling and moving)
+    inline void runFlowField(int agentCount, int frames) {
+        const double dt = 1.0 / 75.0;
+        const vec2 area(8000.0f, 6000.0f);
+        Pcg32 rng(0xf10du);
+
+        std::vector<vec2> obstacles;
+        std::vector<float> radii;
+        for (int i = 0; i < 60; i++) {
+            obstacles.push_back(vec2(rng.uniform(0.0f, area.x), rng.uniform(0.0f, area.y)));
+            radii.push_back(rng.uniform(100.0f, 350.0f));
+        }
+        auto makeField = [&](unsigned threads) {
+            auto field = std::make_unique<FlowField>(vec2(0.0f), area, 32.0f, threads);
+            // A slow band across the middle, cheaper to go around where possible
+            field->setCost(vec2(0.0f, 2900.0f), vec2(area.x, 3100.0f), 6);
+            for (size_t i = 0; i < obstacles.size(); i++) field->addObstacle(obstacles[i], radii[i]);
+            return field;
+        };
+
+        std::vector<vec2> targets;
+        for (int i = 0; i < 8; i++) targets.push_back(vec2(rng.uniform(500.0f, 7500.0f), rng.uniform(500.0f, 5500.0f)));
+
+        auto single = makeField(1);
+        auto field = makeField(0);
+        auto four = makeField(4);
+        single->rebuild(targets);
+        field->rebuild(targets);
+        four->rebuild(targets);
+
+        std::vector<uint8_t> costs(size_t(field->columns()) * field->rows());
+        for (int y = 0; y < field->rows(); y++)
+            for (int x = 0; x < field->columns(); x++) {
+                const vec2 c = field->centerOf(x, y);
+                costs[size_t(y) * field->columns() + x] = 1;
+                for (size_t i = 0; i < obstacles.size(); i++) {
+                    vec2 d = c - obstacles[i];
+                    if (glm::dot(d, d) <= radii[i] * radii[i]) costs[size_t(y) * field->columns() + x] = FlowField::Blocked;
+                }
+                if (costs[size_t(y) * field->columns() + x] != FlowField::Blocked && c.y >= 2900.0f && c.y <= 3100.0f)
+                    costs[size_t(y) * field->columns() + x] = 6;
+            }
+        std::vector<uint32_t> reference = dijkstraField(*field, costs, targets);
+        size_t cells = reference.size(), matchDijkstra = 0, matchSingle = 0;
+        for (size_t i = 0; i < cells; i++) {
+            matchDijkstra += field->integrationField()[i] == reference[i];
+            matchSingle += four->integrationField()[i] == single->integrationField()[i];
+        }
+
+        const int builds = 20;
+        double singleBuild = 0.0, build = 0.0;
+        for (int b = 0; b < builds; b++) {
+            single->rebuild(targets);
+            singleBuild += single->stats().seconds;
+            field->rebuild(targets);
+            build += field->stats().seconds;
+        }
+
+        // Agents swarm out from the edges
+        std::vector<vec2> agents(agentCount);
+        for (vec2& a : agents) {
+            do {
+                a = rng.uniform(0.0f, 1.0f) < 0.5f ? vec2(rng.uniform(0.0f, area.x), rng.uniform(0.0f, 1.0f) < 0.5f ? 10.0f : area.y - 10.0f)
+                    : vec2(rng.uniform(0.0f, 1.0f) < 0.5f ? 10.0f : area.x - 10.0f, rng.uniform(0.0f, area.y));
+            } while (field->costToTarget(a) == FlowField::Unreachable);
+        }
+
+        uint64_t rebuilds = field->stats().builds;
+        double total = 0.0, worst = 0.0;
+        for (int f = 0; f < frames; f++) {
+            for (size_t i = 0; i < targets.size(); i++)
+                targets[i] += vec2(std::cos(f * 0.02f + i), std::sin(f * 0.02f + i)) * 4.0f;
+
+            auto start = Clock::now();
+            field->rebuildIfNeeded(targets);
+            for (vec2& a : agents)
+                a += field->direction(a) * 300.0f * static_cast<float>(dt);
+            double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+            total += seconds;
+            worst = std::max(worst, seconds);
+        }
+        rebuilds = field->stats().builds - rebuilds;
+
+        int blocked = 0;
+        for (const vec2& a : agents) blocked += field->costToTarget(a) == FlowField::Unreachable;
+
+        printf("flow field: %dx%d cells of 32, %zu obstacles, %zu targets, %d agents\n",
+            field->columns(), field->rows(), obstacles.size(), targets.size(), agentCount);
+        printf("  same costs as Dijkstra for %zu/%zu cells, 4 threads as 1 for %zu/%zu\n", matchDijkstra, cells, matchSingle, cells);
+        check(matchDijkstra == cells, "flow field costs differ from Dijkstra");
+        check(matchSingle == cells, "flow field built by 4 threads differs from 1");
+        printf("  build: 1 thread %.3f ms, %u threads %.3f ms, %d tile relaxes in %d rounds\n",
+            singleBuild * 1e3 / builds, field->threads(), build * 1e3 / builds, field->stats().tilesRelaxed, field->stats().rounds);
+        printf("  frame: %.3f ms avg, %.3f ms worst (%.1f ms at 75 fps), %llu rebuilds in %d frames, %d agents stuck\n",
+            total * 1e3 / frames, worst * 1e3, 1e3 / 75.0, static_cast<unsigned long long>(rebuilds), frames, blocked);
+        check(blocked == 0, "agents ended up where the flow field can't reach a target");
+    }
+
+    // Pairs of members closer than distance, from the flock's own grid
+    inline int countCrowded(const Flock& flock, const std::vector<vec2>& positions, float distance) {
+        int pairs = 0;
+        for (size_t i = 0; i < positions.size(); i++)
+            flock.neighbours().forEachWithin(positions[i], distance, [&](int j, float) { pairs += j > static_cast<int>(i); });
+        return pairs;
+    }
+
+    // Flocking at the same density for a growing crowd, spawned in tight clumps: cost per
+    // update and per member, and how many pairs still overlap after a few seconds
+    inline void runFlocking(int frames) {
+        const double dt = 1.0 / 60.0;
+        const float spacing = 120.0f;       // area per member
+        const float overlap = 40.0f;
+
+        printf("flocking: %d frames, one member per %.0fx%.0f\n", frames, spacing, spacing);
+        double firstPerMember = 0.0;
+        for (int count : { 1000, 5000, 10000 }) {
+            Pcg32 rng(0xf10cu + count);
+            float side = std::sqrt(float(count)) * spacing;
+
+            std::vector<std::shared_ptr<PhysicalActor2D>> ships;
+            Flock flock;
+            for (int i = 0; i < count; i += 10) {
+                vec2 clump(rng.uniform(0.0f, side), rng.uniform(0.0f, side));
+                vec2 heading(rng.uniform(-100.0f, 100.0f), rng.uniform(-100.0f, 100.0f));
+                for (int k = i; k < std::min(count, i + 10); k++) {
+                    auto ship = std::make_shared<PhysicalActor2D>();
+                    ship->physics->mass = 10.0f;
+                    ship->position = clump + vec2(rng.uniform(-20.0f, 20.0f), rng.uniform(-20.0f, 20.0f));
+                    ship->physics->velocity = heading;
+                    flock.add(ship.get());
+                    ships.push_back(ship);
+                }
+            }
+
+            std::vector<vec2> positions(count);
+            auto snapshot = [&] { for (int i = 0; i < count; i++) positions[i] = ships[i]->getWorldPosition(); };
+            snapshot();
+            flock.update(0.0);
+            int crowdedBefore = countCrowded(flock, positions, overlap);
+
+            double total = 0.0;
+            size_t neighbours = 0;
+            for (int f = 0; f < frames; f++) {
+                auto start = Clock::now();
+                flock.update(dt);
+                total += std::chrono::duration<double>(Clock::now() - start).count();
+                neighbours += flock.neighboursSeen();
+
+                for (auto& ship : ships) {
+                    ship->position += ship->physics->velocity * static_cast<float>(dt);
+                    ship->markDirty();
+                }
+            }
+
+            snapshot();
+            flock.update(0.0);
+            int crowdedAfter = countCrowded(flock, positions, overlap);
+
+            double perMember = total / frames / count;
+            if (firstPerMember == 0.0) firstPerMember = perMember;
+            printf("  %5d: %.3f ms/update, %.3f us/member (%.2fx the 1k cost), %.1f neighbours each, pairs under %.0f apart %d -> %d\n",
+                count, total * 1e3 / frames, perMember * 1e6, perMember / firstPerMember,
+                double(neighbours) / frames / count, overlap, crowdedBefore, crowdedAfter);
+        }
+    }
+
+    // A 500-ship wave from a cold world against one with pre-assembled enemies, then the
+    // same wave again once the first has died and gone back to the pool
+    inline void runWaveSpawner(int waveSize) {
+        WaveTable table;
+        table.kinds.push_back({ "grunt", "enemy_ship_basic", 50.0f, 100.0f, 25.0f, 1.0f });
+        table.kinds.push_back({ "heavy", "enemy_ship_basic", 70.0f, 300.0f, 40.0f, 1.5f });
+        for (int i = 0; i < 2; i++) {
+            Wave wave;
+            wave.interval = i == 0 ? 0.0 : 1.0;
+            wave.count = waveSize;
+            wave.mix = { { 0, 3 }, { 1, 1 } };
+            wave.pattern = SpawnPattern::Circle;
+            wave.size = 420.0f;
+            table.waves.push_back(wave);
+        }
+
+        printf("wave spawner: %d ships a wave, 3 grunts to 1 heavy\n", waveSize);
+        for (bool warm : { false, true }) {
+            World world(0x3a7eu);
+            World::Scope scope(world);
+            WaveSpawner spawner(world, table);
+
+            auto start = Clock::now();
+            if (warm) spawner.prewarm();
+            double prewarmSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+            int prewarmRespawns = 0;
+            world.eventBus->process<RespawnEvent>([&](const RespawnEvent&) { prewarmRespawns++; });
+            check(prewarmRespawns == 0, "prewarming the enemy pool emitted RespawnEvents");
+
+            size_t allocsBefore = AllocationCounter::count();
+            spawner.update(0.0);
+            size_t firstAllocs = AllocationCounter::count() - allocsBefore;
+            double firstSeconds = spawner.spawnStats().lastSpawnSeconds;
+            world.eventBus->clear();
+
+            int heavy = 0, ready = 0;
+            for (auto& ship : spawner.active()) {
+                heavy += ship->scale.x == 70.0f;
+                ready += ship->collider && ship->collider->enabled && !ship->hardpoints.empty() && !ship->isDead();
+            }
+            size_t created = world.enemyShips->totalCreated();
+
+            for (auto& ship : spawner.active()) ship->applyDamage(1e6f);
+            world.eventBus->clear();
+
+            allocsBefore = AllocationCounter::count();
+            spawner.update(1.0);
+            size_t secondAllocs = AllocationCounter::count() - allocsBefore;
+            double secondSeconds = spawner.spawnStats().lastSpawnSeconds;
+            world.eventBus->clear();
+
+            printf("  %s: ", warm ? "prewarmed" : "cold     ");
+            if (warm) printf("prewarm %.2f ms, ", prewarmSeconds * 1e3);
+            if (AllocationCounter::enabled)
+                printf("wave 1 %.3f ms, %zu allocations; after %llu recycled, wave 2 %.3f ms, %zu allocations\n",
+                    firstSeconds * 1e3, firstAllocs, static_cast<unsigned long long>(spawner.spawnStats().recycled), secondSeconds * 1e3, secondAllocs);
+            else
+                printf("wave 1 %.3f ms; after %llu recycled, wave 2 %.3f ms\n",
+                    firstSeconds * 1e3, static_cast<unsigned long long>(spawner.spawnStats().recycled), secondSeconds * 1e3);
+            printf("             %d/%d armed and enabled, %d heavies, %zu ships ever built\n",
+                ready, waveSize, heavy, std::max(created, world.enemyShips->totalCreated()));
+            check(ready == waveSize, "spawned wave ships not armed and enabled");
+        }
+
+        // An enemy recycled from a heavy comes back as a stock ship with a stock gun
+        World world(0x3a7eu);
+        World::Scope scope(world);
+        auto ship = ShipFactory::spawnEnemy(world, vec2(0.0f));
+        Ship* recycled = ship.get();
+        auto gun = std::dynamic_pointer_cast<EnemyGun>(ship->hardpoints[0]->weapon);
+        gun->damage = 40.0f;
+        gun->shotInterval = 1.5f;
+        ship->setMaxHealth(300.0f);
+        ShipFactory::despawnEnemy(world, std::move(ship));
+        ship = ShipFactory::spawnEnemy(world, vec2(0.0f));
+        check(ship.get() == recycled && gun->damage == EnemyGun::DefaultDamage && gun->shotInterval == EnemyGun::DefaultShotInterval,
+            "recycled enemy kept the previous kind's gun");
+        auto health = ship->getComponent<HealthComponent>();
+        check(health->maxHealth == Ship::DefaultMaxHealth && health->health == Ship::DefaultMaxHealth && health->armor == Ship::DefaultArmor,
+            "recycled enemy kept the previous kind's health");
+    }
+
+    inline int run(int argc, char** argv) {
+        int shipsPerSide = argc > 2 ? std::atoi(argv[2]) : 4;
+        int frames = argc > 3 ? std::atoi(argv[3]) : 3000;
+        int actors = argc > 4 ? std::atoi(argv[4]) : 10000;
+
+        initHeadlessServices(0x5eed);
+        runCombat(shipsPerSide, frames);
+        runComponentUpdates(actors, 500);
+        runInputUpdate(8, 200000);
+        runGamepadSampler(1000.0, 1.0);
+        runInputRecording("bench_input.v3in");
+        runSnapshot(8, 200);
+        runRollback(0.100, 0.05, 1800);
+        runSpectators(4, shipsPerSide, 1200);
+        runParallelWorlds(std::clamp<int>(std::thread::hardware_concurrency(), 2, 8), shipsPerSide, 600);
+        runDirector(5000, 50, 100);
+        runAiScheduling(8, 300);
+        runSwarm(2000, 300);
+        runFlowField(10000, 300);
+        runFlocking(120);
+        runWaveSpawner(500);
+
+        if (failedChecks > 0) printf("%d checks FAILED\n", failedChecks);
+        return failedChecks > 0 ? 1 : 0;
+    }
+}
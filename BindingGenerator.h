@@ -2,56 +2,57 @@
 
 #include "InputSystem.h"
 
-void bindKeyboardAndMouse(InputDevice keyboard, InputDevice mouse, PlayerInput& playerInput, int screenHeight) {
-    playerInput.devices.push_back(keyboard);
-    playerInput.devices.push_back(mouse);
+// viewHeight: height of the space the cursor is reported in, its Y is flipped to point up
+void bindKeyboardAndMouse(InputDevice keyboard, InputDevice mouse, PlayerInput& playerInput, int viewHeight) {
+    playerInput.addDevice(keyboard);
+    playerInput.addDevice(mouse);
     // ---------------- Keyboard ----------------
     InputBinding moveRight{ .device = keyboard, .code = GLFW_KEY_D, .scale = 1.0f };
     InputBinding moveLeft{ .device = keyboard, .code = GLFW_KEY_A, .scale = -1.0f };
     InputBinding moveUp{ .device = keyboard, .code = GLFW_KEY_W, .scale = 1.0f };
     InputBinding moveDown{ .device = keyboard, .code = GLFW_KEY_S, .scale = -1.0f };
 
-    playerInput.bindings[Action::MoveHorizontal].push_back(moveRight);
-    playerInput.bindings[Action::MoveHorizontal].push_back(moveLeft);
+    playerInput.addBinding(Action::MoveHorizontal, moveRight);
+    playerInput.addBinding(Action::MoveHorizontal, moveLeft);
 
-    playerInput.bindings[Action::MoveVertical].push_back(moveUp);
-    playerInput.bindings[Action::MoveVertical].push_back(moveDown);
+    playerInput.addBinding(Action::MoveVertical, moveUp);
+    playerInput.addBinding(Action::MoveVertical, moveDown);
 
     // ---------------- Mouse axes ----------------
     InputBinding mouseX{ .device = mouse, .axisCode = 0, .scale = 1.0f };
-    InputBinding mouseY{ .device = mouse, .axisCode = 1, .scale = -1.0f, .offset = static_cast<float>(screenHeight) };
+    InputBinding mouseY{ .device = mouse, .axisCode = 1, .scale = -1.0f, .offset = static_cast<float>(viewHeight) };
 
-    playerInput.bindings[Action::MousePositionHorizontal].push_back(mouseX);
-    playerInput.bindings[Action::MousePositionVertical].push_back(mouseY);
+    playerInput.addBinding(Action::MousePositionHorizontal, mouseX);
+    playerInput.addBinding(Action::MousePositionVertical, mouseY);
 
     // ---------------- Mouse buttons ----------------
     InputBinding mouseRight{ .device = mouse, .code = GLFW_MOUSE_BUTTON_2 };
     InputBinding mouseLeft{ .device = mouse, .code = GLFW_MOUSE_BUTTON_1 };
 
-    playerInput.bindings[Action::SecondaryAbility].push_back(mouseRight);
-    playerInput.bindings[Action::PrimaryAbility].push_back(mouseLeft);
+    playerInput.addBinding(Action::SecondaryAbility, mouseRight);
+    playerInput.addBinding(Action::PrimaryAbility, mouseLeft);
 }
 
 
 void bindGamepad(InputDevice gamepad, PlayerInput& playerInput) {
-    playerInput.devices.push_back(gamepad);
+    playerInput.addDevice(gamepad);
     // Left stick: movement
     InputBinding leftStickX{ .device = gamepad, .axisCode = GLFW_GAMEPAD_AXIS_LEFT_X, .scale = 1.0f, .deadzone = 0.05f };
     InputBinding leftStickY{ .device = gamepad, .axisCode = GLFW_GAMEPAD_AXIS_LEFT_Y, .scale = -1.0f, .deadzone = 0.05f };
 
-    playerInput.bindings[Action::MoveHorizontal].push_back(leftStickX);
-    playerInput.bindings[Action::MoveVertical].push_back(leftStickY);
+    playerInput.addBinding(Action::MoveHorizontal, leftStickX);
+    playerInput.addBinding(Action::MoveVertical, leftStickY);
 
     // Right stick: aiming
     InputBinding rightStickX{ .device = gamepad, .axisCode = GLFW_GAMEPAD_AXIS_RIGHT_X, .scale = 1.0f, .deadzone = 0.05f };
     InputBinding rightStickY{ .device = gamepad, .axisCode = GLFW_GAMEPAD_AXIS_RIGHT_Y, .scale = -1.0f, .deadzone = 0.05f };
 
-    playerInput.bindings[Action::AimHorizontal].push_back(rightStickX);
-    playerInput.bindings[Action::AimVertical].push_back(rightStickY);
+    playerInput.addBinding(Action::AimHorizontal, rightStickX);
+    playerInput.addBinding(Action::AimVertical, rightStickY);
 
     // Right bumper: shoot
     InputBinding rightBumper{ .device = gamepad, .code = GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER };
 	InputBinding leftBumper{ .device = gamepad, .code = GLFW_GAMEPAD_BUTTON_LEFT_BUMPER };
-    playerInput.bindings[Action::PrimaryAbility].push_back(rightBumper);
-	playerInput.bindings[Action::SecondaryAbility].push_back(leftBumper);
+    playerInput.addBinding(Action::PrimaryAbility, rightBumper);
+	playerInput.addBinding(Action::SecondaryAbility, leftBumper);
 }
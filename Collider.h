@@ -1,8 +1,22 @@
 #pragma once
 #include "Transform2D.h"
-#include <unordered_set>
+#include <vector>
+#include <algorithm>
 #include <functional>
 #include "CollisionLayers.h"
+#include "Registry.h"
+
+class PhysicsReceiver;
+class HealthComponent;
+
+// What a collider belongs to, filled in once when it is attached so hit
+// handling doesn't need casts, weak_ptr locks or component lookups by type
+struct ColliderUserData {
+    Transform2D* owner = nullptr;
+    Entity entity;
+    PhysicsReceiver* physics = nullptr;     // knockback target, may be null
+    ComponentRef<HealthComponent> health;   // damage target and its team, may be empty
+};
 
 class Collider2D : public Transform2D {
 public:
@@ -12,6 +26,9 @@ public:
     int layer = 0;
     int mask = 0xFFFF;
     bool isTrigger = false;
+    bool enabled = true;        // disabled colliders are skipped by the collision system
+    ColliderUserData userData;
+    uint32_t systemIndex = 0;   // position in CollisionSystem::colliders, kept up to date by the system
 
     // Collision callbacks
     std::function<void(Collider2D*)> onCollisionEnter;
@@ -19,19 +36,28 @@ public:
     std::function<void(Collider2D*)> onCollisionExit;
 
 private:
-    std::unordered_set<Collider2D*> currentCollisions;
-    std::unordered_set<Collider2D*> collisionsThisFrame;
+    // A collider only touches a handful of others, flat lists beat hashing and
+    // keep their capacity between frames
+    std::vector<Collider2D*> currentCollisions;
+    std::vector<Collider2D*> collisionsThisFrame;
+
+    static bool contains(const std::vector<Collider2D*>& list, Collider2D* c) {
+        return std::find(list.begin(), list.end(), c) != list.end();
+    }
 
 public:
-    Collider2D(ShapeType shape) : shapeType(shape) {}
+    Collider2D(ShapeType shape) : shapeType(shape) {
+        currentCollisions.reserve(4);
+        collisionsThisFrame.reserve(4);
+    }
 
     // Call when a collision is detected
     void handleCollision(Collider2D* other) {
-        collisionsThisFrame.insert(other);
+        if (contains(collisionsThisFrame, other)) return;
+        collisionsThisFrame.push_back(other);
 
-        if (currentCollisions.find(other) == currentCollisions.end()) {
+        if (!contains(currentCollisions, other)) {
             // First frame of collision
-            currentCollisions.insert(other);
             if (onCollisionEnter) onCollisionEnter(other);
         }
         else {
@@ -42,20 +68,53 @@ public:
 
     // Call once per frame after all collisions are processed
     void finalizeCollisions() {
-        for (auto it = currentCollisions.begin(); it != currentCollisions.end();) {
-            if (collisionsThisFrame.find(*it) == collisionsThisFrame.end()) {
+        for (auto* c : currentCollisions) {
+            if (!contains(collisionsThisFrame, c)) {
                 // Collision ended
-                if (onCollisionExit) onCollisionExit(*it);
-                it = currentCollisions.erase(it);
-            }
-            else {
-                ++it;
+                if (onCollisionExit) onCollisionExit(c);
             }
         }
+        currentCollisions.swap(collisionsThisFrame);
         collisionsThisFrame.clear();
     }
 
     bool isCollidingWith(Collider2D* other) const {
-        return currentCollisions.find(other) != currentCollisions.end();
+        return contains(currentCollisions, other);
+    }
+
+    void setEnabled(bool value) {
+        enabled = value;
+        if (!enabled) {
+            currentCollisions.clear();
+            collisionsThisFrame.clear();
+        }
+    }
+
+    // Contacts are saved by CollisionSystem, they point at other colliders
+    const std::vector<Collider2D*>& getContacts() const { return currentCollisions; }
+
+    void setContacts(const std::vector<Collider2D*>& contacts) {
+        currentCollisions.assign(contacts.begin(), contacts.end());
+        collisionsThisFrame.clear();
+    }
+
+    // Called by ObjectPool when the collider is handed back
+    void resetForPool() {
+        setEnabled(false);
+        onCollisionEnter = nullptr;
+        onCollisionStay = nullptr;
+        onCollisionExit = nullptr;
+        userData = ColliderUserData{};
+    }
+
+protected:
+    void saveOwnState(SnapshotWriter& out) const override {
+        Transform2D::saveOwnState(out);
+        out.write(enabled);
+    }
+
+    void loadOwnState(SnapshotReader& in) override {
+        Transform2D::loadOwnState(in);
+        in.read(enabled);
     }
 };
@@ -1,6 +1,8 @@
 #pragma once
 #include <vector>
+#include <limits>
 #include "Collider.h"
+#include "Pool.h"
 
 
 
@@ -53,7 +55,7 @@ inline bool overlapOnAxis(const OBB& A, const OBB& B, const vec2& axis)
     return distance <= projA + projB;
 }
 
-bool obbVsObb(Collider2D& A_c, Collider2D& B_c)
+inline bool obbVsObb(Collider2D& A_c, Collider2D& B_c)
 {
     OBB A = getOBB(A_c);
     OBB B = getOBB(B_c);
@@ -67,7 +69,7 @@ bool obbVsObb(Collider2D& A_c, Collider2D& B_c)
     return true;
 }
 
-bool circleVsObb(Collider2D& C, Collider2D& B_c)
+inline bool circleVsObb(Collider2D& C, Collider2D& B_c)
 {
     OBB B = getOBB(B_c);
 
@@ -130,14 +132,135 @@ inline void testCollision(std::shared_ptr<Collider2D> A, std::shared_ptr<Collide
     }
 }
 
+struct RaycastHit {
+    Collider2D* collider = nullptr;
+    vec2 point = vec2(0.0f);
+    float distance = 0.0f;
+};
+
+// Ray (normalized dir) vs circle, returns distance to the entry point
+inline bool rayVsCircle(const vec2& origin, const vec2& dir, const vec2& center, float radius, float& tHit)
+{
+    vec2 m = origin - center;
+    float b = dot(m, dir);
+    float c = dot(m, m) - radius * radius;
+
+    // Origin outside and pointing away
+    if (c > 0.0f && b > 0.0f) return false;
+
+    float disc = b * b - c;
+    if (disc < 0.0f) return false;
+
+    tHit = glm::max(0.0f, -b - sqrt(disc));
+    return true;
+}
+
+// Ray (normalized dir) vs OBB using slabs in box space
+inline bool rayVsObb(const vec2& origin, const vec2& dir, const OBB& box, float& tHit)
+{
+    vec2 d = origin - box.center;
+    float tMin = 0.0f;
+    float tMax = std::numeric_limits<float>::max();
+
+    for (int i = 0; i < 2; i++) {
+        float o = dot(d, box.axes[i]);
+        float v = dot(dir, box.axes[i]);
+
+        if (fabs(v) < 1e-6f) {
+            if (fabs(o) > box.extents[i]) return false;
+            continue;
+        }
+
+        float t1 = (-box.extents[i] - o) / v;
+        float t2 = (box.extents[i] - o) / v;
+        if (t1 > t2) std::swap(t1, t2);
+
+        tMin = glm::max(tMin, t1);
+        tMax = glm::min(tMax, t2);
+        if (tMin > tMax) return false;
+    }
+
+    tHit = tMin;
+    return true;
+}
+
 class CollisionSystem {
 public:
     std::vector<std::weak_ptr<Collider2D>> colliders;
 
+    // Weak refs to pooled colliders point into the pool's arena
+    ~CollisionSystem() { colliders.clear(); }
+
     void addCollider(const std::shared_ptr<Collider2D>& c) {
+        c->systemIndex = static_cast<uint32_t>(colliders.size());
         colliders.push_back(c);
     }
 
+    // Pooled collider, registered on first use and re-enabled when recycled
+    std::shared_ptr<Collider2D> acquireCollider(Collider2D::ShapeType shape) {
+        bool fresh = colliderPool.available() == 0;
+        auto c = colliderPool.acquire(shape);
+        if (fresh)
+            addCollider(c);
+        c->shapeType = shape;
+        c->setEnabled(true);
+        return c;
+    }
+
+    // Registers count disabled colliders with the pool ahead of time
+    void prewarmColliders(size_t count) {
+        std::vector<std::shared_ptr<Collider2D>> warm;
+        warm.reserve(count);
+        colliders.reserve(colliders.size() + count);
+        for (size_t i = 0; i < count; i++)
+            warm.push_back(acquireCollider(Collider2D::ShapeType::Circle));
+        for (auto& c : warm)
+            releaseCollider(std::move(c));
+    }
+
+    void releaseCollider(std::shared_ptr<Collider2D> c) {
+        if (!c) return;
+        if (auto p = c->parent.lock())
+            p->removeChild(c);
+        colliderPool.release(std::move(c));
+    }
+
+    // Closest collider hit by a segment, colliders owned by ignore are skipped
+    bool raycast(const vec2& origin, const vec2& dir, float maxDistance, int mask,
+        RaycastHit& hit, const Transform2D* ignore = nullptr)
+    {
+        hit = RaycastHit{};
+        hit.distance = maxDistance;
+
+        for (auto& w : colliders) {
+            auto c = w.lock();
+            if (!c) continue;
+            if (!c->enabled || (mask & c->layer) == 0) continue;
+            if (ignore && c->userData.owner == ignore) continue;
+
+            float t = 0.0f;
+            bool intersects = false;
+
+            if (c->shapeType == Collider2D::ShapeType::Circle) {
+                float radius = c->scale.x * c->getWorldScale().x;
+                intersects = rayVsCircle(origin, dir, c->getWorldPosition(), radius, t);
+            }
+            else {
+                intersects = rayVsObb(origin, dir, getOBB(*c), t);
+            }
+
+            if (intersects && t <= hit.distance) {
+                hit.collider = c.get();
+                hit.distance = t;
+            }
+        }
+
+        if (!hit.collider) return false;
+
+        hit.point = origin + dir * hit.distance;
+        return true;
+    }
+
     void update() {
         colliders.erase(
             std::remove_if(colliders.begin(), colliders.end(),
@@ -147,15 +270,16 @@ public:
             ),
             colliders.end()
         );
+        reindex();
 
         // pairwise collision test
         for (int i = 0; i < colliders.size(); i++) {
             auto a = colliders[i].lock();
-            if (!a) continue;
+            if (!a || !a->enabled) continue;
 
             for (int j = i + 1; j < colliders.size(); j++) {
                 auto b = colliders[j].lock();
-                if (!b) continue;
+                if (!b || !b->enabled) continue;
 
                 testCollision(a, b);
             }
@@ -163,7 +287,61 @@ public:
 
         for (int i = 0; i < colliders.size(); i++) {
             auto a = colliders[i].lock();
-            a->finalizeCollisions();
+            if (a) a->finalizeCollisions();
         }
     }
+
+    // Contact lists as collider indices. Enabled flags and shapes travel with
+    // the owning transforms; the collider list itself is not rebuilt on load.
+    void saveState(SnapshotWriter& out) {
+        out.write(static_cast<uint32_t>(colliders.size()));
+        for (auto& w : colliders) {
+            auto c = w.lock();
+            if (!c) {
+                out.write(uint32_t(0));
+                continue;
+            }
+            const auto& contacts = c->getContacts();
+            out.write(static_cast<uint32_t>(contacts.size()));
+            for (Collider2D* other : contacts)
+                out.write(other->systemIndex);
+        }
+    }
+
+    // Colliders registered after the snapshot are disabled, they did not exist yet
+    bool loadState(SnapshotReader& in) {
+        uint32_t count = 0;
+        if (!in.read(count) || count > colliders.size()) return in.fail();
+
+        std::vector<Collider2D*> contacts;
+        for (uint32_t i = 0; i < colliders.size(); i++) {
+            auto c = colliders[i].lock();
+            if (i >= count) {
+                if (c) c->setEnabled(false);
+                continue;
+            }
+
+            uint32_t contactCount = 0;
+            if (!in.read(contactCount)) return false;
+
+            contacts.clear();
+            for (uint32_t k = 0; k < contactCount; k++) {
+                uint32_t index = 0;
+                if (!in.read(index) || index >= count) return in.fail();
+                if (auto other = colliders[index].lock())
+                    contacts.push_back(other.get());
+            }
+            if (c) c->setContacts(contacts);
+        }
+        return in.good();
+    }
+
+private:
+    ObjectPool<Collider2D> colliderPool;
+
+    void reindex() {
+        for (uint32_t i = 0; i < colliders.size(); i++)
+            if (auto c = colliders[i].lock())
+                c->systemIndex = i;
+    }
 };
\ No newline at end of file
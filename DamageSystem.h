@@ -0,0 +1,87 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include "Registry.h"
+#include "HealthComponent.h"
+
+
+struct DamageCommand {
+    Entity target;
+    float amount;
+    void* source;
+    uint32_t sequence;      // queue order, keeps same-target hits in a stable order
+};
+
+
+// Per-frame damage command buffer.
+// Hits are queued from collision callbacks and hitscan, then applied in one pass
+// after collision, grouped by target: armor per hit, one health change, one
+// DamageEvent (with hit count) and at most one death check per target.
+class DamageSystem {
+public:
+    void queue(Entity target, float amount, void* source = nullptr) {
+        if (!target.isValid() || amount <= 0.0f) return;
+        commands.push_back(DamageCommand{ target, amount, source, static_cast<uint32_t>(commands.size()) });
+    }
+
+    // Merge hits gathered elsewhere (e.g. a per-thread buffer) before flushing
+    void append(const DamageSystem& other) {
+        for (const auto& c : other.commands)
+            queue(c.target, c.amount, c.source);
+    }
+
+    void flush(Registry& registry) {
+        lastHits = commands.size();
+        lastTargets = 0;
+        if (commands.empty()) return;
+
+        std::sort(commands.begin(), commands.end(), [](const DamageCommand& a, const DamageCommand& b) {
+            if (a.target.index != b.target.index) return a.target.index < b.target.index;
+            if (a.target.generation != b.target.generation) return a.target.generation < b.target.generation;
+            return a.sequence < b.sequence;
+            });
+
+        size_t begin = 0;
+        while (begin < commands.size()) {
+            size_t end = begin + 1;
+            while (end < commands.size() && commands[end].target == commands[begin].target)
+                end++;
+
+            applyGroup(registry, begin, end);
+            begin = end;
+        }
+
+        commands.clear();
+    }
+
+    void clear() { commands.clear(); }
+
+    size_t pending() const { return commands.size(); }
+
+    // Stats of the last flush
+    size_t lastHitCount() const { return lastHits; }
+    size_t lastTargetCount() const { return lastTargets; }
+
+private:
+    std::vector<DamageCommand> commands;
+    size_t lastHits = 0;
+    size_t lastTargets = 0;
+
+    void applyGroup(Registry& registry, size_t begin, size_t end) {
+        HealthComponent* health = registry.get<HealthComponent>(commands[begin].target);
+        if (!health) return;
+
+        float total = 0.0f;
+        int hits = 0;
+        for (size_t i = begin; i < end; i++) {
+            float actual = health->armorReduced(commands[i].amount);
+            if (actual <= 0.0f) continue;
+            total += actual;
+            hits++;
+        }
+
+        lastTargets++;
+        health->applyHits(total, hits, commands[end - 1].source);
+    }
+};
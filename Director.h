@@ -2,24 +2,84 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <limits>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
 #include "Actor.h"
 #include "PhysicalActor2D.h"
 #include "SimpleShootingAi.h"
+#include "PointGrid.h"
 #include <glm/glm.hpp>
 
+// Hands every AI a target among the opponents. Opponent positions and velocities are
+// read once per frame into a grid, each AI then looks at its `candidates` nearest
+// opponents and takes the closest one that isn't already chased by
+// maxAttackersPerOpponent AIs (the least chased one if all are).
+//
+// Thinking is level-of-detail scheduled: AIs near their target or inside the view
+// think every tick, the rest every farInterval ticks, staggered, and coast on their
+// last decision in between. Targets are picked again only when an AI thinks. With a
+// think budget the overflow waits for a later tick, stalest first. AI state isn't
+// part of world snapshots, so where ticks get re-simulated keep farInterval at 1 and
+// the budget off.
 class Director {
 public:
     std::vector<Actor2D*> opponents;              // raw opponent pointers
     std::vector<SimpleShootingAi*> activeAIs;         // active AI controllers
 
+    struct Settings {
+        int candidates = 4;                 // nearest opponents considered per AI
+        int maxAttackersPerOpponent = 0;    // 0: no limit, everyone takes the nearest
+
+        float nearRadius = 1200.0f;         // this close to its target an AI thinks every tick
+        int farInterval = 8;                // ticks between thinks further out
+        double thinkBudgetSeconds = 0.0;    // per update, 0 for no limit; depends on timing
+    };
+    Settings settings;
+
+    struct ThinkStats {
+        int thinks = 0;                     // full thinks last update
+        int coasting = 0;                   // steered on an earlier decision
+        int deferred = 0;                   // due, pushed to a later tick by the budget
+        int64_t oldestThink = 0;            // ticks since the stalest AI thought
+        double thinkSeconds = 0.0;
+        uint64_t totalDeferred = 0;
+    };
+    const ThinkStats& thinkStats() const { return stats; }
+
+    // AIs whose pawn is inside this rectangle think every tick
+    void setView(const glm::vec2& min, const glm::vec2& max) {
+        viewMin = min;
+        viewMax = max;
+        hasView = true;
+    }
+
     void addOpponent(Actor2D* actor) {
         if (!actor) return;
-        if (std::find(opponents.begin(), opponents.end(), actor) == opponents.end())
+        if (std::find(opponents.begin(), opponents.end(), actor) == opponents.end()) {
             opponents.push_back(actor);
+            opponentPhysics.push_back(dynamic_cast<PhysicalActor2D*>(actor));
+            opponentFields.push_back(nullptr);
+        }
+    }
+
+    // A flow field seeded from this opponent alone, AIs chasing it close in along it
+    void setFlowField(Actor2D* actor, const FlowField* field) {
+        auto it = std::find(opponents.begin(), opponents.end(), actor);
+        if (it != opponents.end()) opponentFields[it - opponents.begin()] = field;
     }
 
     void removeOpponent(Actor2D* actor) {
-        opponents.erase(std::remove(opponents.begin(), opponents.end(), actor), opponents.end());
+        auto it = std::find(opponents.begin(), opponents.end(), actor);
+        if (it == opponents.end()) return;
+        opponentPhysics.erase(opponentPhysics.begin() + (it - opponents.begin()));
+        opponentFields.erase(opponentFields.begin() + (it - opponents.begin()));
+        opponents.erase(it);
+
+        // Opponent indices moved, everyone picks again on their next think
+        targets.assign(targets.size(), -1);
+        attackers.assign(opponents.size(), 0);
     }
 
     void addAI(SimpleShootingAi* ai) {
@@ -29,38 +89,167 @@ public:
     }
 
     void removeAI(SimpleShootingAi* ai) {
-        activeAIs.erase(std::remove(activeAIs.begin(), activeAIs.end(), ai), activeAIs.end());
+        auto it = std::find(activeAIs.begin(), activeAIs.end(), ai);
+        if (it == activeAIs.end()) return;
+        size_t index = it - activeAIs.begin();
+        if (index < targets.size()) {
+            if (targets[index] >= 0) attackers[targets[index]]--;
+            targets.erase(targets.begin() + index);
+        }
+        if (index < lastThink.size()) lastThink.erase(lastThink.begin() + index);
+        activeAIs.erase(it);
+    }
+
+    // Picks a target for every AI, see targetOf() and attackersOf()
+    void assignTargets() {
+        readOpponents();
+        targets.assign(activeAIs.size(), -1);
+        attackers.assign(opponents.size(), 0);
+        for (size_t a = 0; a < activeAIs.size(); a++)
+            assignTarget(a);
     }
 
-    // Update all AIs, providing each with the closest opponent's position & velocity
+    // Update all AIs: the ones due pick a target and think with its position & velocity,
+    // the others coast on their last decision
     void update(double dt) {
         if (opponents.empty() || activeAIs.empty()) return;
 
-        for (auto* ai : activeAIs) {
-            if (!ai) continue;
+        readOpponents();
+        tick++;
+        targets.resize(activeAIs.size(), -1);
+        lastThink.resize(activeAIs.size(), tick);
 
-            Actor2D* closestOpponent = nullptr;
-            float minDistSqr = std::numeric_limits<float>::max();
+        uint64_t totalDeferred = stats.totalDeferred;
+        stats = ThinkStats{};
+        stats.totalDeferred = totalDeferred;
 
-            for (auto* opp : opponents) {
-                glm::vec2 diff = opp->getWorldPosition() - ai->pawnPosition();
-                float distSqr = glm::dot(diff, diff);
-                if (distSqr < minDistSqr) {
-                    minDistSqr = distSqr;
-                    closestOpponent = opp;
-                }
+        // Far AIs think on their own phase of the interval so they don't all think together,
+        // or as soon as possible once the budget made them miss it. New AIs have no target
+        // yet and think right away.
+        int64_t interval = std::max(1, settings.farInterval);
+        nearDue.clear();
+        farDue.clear();
+        for (size_t a = 0; a < activeAIs.size(); a++) {
+            if (!activeAIs[a]) continue;
+            int t = targets[a];
+            glm::vec2 at = activeAIs[a]->pawnPosition();
+            bool near = t < 0 ||
+                (hasView && at.x >= viewMin.x && at.y >= viewMin.y && at.x <= viewMax.x && at.y <= viewMax.y);
+            if (!near) {
+                glm::vec2 d = positions[t] - at;
+                near = glm::dot(d, d) < settings.nearRadius * settings.nearRadius;
             }
 
-            if (closestOpponent) {
-                // Try to cast to PhysicalActor2D to get velocity, otherwise default to zero
-                glm::vec2 targetVel(0.0f);
-                if (auto phys = dynamic_cast<PhysicalActor2D*>(closestOpponent)) {
-                    targetVel = phys->getVelocity();
+            if (near) nearDue.push_back(static_cast<int>(a));
+            else if ((tick + static_cast<int64_t>(a)) % interval == 0 || tick - lastThink[a] > interval)
+                farDue.push_back(static_cast<int>(a));
+        }
+
+        // Overdue far AIs first
+        std::sort(farDue.begin(), farDue.end(), [&](int a, int b) {
+            return lastThink[a] != lastThink[b] ? lastThink[a] < lastThink[b] : a < b;
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        thinking.assign(activeAIs.size(), 0);
+        bool overBudget = false;
+        for (const std::vector<int>* due : { &nearDue, &farDue }) {
+            for (int a : *due) {
+                // The clock is read every few thinks, a think is much cheaper than a read
+                if (settings.thinkBudgetSeconds > 0.0 && (stats.thinks & 15) == 0 && stats.thinks > 0 &&
+                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() > settings.thinkBudgetSeconds)
+                    overBudget = true;
+                if (overBudget) {
+                    stats.deferred++;
+                    continue;
                 }
 
-                ai->setTarget(closestOpponent->getWorldPosition(), targetVel);
-                ai->update(dt);
+                assignTarget(a);
+                int t = targets[a];
+                if (t < 0) continue;
+                activeAIs[a]->setTarget(positions[t], velocities[t], opponentFields[t]);
+                activeAIs[a]->think(dt);
+                lastThink[a] = tick;
+                thinking[a] = 1;
+                stats.thinks++;
             }
         }
+        stats.thinkSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats.totalDeferred += stats.deferred;
+
+        for (size_t a = 0; a < activeAIs.size(); a++) {
+            if (thinking[a] || targets[a] < 0) continue;
+            activeAIs[a]->coast(dt);
+            stats.coasting++;
+            stats.oldestThink = std::max(stats.oldestThink, tick - lastThink[a]);
+        }
     }
+
+    // Opponent index the AI at `ai` in activeAIs was given, -1 for none
+    int targetOf(size_t ai) const { return ai < targets.size() ? targets[ai] : -1; }
+    int attackersOf(size_t opponent) const { return opponent < attackers.size() ? attackers[opponent] : 0; }
+
+private:
+    static constexpr int MaxCandidates = 16;
+
+    void readOpponents() {
+        positions.resize(opponents.size());
+        velocities.resize(opponents.size());
+        for (size_t i = 0; i < opponents.size(); i++) {
+            positions[i] = opponents[i]->getWorldPosition();
+            velocities[i] = opponentPhysics[i] ? opponentPhysics[i]->getVelocity() : glm::vec2(0.0f);
+        }
+        grid.build(positions);
+        attackers.resize(opponents.size(), 0);
+    }
+
+    void assignTarget(size_t a) {
+        if (targets[a] >= 0) attackers[targets[a]]--;
+        targets[a] = -1;
+        if (!activeAIs[a]) return;
+
+        int k = settings.maxAttackersPerOpponent > 0 ? std::clamp(settings.candidates, 1, MaxCandidates) : 1;
+        int nearestIndex[MaxCandidates];
+        float nearestDistSqr[MaxCandidates];
+        int found = grid.nearest(activeAIs[a]->pawnPosition(), k, nearestIndex, nearestDistSqr);
+        if (found == 0) return;
+
+        int pick = nearestIndex[0];
+        if (settings.maxAttackersPerOpponent > 0) {
+            int leastChased = pick;
+            pick = -1;
+            for (int c = 0; c < found; c++) {
+                int candidate = nearestIndex[c];
+                if (attackers[candidate] < settings.maxAttackersPerOpponent) {
+                    pick = candidate;
+                    break;
+                }
+                if (attackers[candidate] < attackers[leastChased]) leastChased = candidate;
+            }
+            if (pick < 0) pick = leastChased;
+        }
+
+        targets[a] = pick;
+        attackers[pick]++;
+    }
+
+    std::vector<PhysicalActor2D*> opponentPhysics;     // parallel to opponents, null when not physical
+    std::vector<const FlowField*> opponentFields;      // parallel to opponents, null for none
+
+    // Read every update
+    std::vector<glm::vec2> positions, velocities;
+    PointGrid grid;
+
+    // Kept between updates, an AI picks again each time it thinks
+    std::vector<int> targets;       // per AI
+    std::vector<int> attackers;     // per opponent, AIs holding it as their target
+
+    // Think scheduling
+    int64_t tick = 0;
+    std::vector<int64_t> lastThink;     // per AI
+    std::vector<int> nearDue, farDue;
+    std::vector<uint8_t> thinking;
+    glm::vec2 viewMin = glm::vec2(0.0f), viewMax = glm::vec2(0.0f);
+    bool hasView = false;
+    ThinkStats stats;
 };
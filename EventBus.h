@@ -1,7 +1,7 @@
 #pragma once
 #include "glm/glm.hpp"
-#include <any>
 #include <vector>
+#include <memory>
 #include <unordered_map>
 #include <functional>
 #include <typeindex>
@@ -14,48 +14,68 @@ public:
     // Subscribe a callback for a specific event type
     template <typename EventType>
     void subscribe(std::function<void(const EventType&)> callback) {
-        auto& subs = subscribers[typeid(EventType)];
-        // Store as std::function<void(std::any)>
-        subs.push_back([callback](const std::any& e) {
-            // Cast to EventType reference, not pointer
-            callback(std::any_cast<const EventType&>(e));
-            });
+        channel<EventType>().subscribers.push_back(std::move(callback));
     }
 
     // Unsubscribe all callbacks for a type (optional)
     template <typename EventType>
     void clearSubscribers() {
-        subscribers.erase(typeid(EventType));
+        channel<EventType>().subscribers.clear();
     }
 
     // Emit an event, notify all subscribers
     template <typename EventType>
     void emit(const EventType& event) {
+        auto& ch = channel<EventType>();
+
         // 1. Add to queued events
-        events.push_back(std::make_any<EventType>(event));
+        ch.events.push_back(event);
 
         // 2. Notify subscribers immediately
-        auto it = subscribers.find(typeid(EventType));
-        if (it != subscribers.end()) {
-            for (auto& sub : it->second) {
-                sub(events.back());
-            }
+        for (auto& sub : ch.subscribers) {
+            sub(ch.events.back());
         }
     }
 
     template <typename T, typename F>
     void process(F func) {
-        for (auto& ev : events) {
-            if (auto* e = std::any_cast<T>(&ev)) {
-                func(*e);
-            }
+        auto it = channels.find(typeid(T));
+        if (it == channels.end()) return;
+
+        auto& ch = static_cast<Channel<T>&>(*it->second);
+        for (auto& e : ch.events) {
+            func(e);
         }
     }
 
-    void clear() { events.clear(); }
+    // Queued events keep their capacity, so steady-state emitting doesn't allocate
+    void clear() {
+        for (auto& [type, ch] : channels)
+            ch->clear();
+    }
 
 private:
-    std::vector<std::any> events;
+    struct ChannelBase {
+        virtual ~ChannelBase() = default;
+        virtual void clear() = 0;
+    };
+
+    // Events of one type are stored by value, no type erasure per event
+    template <typename T>
+    struct Channel : ChannelBase {
+        std::vector<T> events;
+        std::vector<std::function<void(const T&)>> subscribers;
 
-    std::unordered_map<std::type_index, std::vector<std::function<void(const std::any&)>>> subscribers;
+        void clear() override { events.clear(); }
+    };
+
+    std::unordered_map<std::type_index, std::unique_ptr<ChannelBase>> channels;
+
+    template <typename T>
+    Channel<T>& channel() {
+        auto& ch = channels[typeid(T)];
+        if (!ch)
+            ch = std::make_unique<Channel<T>>();
+        return static_cast<Channel<T>&>(*ch);
+    }
 };
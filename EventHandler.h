@@ -14,9 +14,12 @@ public:
 
 
 	void processEvents() {
-		if (!Services::eventBus) return;
+		if (Services::eventBus) processEvents(*Services::eventBus);
+	}
 
-		Services::eventBus->process<ShootEvent>([&](const ShootEvent shot) {
+	// Presents one world's events through the app's sound
+	void processEvents(EventBus& bus) {
+		bus.process<ShootEvent>([&](const ShootEvent shot) {
 			if (!Services::sound) return;
 			if (shot.projectileType == "laser_shot") {
 				Services::sound->play(shot.soundName);
@@ -26,7 +29,7 @@ public:
 			}
 		});
 
-		Services::eventBus->process<SoundEvent>([&](const SoundEvent sound) {
+		bus.process<SoundEvent>([&](const SoundEvent sound) {
 			if (!Services::sound) return;
 			if (sound.stop) {
 				Services::sound->stopForObject(sound.owner);
@@ -29,7 +29,8 @@ struct SoundEvent {
 
 struct DamageEvent {
     void* target = nullptr; // pointer to the owning actor/component
-    float amount = 0.0f;
+    float amount = 0.0f;    // total after armor
+    int hits = 1;           // hits folded into this event (one event per target per frame)
     int team = 0;
 };
 
@@ -0,0 +1,111 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "PhysicalActor2D.h"
+#include "PointGrid.h"
+
+// Local avoidance for a group of ships: separation keeps them from overlapping,
+// alignment and cohesion make them move as a group. Once per update every member's
+// position goes into one grid sized to the neighbour radius, each member looks up its
+// neighbours there and the steering comes out as a force through applyForce.
+//
+// Forces are worked out from positions and velocities read before any is applied, so
+// the order of the members doesn't matter. Runs before the physics pass integrates.
+class Flock {
+public:
+    struct Settings {
+        float neighbourRadius = 250.0f;     // alignment and cohesion look this far
+        float separationRadius = 90.0f;     // closer than this pushes apart
+        float separationWeight = 6000.0f;   // push at full overlap, falls off to 0 at separationRadius
+        float alignmentWeight = 10.0f;      // per unit of velocity away from the neighbours'
+        float cohesionWeight = 400.0f;      // pull toward the neighbours' centre from neighbourRadius away
+        float maxForce = 8000.0f;
+    };
+    Settings settings;
+
+    void add(PhysicalActor2D* member) {
+        if (!member || std::find(members.begin(), members.end(), member) != members.end()) return;
+        members.push_back(member);
+    }
+
+    void remove(PhysicalActor2D* member) {
+        auto it = std::find(members.begin(), members.end(), member);
+        if (it == members.end()) return;
+        *it = members.back();
+        members.pop_back();
+    }
+
+    size_t size() const { return members.size(); }
+
+    void update(double dt) {
+        size_t n = members.size();
+        positions.resize(n);
+        velocities.resize(n);
+        forces.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            positions[i] = members[i]->getWorldPosition();
+            velocities[i] = members[i]->getVelocity();
+        }
+        grid.build(positions, settings.neighbourRadius);
+
+        neighbourCount = 0;
+        for (size_t i = 0; i < n; i++)
+            forces[i] = steer(i);
+
+        for (size_t i = 0; i < n; i++) {
+            PhysicsReceiver* receiver = members[i];
+            receiver->applyForce(forces[i], dt);
+        }
+    }
+
+    // Rebuilt every update from the members' positions, indices follow members
+    const PointGrid& neighbours() const { return grid; }
+    const std::vector<glm::vec2>& lastForces() const { return forces; }
+    size_t neighboursSeen() const { return neighbourCount; }
+
+private:
+    glm::vec2 steer(size_t i) {
+        const glm::vec2 p = positions[i];
+        const float separationSqr = settings.separationRadius * settings.separationRadius;
+
+        glm::vec2 push(0.0f), velocitySum(0.0f), positionSum(0.0f);
+        int count = 0;
+        grid.forEachWithin(p, settings.neighbourRadius, [&](int j, float distSqr) {
+            if (j == static_cast<int>(i)) return;
+            count++;
+            velocitySum += velocities[j];
+            positionSum += positions[j];
+
+            if (distSqr >= separationSqr) return;
+            float distance = std::sqrt(distSqr);
+            glm::vec2 away;
+            if (distance > 1e-3f) away = (p - positions[j]) / distance;
+            else {
+                // Stacked exactly: split them along a direction both sides agree on
+                float angle = static_cast<float>(std::min<size_t>(i, j) * 2.39996323);
+                away = glm::vec2(std::cos(angle), std::sin(angle)) * (i < static_cast<size_t>(j) ? 1.0f : -1.0f);
+            }
+            push += away * (1.0f - distance / settings.separationRadius);
+        });
+        neighbourCount += count;
+        if (count == 0) return glm::vec2(0.0f);
+
+        glm::vec2 force = push * settings.separationWeight;
+        force += (velocitySum / float(count) - velocities[i]) * settings.alignmentWeight;
+        force += (positionSum / float(count) - p) / settings.neighbourRadius * settings.cohesionWeight;
+
+        float length = glm::length(force);
+        if (length > settings.maxForce) force *= settings.maxForce / length;
+        return force;
+    }
+
+    std::vector<PhysicalActor2D*> members;
+
+    // Read every update, parallel to members
+    std::vector<glm::vec2> positions, velocities, forces;
+    PointGrid grid;
+    size_t neighbourCount = 0;
+};
@@ -0,0 +1,329 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "WorkerPool.h"
+
+// Grid flow field over a rectangle, usually the ScreenBoundsComponent area ships stay
+// in. Every cell holds the cheapest cost to reach one of the targets, the integration
+// field, and the direction to its cheapest neighbour, so an agent anywhere on the
+// field finds its way around obstacles with one lookup: direction(position). Seeded
+// from several targets it leads to whichever is nearest, so agents chasing one target
+// in particular want a field seeded from that target alone.
+//
+// Cells cost 1 to cross unless setCost/addObstacle says otherwise; Blocked cells can't
+// be crossed at all. rebuildIfNeeded() only rebuilds once a target has moved more
+// than rebuildDistance or costs changed, the field stays good enough until then.
+//
+// The integration field is built as a wavefront over tiles of cells. Tiles with
+// something new at their border relax on their own, half of them at a time in a
+// checkerboard so no two tiles working together touch each other's cells, until
+// nothing changes anymore. Shortest costs are unique, so the field comes out the
+// same for any number of threads.
+class FlowField {
+public:
+    static constexpr uint8_t Blocked = 255;
+    static constexpr uint32_t Unreachable = std::numeric_limits<uint32_t>::max();
+
+    float rebuildDistance = 64.0f;      // target movement that triggers a rebuild
+
+    struct BuildStats {
+        uint64_t builds = 0;
+        int rounds = 0;                 // checkerboard halves in the last build
+        int tilesRelaxed = 0;
+        double seconds = 0.0;
+    };
+
+    // threads: how many build the field, 0 for one per hardware thread
+    FlowField(const glm::vec2& min, const glm::vec2& max, float cellSize = 32.0f, unsigned threads = 0)
+        : origin(min), cellSize(cellSize), workers(threads) {
+        width = std::max(1, static_cast<int>(std::ceil((max.x - min.x) / cellSize)));
+        height = std::max(1, static_cast<int>(std::ceil((max.y - min.y) / cellSize)));
+        tilesX = (width + TileSize - 1) / TileSize;
+        tilesY = (height + TileSize - 1) / TileSize;
+
+        costs.assign(size_t(width) * height, 1);
+        integration.assign(costs.size(), Unreachable);
+        directions.assign(costs.size(), glm::vec2(0.0f));
+        tileDirty.assign(size_t(tilesX) * tilesY, 0);
+        tileChanged.assign(tileDirty.size(), 0);
+        tileFresh.assign(tileDirty.size(), 0);
+    }
+
+    int columns() const { return width; }
+    unsigned threads() const { return workers.size(); }
+    int rows() const { return height; }
+    float cell() const { return cellSize; }
+    const BuildStats& stats() const { return buildStats; }
+
+    // -----------------------------
+    // Costs
+    // -----------------------------
+    void setCost(int x, int y, uint8_t cost) {
+        if (x < 0 || y < 0 || x >= width || y >= height) return;
+        costs[index(x, y)] = std::max<uint8_t>(cost, 1);
+        costsChanged = true;
+    }
+
+    // Every cell whose centre lies inside the rectangle
+    void setCost(const glm::vec2& min, const glm::vec2& max, uint8_t cost) {
+        glm::ivec2 from = cellOf(min), to = cellOf(max);
+        for (int y = from.y; y <= to.y; y++)
+            for (int x = from.x; x <= to.x; x++) {
+                glm::vec2 c = centerOf(x, y);
+                if (c.x >= min.x && c.y >= min.y && c.x <= max.x && c.y <= max.y) setCost(x, y, cost);
+            }
+    }
+
+    // Blocks every cell whose centre lies inside the circle
+    void addObstacle(const glm::vec2& center, float radius) {
+        glm::ivec2 from = cellOf(center - radius), to = cellOf(center + radius);
+        for (int y = from.y; y <= to.y; y++)
+            for (int x = from.x; x <= to.x; x++) {
+                glm::vec2 d = centerOf(x, y) - center;
+                if (glm::dot(d, d) <= radius * radius) setCost(x, y, Blocked);
+            }
+    }
+
+    void clearCosts() {
+        std::fill(costs.begin(), costs.end(), uint8_t(1));
+        costsChanged = true;
+    }
+
+    // -----------------------------
+    // Building
+    // -----------------------------
+
+    // Rebuilds when costs changed, the number of targets did or one moved further than
+    // rebuildDistance since the last build. Returns true when it rebuilt.
+    bool rebuildIfNeeded(const std::vector<glm::vec2>& targets) {
+        bool stale = costsChanged || targets.size() != builtTargets.size();
+        for (size_t i = 0; !stale && i < targets.size(); i++) {
+            glm::vec2 d = targets[i] - builtTargets[i];
+            stale = glm::dot(d, d) > rebuildDistance * rebuildDistance;
+        }
+        if (!stale) return false;
+        rebuild(targets);
+        return true;
+    }
+
+    void rebuild(const std::vector<glm::vec2>& targets) {
+        auto start = std::chrono::steady_clock::now();
+        builtTargets = targets;
+        costsChanged = false;
+
+        std::fill(integration.begin(), integration.end(), Unreachable);
+        std::fill(tileDirty.begin(), tileDirty.end(), uint8_t(0));
+        std::fill(tileFresh.begin(), tileFresh.end(), uint8_t(1));
+        for (const glm::vec2& t : targets) {
+            glm::ivec2 c = cellOf(t);
+            if (costs[index(c.x, c.y)] == Blocked) continue;
+            integration[index(c.x, c.y)] = 0;
+
+            // Its own tile and, in case it sits on the border, the ones next to it
+            int tx = c.x / TileSize, ty = c.y / TileSize;
+            tileDirty[size_t(ty) * tilesX + tx] = 1;
+            if (tx > 0) tileDirty[size_t(ty) * tilesX + tx - 1] = 1;
+            if (tx + 1 < tilesX) tileDirty[size_t(ty) * tilesX + tx + 1] = 1;
+            if (ty > 0) tileDirty[size_t(ty - 1) * tilesX + tx] = 1;
+            if (ty + 1 < tilesY) tileDirty[size_t(ty + 1) * tilesX + tx] = 1;
+        }
+
+        buildStats.rounds = 0;
+        buildStats.tilesRelaxed = 0;
+        for (bool any = true; any;) {
+            any = false;
+            for (int color = 0; color < 2; color++) {
+                batch.clear();
+                for (int ty = 0; ty < tilesY; ty++)
+                    for (int tx = (ty + color) & 1; tx < tilesX; tx += 2) {
+                        size_t tile = size_t(ty) * tilesX + tx;
+                        if (!tileDirty[tile]) continue;
+                        tileDirty[tile] = 0;
+                        batch.push_back(static_cast<int>(tile));
+                    }
+                if (batch.empty()) continue;
+                any = true;
+                buildStats.rounds++;
+                buildStats.tilesRelaxed += static_cast<int>(batch.size());
+
+                workers.parallelFor(batch.size(), [this](size_t i) { relaxTile(batch[i]); });
+
+                // Neighbours whose shared border changed have something new to spread
+                for (int tile : batch) {
+                    uint8_t sides = tileChanged[tile];
+                    int tx = tile % tilesX, ty = tile / tilesX;
+                    if ((sides & Left) && tx > 0) tileDirty[tile - 1] = 1;
+                    if ((sides & Right) && tx + 1 < tilesX) tileDirty[tile + 1] = 1;
+                    if ((sides & Up) && ty > 0) tileDirty[tile - tilesX] = 1;
+                    if ((sides & Down) && ty + 1 < tilesY) tileDirty[tile + tilesX] = 1;
+                }
+            }
+        }
+
+        workers.parallelFor(height, [this](size_t y) { buildDirections(static_cast<int>(y)); });
+
+        buildStats.builds++;
+        buildStats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // -----------------------------
+    // Sampling
+    // -----------------------------
+
+    // Unit direction toward the cheapest way to a target, zero on a target's cell and
+    // where no target can be reached
+    glm::vec2 direction(const glm::vec2& position) const {
+        glm::ivec2 c = cellOf(position);
+        return directions[index(c.x, c.y)];
+    }
+
+    uint32_t costToTarget(const glm::vec2& position) const {
+        glm::ivec2 c = cellOf(position);
+        return integration[index(c.x, c.y)];
+    }
+
+    const std::vector<uint32_t>& integrationField() const { return integration; }
+
+    // Clamped to the grid
+    glm::ivec2 cellOf(const glm::vec2& position) const {
+        glm::vec2 local = (position - origin) / cellSize;
+        int x = std::clamp(static_cast<int>(std::floor(local.x)), 0, width - 1);
+        int y = std::clamp(static_cast<int>(std::floor(local.y)), 0, height - 1);
+        return glm::ivec2(x, y);
+    }
+
+    glm::vec2 centerOf(int x, int y) const {
+        return origin + (glm::vec2(x, y) + 0.5f) * cellSize;
+    }
+
+private:
+    static constexpr int TileSize = 16;
+    enum Side : uint8_t { Left = 1, Right = 2, Up = 4, Down = 8 };
+
+    size_t index(int x, int y) const { return size_t(y) * width + x; }
+
+    // Dijkstra inside the tile, started from the cells that got cheaper through its
+    // border (or all of them the first time in a build). Records which of its borders
+    // changed.
+    void relaxTile(int tile) {
+        int x0 = (tile % tilesX) * TileSize, y0 = (tile / tilesX) * TileSize;
+        int x1 = std::min(x0 + TileSize, width), y1 = std::min(y0 + TileSize, height);
+        uint8_t sides = 0;
+
+        // Cost in the high half so the heap orders by it
+        thread_local std::vector<uint64_t> open;
+        open.clear();
+        auto push = [&](uint32_t cost, size_t i) {
+            open.push_back(uint64_t(cost) << 32 | i);
+            std::push_heap(open.begin(), open.end(), std::greater<uint64_t>());
+        };
+        auto lower = [&](int x, int y, size_t i, uint32_t cost) {
+            integration[i] = cost;
+            if (x == x0) sides |= Left;
+            if (x == x1 - 1) sides |= Right;
+            if (y == y0) sides |= Up;
+            if (y == y1 - 1) sides |= Down;
+            push(cost, i);
+        };
+
+        if (tileFresh[tile]) {
+            tileFresh[tile] = 0;
+            for (int y = y0; y < y1; y++)
+                for (int x = x0; x < x1; x++)
+                    if (integration[index(x, y)] != Unreachable) push(integration[index(x, y)], index(x, y));
+        }
+
+        // Pull from the cells just outside
+        auto pull = [&](int x, int y, int ox, int oy) {
+            if (ox < 0 || oy < 0 || ox >= width || oy >= height) return;
+            size_t i = index(x, y);
+            if (costs[i] == Blocked) return;
+            uint32_t cost = step(integration[index(ox, oy)], costs[i]);
+            if (cost < integration[i]) lower(x, y, i, cost);
+        };
+        for (int x = x0; x < x1; x++) {
+            pull(x, y0, x, y0 - 1);
+            pull(x, y1 - 1, x, y1);
+        }
+        for (int y = y0; y < y1; y++) {
+            pull(x0, y, x0 - 1, y);
+            pull(x1 - 1, y, x1, y);
+        }
+
+        while (!open.empty()) {
+            std::pop_heap(open.begin(), open.end(), std::greater<uint64_t>());
+            uint64_t top = open.back();
+            open.pop_back();
+            uint32_t cost = static_cast<uint32_t>(top >> 32);
+            size_t i = static_cast<size_t>(top & 0xffffffffu);
+            if (cost != integration[i]) continue;
+
+            int x = static_cast<int>(i % width), y = static_cast<int>(i / width);
+            auto spread = [&](int nx, int ny) {
+                size_t n = index(nx, ny);
+                if (costs[n] == Blocked) return;
+                uint32_t next = cost + costs[n];
+                if (next < integration[n]) lower(nx, ny, n, next);
+            };
+            if (x > x0) spread(x - 1, y);
+            if (x + 1 < x1) spread(x + 1, y);
+            if (y > y0) spread(x, y - 1);
+            if (y + 1 < y1) spread(x, y + 1);
+        }
+        tileChanged[tile] = sides;
+    }
+
+    static uint32_t step(uint32_t from, uint8_t cost) {
+        return from == Unreachable ? Unreachable : from + cost;
+    }
+
+    // Points every cell at its cheapest neighbour, diagonals only where neither side
+    // is blocked so agents don't clip obstacle corners
+    void buildDirections(int y) {
+        static const glm::vec2 unitDiagonal = glm::normalize(glm::vec2(1.0f));
+        for (int x = 0; x < width; x++) {
+            size_t i = index(x, y);
+            uint32_t best = integration[i];
+            glm::vec2 dir(0.0f);
+            if (best != 0 && best != Unreachable) {
+                for (int dy = -1; dy <= 1; dy++)
+                    for (int dx = -1; dx <= 1; dx++) {
+                        int nx = x + dx, ny = y + dy;
+                        if ((dx == 0 && dy == 0) || nx < 0 || ny < 0 || nx >= width || ny >= height) continue;
+                        if (dx != 0 && dy != 0 && (costs[index(nx, y)] == Blocked || costs[index(x, ny)] == Blocked)) continue;
+                        uint32_t v = integration[index(nx, ny)];
+                        if (v >= best) continue;
+                        best = v;
+                        dir = (dx != 0 && dy != 0) ? glm::vec2(dx, dy) * unitDiagonal : glm::vec2(dx, dy);
+                    }
+            }
+            directions[i] = dir;
+        }
+    }
+
+    glm::vec2 origin;
+    float cellSize;
+    int width = 0, height = 0;
+    int tilesX = 0, tilesY = 0;
+
+    std::vector<uint8_t> costs;
+    std::vector<uint32_t> integration;
+    std::vector<glm::vec2> directions;
+    bool costsChanged = true;
+    std::vector<glm::vec2> builtTargets;
+
+    std::vector<uint8_t> tileDirty;
+    std::vector<uint8_t> tileChanged;   // sides written by a tile's last relax
+    std::vector<uint8_t> tileFresh;     // not relaxed yet this build
+    std::vector<int> batch;
+
+    WorkerPool workers;
+    BuildStats buildStats;
+};
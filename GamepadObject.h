@@ -5,12 +5,14 @@
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
+#include <array>
 #include <algorithm>
 
 #include "AnalogStickObject.h"
 #include "ButtonObject.h"
 
 #include "GamepadInput.h"
+#include "GamepadSampler.h"
 #include "Actor.h"
 
 using namespace glm;
@@ -53,6 +55,15 @@ public:
 	std::shared_ptr<ButtonObject> bumperLeft;
 	std::shared_ptr<ButtonObject> bumperRight;
 
+	// Stick values of the most recent samples, shows motion between frames
+	static constexpr size_t TrailLength = 32;
+
+private:
+	std::array<vec2, TrailLength> leftTrail{};
+	std::array<vec2, TrailLength> rightTrail{};
+	size_t trailHead = 0;
+	size_t trailCount = 0;
+
 public:
 
 	GamepadObject()
@@ -162,6 +173,41 @@ public:
 		bumperRight->setPressed(input.rightBumper);
 	}
 
+	// All samples taken since the last frame, oldest first. The buttons and
+	// stick heads show the newest one, the trail keeps the ones in between.
+	void updateFromSamples(const std::vector<GamepadSample>& samples) {
+		if (samples.empty()) return;
+
+		for (const GamepadSample& sample : samples) {
+			const float* axes = sample.state.axes;
+			leftTrail[trailHead] = GamepadInput::filteredStick(axes[GLFW_GAMEPAD_AXIS_LEFT_X], axes[GLFW_GAMEPAD_AXIS_LEFT_Y]);
+			rightTrail[trailHead] = GamepadInput::filteredStick(axes[GLFW_GAMEPAD_AXIS_RIGHT_X], axes[GLFW_GAMEPAD_AXIS_RIGHT_Y]);
+			trailHead = (trailHead + 1) % TrailLength;
+			trailCount = std::min(trailCount + 1, TrailLength);
+		}
+
+		GamepadInput input;
+		input.updateFromState(samples.back().state);
+		updateFromInput(input);
+	}
+
+	// Calls fn(from, to) in world space for each step of both stick trails, oldest first
+	template <typename Fn>
+	void forEachTrailSegment(Fn&& fn) {
+		const mat3& world = getWorldMatrix();
+		auto toWorld = [&](const AnalogStickObject& stick, vec2 value) {
+			return vec2(world * vec3(stick.displacedPosition(value), 1.0f));
+		};
+
+		size_t first = (trailHead + TrailLength - trailCount) % TrailLength;
+		for (size_t i = 1; i < trailCount; i++) {
+			size_t a = (first + i - 1) % TrailLength;
+			size_t b = (first + i) % TrailLength;
+			fn(toWorld(*leftStick, leftTrail[a]), toWorld(*leftStick, leftTrail[b]));
+			fn(toWorld(*rightStick, rightTrail[a]), toWorld(*rightStick, rightTrail[b]));
+		}
+	}
+
 	virtual void update(double dt) override {
 		leftStick->update(dt);
 		rightStick->update(dt);
@@ -0,0 +1,77 @@
+#include "GamepadSampler.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <timeapi.h>
+#include <Xinput.h>
+#pragma comment(lib, "Xinput.lib")
+#pragma comment(lib, "winmm.lib")
+
+namespace {
+    float stickAxis(SHORT value) {
+        return value < 0 ? value / 32768.0f : value / 32767.0f;
+    }
+
+    // GLFW reports triggers as -1 (released) .. 1 (fully pressed)
+    float triggerAxis(BYTE value) {
+        return value / 127.5f - 1.0f;
+    }
+}
+
+bool XInputGamepadSource::sample(int pad, double time, GLFWgamepadstate& out) {
+    if (pad < 0 || pad >= XUSER_MAX_COUNT || time < retryAt[pad]) return false;
+
+    XINPUT_STATE state;
+    if (XInputGetState(pad, &state) != ERROR_SUCCESS) {
+        retryAt[pad] = time + 1.0;
+        return false;
+    }
+
+    // Same layout glfwGetGamepadState produces, Y axes pointing down
+    const XINPUT_GAMEPAD& g = state.Gamepad;
+    out.axes[GLFW_GAMEPAD_AXIS_LEFT_X] = stickAxis(g.sThumbLX);
+    out.axes[GLFW_GAMEPAD_AXIS_LEFT_Y] = -stickAxis(g.sThumbLY);
+    out.axes[GLFW_GAMEPAD_AXIS_RIGHT_X] = stickAxis(g.sThumbRX);
+    out.axes[GLFW_GAMEPAD_AXIS_RIGHT_Y] = -stickAxis(g.sThumbRY);
+    out.axes[GLFW_GAMEPAD_AXIS_LEFT_TRIGGER] = triggerAxis(g.bLeftTrigger);
+    out.axes[GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER] = triggerAxis(g.bRightTrigger);
+
+    static const struct { WORD mask; int button; } buttons[] = {
+        { XINPUT_GAMEPAD_A, GLFW_GAMEPAD_BUTTON_A },
+        { XINPUT_GAMEPAD_B, GLFW_GAMEPAD_BUTTON_B },
+        { XINPUT_GAMEPAD_X, GLFW_GAMEPAD_BUTTON_X },
+        { XINPUT_GAMEPAD_Y, GLFW_GAMEPAD_BUTTON_Y },
+        { XINPUT_GAMEPAD_LEFT_SHOULDER, GLFW_GAMEPAD_BUTTON_LEFT_BUMPER },
+        { XINPUT_GAMEPAD_RIGHT_SHOULDER, GLFW_GAMEPAD_BUTTON_RIGHT_BUMPER },
+        { XINPUT_GAMEPAD_BACK, GLFW_GAMEPAD_BUTTON_BACK },
+        { XINPUT_GAMEPAD_START, GLFW_GAMEPAD_BUTTON_START },
+        { XINPUT_GAMEPAD_LEFT_THUMB, GLFW_GAMEPAD_BUTTON_LEFT_THUMB },
+        { XINPUT_GAMEPAD_RIGHT_THUMB, GLFW_GAMEPAD_BUTTON_RIGHT_THUMB },
+        { XINPUT_GAMEPAD_DPAD_UP, GLFW_GAMEPAD_BUTTON_DPAD_UP },
+        { XINPUT_GAMEPAD_DPAD_RIGHT, GLFW_GAMEPAD_BUTTON_DPAD_RIGHT },
+        { XINPUT_GAMEPAD_DPAD_DOWN, GLFW_GAMEPAD_BUTTON_DPAD_DOWN },
+        { XINPUT_GAMEPAD_DPAD_LEFT, GLFW_GAMEPAD_BUTTON_DPAD_LEFT },
+    };
+
+    for (auto& b : out.buttons) b = GLFW_RELEASE;
+    for (const auto& b : buttons)
+        out.buttons[b.button] = (g.wButtons & b.mask) ? GLFW_PRESS : GLFW_RELEASE;
+
+    return true;
+}
+
+// Default Windows timer granularity is ~15.6 ms, far too coarse for 1 kHz sleeps
+void GamepadSampler::beginHighResolutionTimer() { timeBeginPeriod(1); }
+void GamepadSampler::endHighResolutionTimer() { timeEndPeriod(1); }
+
+#else
+
+// XInput is Windows only, elsewhere use another GamepadSource
+bool XInputGamepadSource::sample(int, double, GLFWgamepadstate&) { return false; }
+
+void GamepadSampler::beginHighResolutionTimer() {}
+void GamepadSampler::endHighResolutionTimer() {}
+
+#endif
@@ -0,0 +1,248 @@
+#pragma once
+#include <atomic>
+#include <algorithm>
+#include <array>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <memory>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <GLFW/glfw3.h>
+#include "Random.h"
+
+
+// Lock-free single producer / single consumer ring.
+// When full the producer drops the new item and counts it, the consumer never blocks.
+template <typename T, size_t Capacity>
+class SpscRing {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    bool push(const T& item) {
+        size_t head = writeIndex.load(std::memory_order_relaxed);
+        size_t tail = readIndex.load(std::memory_order_acquire);
+        if (head - tail == Capacity) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        items[head & (Capacity - 1)] = item;
+        writeIndex.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T& out) {
+        size_t tail = readIndex.load(std::memory_order_relaxed);
+        size_t head = writeIndex.load(std::memory_order_acquire);
+        if (tail == head) return false;
+
+        out = items[tail & (Capacity - 1)];
+        readIndex.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const {
+        return writeIndex.load(std::memory_order_acquire) - readIndex.load(std::memory_order_acquire);
+    }
+
+    size_t droppedCount() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+    std::array<T, Capacity> items{};
+    alignas(64) std::atomic<size_t> writeIndex{ 0 };
+    alignas(64) std::atomic<size_t> readIndex{ 0 };
+    std::atomic<size_t> dropped{ 0 };
+};
+
+
+struct GamepadSample {
+    double time = 0.0;          // seconds on the sampler clock
+    uint32_t sequence = 0;      // per pad, gaps mean dropped samples
+    GLFWgamepadstate state{};
+};
+
+
+// Where samples come from. Called on the sampler thread only.
+class GamepadSource {
+public:
+    virtual ~GamepadSource() = default;
+
+    // false when the pad isn't connected
+    virtual bool sample(int pad, double time, GLFWgamepadstate& out) = 0;
+};
+
+
+// Reads controllers through XInput, which unlike GLFW's joystick API may be
+// called off the main thread. Only available on Windows (GamepadSampler.cpp).
+// XInput only sees Xbox-style pads: DualShock, DualSense, Switch Pro and other HID
+// pads never show up here and have to be polled through GLFW. Pads are XInput user
+// indices, which match GLFW joystick ids only when XInput pads are the first ones
+// GLFW finds (it enumerates them before DirectInput devices).
+class XInputGamepadSource : public GamepadSource {
+public:
+    bool sample(int pad, double time, GLFWgamepadstate& out) override;
+
+private:
+    // Polling an empty slot is slow, disconnected pads are retried once a second
+    double retryAt[4] = {};
+};
+
+
+// Deterministic stick circles, button pulses and optional sensor noise
+class SyntheticGamepadSource : public GamepadSource {
+public:
+    float stickHz = 2.0f;       // revolutions per second
+    float buttonHz = 5.0f;      // button A presses per second
+    float noise = 0.0f;         // stddev added to every axis
+    float restDuty = 0.0f;      // share of each second the sticks sit centered
+    bool connected[4] = { true, false, false, false };
+
+    explicit SyntheticGamepadSource(uint64_t seed = 0x9a3e) : rng(seed, 7) {}
+
+    bool sample(int pad, double time, GLFWgamepadstate& out) override {
+        if (pad < 0 || pad >= 4 || !connected[pad]) return false;
+
+        out = GLFWgamepadstate{};
+        const float phase = static_cast<float>(time * stickHz * 6.283185307179586);
+
+        if (std::fmod(time, 1.0) >= restDuty) {
+            out.axes[GLFW_GAMEPAD_AXIS_LEFT_X] = std::cos(phase);
+            out.axes[GLFW_GAMEPAD_AXIS_LEFT_Y] = std::sin(phase);
+            out.axes[GLFW_GAMEPAD_AXIS_RIGHT_X] = 0.5f * std::cos(-phase);
+            out.axes[GLFW_GAMEPAD_AXIS_RIGHT_Y] = 0.5f * std::sin(-phase);
+        }
+        out.axes[GLFW_GAMEPAD_AXIS_LEFT_TRIGGER] = -1.0f;
+        out.axes[GLFW_GAMEPAD_AXIS_RIGHT_TRIGGER] = -1.0f;
+
+        if (noise > 0.0f)
+            for (int a = 0; a < 4; a++)
+                out.axes[a] += noise * Ziggurat::normal(rng);
+
+        out.buttons[GLFW_GAMEPAD_BUTTON_A] = std::fmod(time * buttonHz, 1.0) < 0.5 ? GLFW_PRESS : GLFW_RELEASE;
+        return true;
+    }
+
+private:
+    Pcg32 rng;
+};
+
+
+// Samples gamepads on its own thread at a fixed rate, independent of the
+// render loop, into one SPSC ring per pad. The main thread drains the rings.
+class GamepadSampler {
+public:
+    static constexpr size_t RingCapacity = 1024;   // ~1 s at 1 kHz
+    using Clock = std::chrono::steady_clock;
+
+    GamepadSampler() = default;
+    GamepadSampler(const GamepadSampler&) = delete;
+    GamepadSampler& operator=(const GamepadSampler&) = delete;
+
+    ~GamepadSampler() { stop(); }
+
+    // rateHz is clamped to 500..1000, padMask selects pads 0..3
+    void start(std::unique_ptr<GamepadSource> newSource, double rateHz = 1000.0, unsigned padMask = 0x1) {
+        stop();
+
+        source = std::move(newSource);
+        interval = 1.0 / std::min(1000.0, std::max(500.0, rateHz));
+        mask = padMask;
+        epoch = Clock::now();
+        running.store(true, std::memory_order_release);
+        worker = std::thread([this] { run(); });
+    }
+
+    void stop() {
+        running.store(false, std::memory_order_release);
+        if (worker.joinable())
+            worker.join();
+        for (auto& c : connected)
+            c.store(false, std::memory_order_relaxed);
+    }
+
+    bool isRunning() const { return running.load(std::memory_order_acquire); }
+    double getInterval() const { return interval; }
+
+    // Whether the pad is selected and its source reported it on the last pass.
+    // Pads that aren't are left to the caller, see InputSystem
+    bool isSampling(int pad) const {
+        return isRunning() && (mask & (1u << pad)) && connected[pad].load(std::memory_order_acquire);
+    }
+
+    // Seconds on the same clock as GamepadSample::time
+    double now() const {
+        return std::chrono::duration<double>(Clock::now() - epoch).count();
+    }
+
+    // Append every pending sample of a pad, oldest first
+    size_t drain(int pad, std::vector<GamepadSample>& out) {
+        size_t n = 0;
+        GamepadSample s;
+        while (rings[pad].pop(s)) {
+            out.push_back(s);
+            n++;
+        }
+        return n;
+    }
+
+    // Newest sample of a pad, discarding older pending ones
+    bool latest(int pad, GamepadSample& out) {
+        bool any = false;
+        while (rings[pad].pop(out))
+            any = true;
+        return any;
+    }
+
+    size_t droppedCount(int pad) const { return rings[pad].droppedCount(); }
+
+private:
+    std::unique_ptr<GamepadSource> source;
+    std::array<SpscRing<GamepadSample, RingCapacity>, 4> rings;
+    std::array<uint32_t, 4> sequence{};
+    std::array<std::atomic<bool>, 4> connected{};
+    std::thread worker;
+    std::atomic<bool> running{ false };
+    double interval = 0.001;
+    unsigned mask = 0x1;
+    Clock::time_point epoch;
+
+    // Finer OS timer granularity while sampling (Windows only)
+    static void beginHighResolutionTimer();
+    static void endHighResolutionTimer();
+
+    void run() {
+        beginHighResolutionTimer();
+
+        const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval));
+        auto next = Clock::now();
+
+        while (running.load(std::memory_order_acquire)) {
+            double t = now();
+
+            for (int pad = 0; pad < 4; pad++) {
+                if (!(mask & (1u << pad))) continue;
+
+                GamepadSample s;
+                s.time = t;
+                bool present = source->sample(pad, t, s.state);
+                connected[pad].store(present, std::memory_order_release);
+                if (!present) continue;
+                s.sequence = sequence[pad]++;
+                rings[pad].push(s);
+            }
+
+            // Sleep most of the interval, spin the last bit to keep jitter low
+            next += step;
+            auto now = Clock::now();
+            if (next < now) next = now;     // fell behind, don't try to catch up in a burst
+            if (next - now > std::chrono::microseconds(300))
+                std::this_thread::sleep_until(next - std::chrono::microseconds(200));
+            while (Clock::now() < next)
+                std::this_thread::yield();
+        }
+
+        endHighResolutionTimer();
+    }
+};
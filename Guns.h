@@ -22,41 +22,47 @@ public:
     void startFiring() override { firing = true; }
     void stopFiring() override { firing = false; }
 
-    void update(double dt) override {
-        nextShot -= dt;
+    void resetForPool() override {
+        Weapon::resetForPool();
+        firing = false;
+    }
 
+protected:
+    void saveOwnState(SnapshotWriter& out) const override {
+        Weapon::saveOwnState(out);
+        out.write(firing);
+    }
 
-        if (!firing) return;
+    void loadOwnState(SnapshotReader& in) override {
+        Weapon::loadOwnState(in);
+        in.read(firing);
+    }
 
+public:
 
-        if (nextShot <= 0) {
-            nextShot = shotInterval;
+    void update(double dt) override {
+        advanceShotClock(dt);
 
+        if (!firing) {
+            holdFire();
+            return;
+        }
 
-            auto parentPtr = parent.lock();
-            if (!parentPtr) return;
+        if (collectDueShots() == 0) return;
 
-            // spawn projectile
+        auto parentPtr = parent.lock();
+        if (!parentPtr) return;
 
-            auto projectile = std::make_shared<LaserProjectile>(
-                getWorldPosition(),
-                forwardWorld() * shotSpeed,
-                lifetime,
-                damage,
-                team
-            );
-            projectile->init();
-            projectile->scale = getWorldScale() / 1.5f;
-            Services::projectiles->addProjectile(projectile);
-
-            Services::eventBus->emit(ShootEvent{
-                .position = getWorldPosition(),
-                .direction = forwardWorld(),
-                .projectileType = "laser_shot",
-                .soundName = "laser_shot",
-                .effectName = "laser_shot"
-                });
-        }
+        // spawn every projectile due this tick
+        emitProjectiles(forwardWorld(), shotSpeed, lifetime, getWorldScale() / 1.5f, "laser_shot");
+
+        world->eventBus->emit(ShootEvent{
+            .position = getWorldPosition(),
+            .direction = forwardWorld(),
+            .projectileType = "laser_shot",
+            .soundName = "laser_shot",
+            .effectName = "laser_shot"
+            });
     }
 };
 
@@ -77,6 +83,8 @@ public:
         spoolTimeRemaining = spool; // start fully unspooled
         deviation = radians(0.6f);
         recoil = 1.0f;
+        fireMode = FireMode::Hitscan;
+        range = shotSpeed * lifetime;
     }
 
     // Minigun properties
@@ -97,8 +105,8 @@ public:
         // Start spool sound if not already and gun not overheated
         if (!spoolSoundPlaying && !overheated) {
             float startTime = spool - spoolTimeRemaining; // 0 = unspooled, 1 = fully spooled
-            if (Services::eventBus)
-                Services::eventBus->emit(SoundEvent{
+            if (world)
+                world->eventBus->emit(SoundEvent{
                     .owner = &spoolSoundPlaying,
                     .soundName = "minigun_spool",
                     .startTime = startTime
@@ -111,20 +119,20 @@ public:
         firing = false;
 
         // Stop spool sound
-        if (spoolSoundPlaying && Services::eventBus) {
-            Services::eventBus->emit(SoundEvent{
+        if (spoolSoundPlaying && world) {
+            world->eventBus->emit(SoundEvent{
                 .owner = &spoolSoundPlaying,
                 .soundName = "minigun_spool",
                 .stop = true
                 });
             spoolSoundPlaying = false;
         }
-        if (shootSoundPlaying && Services::eventBus) {
-            Services::eventBus->emit(SoundEvent{
+        if (shootSoundPlaying && world) {
+            world->eventBus->emit(SoundEvent{
                 .owner = &stoppedFiring,
                 .soundName = "minigun_stop"
                 });
-            Services::eventBus->emit(SoundEvent{
+            world->eventBus->emit(SoundEvent{
                 .owner = &shootSoundPlaying,
                 .soundName = "minigun_shoot",
                 .stop = true
@@ -133,8 +141,20 @@ public:
         }
     }
 
+    // Cold and unspooled; stopFiring() has already stopped the sounds
+    void resetForPool() override {
+        Weapon::resetForPool();
+        firing = false;
+        currentHeat = 0.0f;
+        overheated = false;
+        spoolTimeRemaining = spool;
+        spoolSoundPlaying = false;
+        shootSoundPlaying = false;
+        stoppedFiring = true;
+    }
+
     void update(double dt) override {
-        nextShot -= dt;
+        advanceShotClock(dt);
 
         // Dissipate heat
         if (currentHeat > 0.0f)
@@ -146,12 +166,14 @@ public:
 
         // Handle firing logic
         if (!firing || overheated) {
+            holdFire();
+
             // Spool down when not firing
             spoolTimeRemaining = std::min(spool, spoolTimeRemaining + spoolDown * (float)dt);
 
             // Stop spool sound if it was playing
-            if (spoolSoundPlaying && Services::eventBus) {
-                Services::eventBus->emit(SoundEvent{
+            if (spoolSoundPlaying && world) {
+                world->eventBus->emit(SoundEvent{
                     .owner = &spoolSoundPlaying,
                     .soundName = "minigun_spool",
                     .stop = true
@@ -163,6 +185,8 @@ public:
 
         // Spool up
         if (spoolTimeRemaining > 0.0f) {
+            holdFire();
+
             spoolTimeRemaining -= (float)dt;
             spoolTimeRemaining = std::max(0.0f, spoolTimeRemaining);
 
@@ -171,16 +195,16 @@ public:
         }
 
         // fully spooled, make funny sounds
-        if (spoolSoundPlaying && Services::eventBus) {
-            Services::eventBus->emit(SoundEvent{
+        if (spoolSoundPlaying && world) {
+            world->eventBus->emit(SoundEvent{
                 .owner = &spoolSoundPlaying,
                 .soundName = "minigun_spool",
                 .stop = true
                 });
             spoolSoundPlaying = false;
         }
-        if (!shootSoundPlaying && Services::eventBus) {
-            Services::eventBus->emit(SoundEvent{
+        if (!shootSoundPlaying && world) {
+            world->eventBus->emit(SoundEvent{
             .owner = &shootSoundPlaying,
             .soundName = "minigun_shoot",
             .loop = true
@@ -191,10 +215,11 @@ public:
         // Gun fully spooled, check overheat
         if (currentHeat >= maxHeat) {
             overheated = true;
+            holdFire();
 
             // Stop spool sound
-            if (spoolSoundPlaying && Services::eventBus) {
-                Services::eventBus->emit(SoundEvent{
+            if (spoolSoundPlaying && world) {
+                world->eventBus->emit(SoundEvent{
                     .owner = &spoolSoundPlaying,
                     .soundName = "minigun_spool",
                     .stop = true
@@ -202,12 +227,12 @@ public:
                 spoolSoundPlaying = false;
 
             }
-            if (shootSoundPlaying && Services::eventBus) {
-                Services::eventBus->emit(SoundEvent{
+            if (shootSoundPlaying && world) {
+                world->eventBus->emit(SoundEvent{
                     .owner = &stoppedFiring,
                     .soundName = "minigun_stop"
                     });
-                Services::eventBus->emit(SoundEvent{
+                world->eventBus->emit(SoundEvent{
                 .owner = &shootSoundPlaying,
                 .soundName = "minigun_shoot",
                 .stop = true
@@ -219,13 +244,9 @@ public:
             return;
         }
 
-        // Fire projectile
-        if (nextShot <= 0) {
-            nextShot = shotInterval;
-            currentHeat += heatPerShot;
-
-            fireProjectile();
-        }
+        // Fire every shot due this tick as one batch
+        if (collectDueShots() > 0)
+            fireBurst();
     }
 
     void sendProjectileImpulse(vec2 intensity, float rotation) {
@@ -236,46 +257,71 @@ public:
         }
     }
 
-    void fireProjectile() {
+    void fireBurst() {
         auto parentPtr = parent.lock();
         if (!parentPtr) return;
 
-        // Spawn projectile
         // Get the base forward direction
+        vec2 origin = getWorldPosition();
         vec2 dir = forwardWorld();
+        vec2 scale = getWorldScale();
 
-        // Apply random deviation
-        static std::random_device rd;
-        static std::mt19937 gen(rd());
-        std::normal_distribution<float> dist(0.0f, deviation); // deviation in radians
+        // Use perpendicular to shot vector relative to ship forward
+        vec2 right = vec2(-dir.y, dir.x); // right-hand perpendicular
 
-        float angleOffset = dist(gen);
+        float recoilMagnitude = damage * recoil / 1000.0f * shotSpeed; // scale as needed
+        vec2 totalRecoil = vec2(0.0f);
+        float totalAngularImpulse = 0.0f;
 
-        // Rotate the direction vector by the angleOffset
-        float cosA = cos(angleOffset);
-        float sinA = sin(angleOffset);
-        vec2 deviatedDir = vec2(
-            dir.x * cosA - dir.y * sinA,
-            dir.x * sinA + dir.y * cosA
-        );
+        for (float age : dueShots) {
+            // Heat is tracked per shot, the rest of the batch is dropped once we overheat
+            if (currentHeat >= maxHeat) break;
+            currentHeat += heatPerShot;
 
+            float angleOffset = nextSpread(); // deviation in radians
 
-        // --- Compute recoil impulse ---
-        float recoilMagnitude = damage * recoil / 1000.0f * shotSpeed; // scale as needed
-        vec2 recoilImpulse = -deviatedDir * recoilMagnitude; // opposite to shot
+            // Rotate the direction vector by the angleOffset
+            float cosA = cos(angleOffset);
+            float sinA = sin(angleOffset);
+            vec2 deviatedDir = vec2(
+                dir.x * cosA - dir.y * sinA,
+                dir.x * sinA + dir.y * cosA
+            );
 
-        // --- Compute rotational impulse ---
-        // Use perpendicular to shot vector relative to ship forward
-        vec2 right = vec2(-dir.y, dir.x); // right-hand perpendicular
-        float angularImpulse = dot(recoilImpulse, right); // 0.1 = scaling factor for rotation
-        sendProjectileImpulse(recoilImpulse, angularImpulse);
-
-        // Spawn projectile with deviated direction
-        auto projectile = std::make_shared<LaserProjectile>(getWorldPosition(), deviatedDir * shotSpeed, lifetime, damage, team);
-        projectile->init();
-        projectile->scale = getWorldScale();
-        projectile->spriteName = "bullet_shot";
-        Services::projectiles->addProjectile(projectile);
+            // --- Accumulate recoil impulse, opposite to shot ---
+            vec2 recoilImpulse = -deviatedDir * recoilMagnitude;
+            totalRecoil += recoilImpulse;
+            totalAngularImpulse += dot(recoilImpulse, right);
+
+            if (fireMode == FireMode::Hitscan) {
+                fireHitscan(origin, deviatedDir, shotSpeed, "bullet_shot", scale, age);
+                continue;
+            }
+
+            // Spawn projectile with deviated direction, advanced by its sub-tick age
+            vec2 velocity = deviatedDir * shotSpeed;
+            spawnLaser(origin + velocity * age, velocity, lifetime - age, scale, "bullet_shot");
+        }
+
+        sendProjectileImpulse(totalRecoil, totalAngularImpulse);
+        flushProjectiles();
+    }
+protected:
+    // Sound flags are left alone, they follow whatever is actually playing
+    void saveOwnState(SnapshotWriter& out) const override {
+        Weapon::saveOwnState(out);
+        out.write(firing);
+        out.write(currentHeat);
+        out.write(overheated);
+        out.write(spoolTimeRemaining);
+    }
+
+    void loadOwnState(SnapshotReader& in) override {
+        Weapon::loadOwnState(in);
+        in.read(firing);
+        in.read(currentHeat);
+        in.read(overheated);
+        in.read(spoolTimeRemaining);
     }
 };
 
@@ -284,9 +330,12 @@ class EnemyGun : public Weapon {
     bool firing = false;
 
 public:
+    static constexpr float DefaultShotInterval = 1.0f;
+    static constexpr float DefaultDamage = 25.0f;
+
     EnemyGun() {
-        shotInterval = 1.0f;
-        damage = 25.0f;
+        shotInterval = DefaultShotInterval;
+        damage = DefaultDamage;
         team = 1;
     }
 
@@ -298,41 +347,55 @@ public:
     void startFiring() override { firing = true; }
     void stopFiring() override { firing = false; }
 
-    void update(double dt) override {
-        nextShot -= dt;
-
+    void resetForPool() override {
+        Weapon::resetForPool();
+        firing = false;
+    }
 
-        if (!firing) return;
+    // As built: default stats, shot clock and queue cleared
+    void resetToDefaults() {
+        resetForPool();
+        shotInterval = DefaultShotInterval;
+        damage = DefaultDamage;
+    }
 
+    bool isFiring() const { return firing; }
 
-        if (nextShot <= 0) {
-            nextShot = shotInterval;
+protected:
+    void saveOwnState(SnapshotWriter& out) const override {
+        Weapon::saveOwnState(out);
+        out.write(firing);
+    }
 
+    void loadOwnState(SnapshotReader& in) override {
+        Weapon::loadOwnState(in);
+        in.read(firing);
+    }
 
-            auto parentPtr = parent.lock();
-            if (!parentPtr) return;
+public:
 
-            // spawn projectile
+    void update(double dt) override {
+        advanceShotClock(dt);
 
-            auto projectile = std::make_shared<LaserProjectile>(
-                getWorldPosition(),
-                forwardWorld() * shotSpeed,
-                lifetime,
-                damage,
-                team
-            );
-            projectile->init();
-            projectile->scale = getWorldScale() / 1.5f;
-            projectile->spriteName = "enemy_shot";
-            Services::projectiles->addProjectile(projectile);
-
-            Services::eventBus->emit(ShootEvent{
-                .position = getWorldPosition(),
-                .direction = forwardWorld(),
-                .projectileType = "enemy_shot",
-                .soundName = "enemy_shot",
-                .effectName = "enemy_shot"
-                });
+        if (!firing) {
+            holdFire();
+            return;
         }
+
+        if (collectDueShots() == 0) return;
+
+        auto parentPtr = parent.lock();
+        if (!parentPtr) return;
+
+        // spawn every projectile due this tick
+        emitProjectiles(forwardWorld(), shotSpeed, lifetime, getWorldScale() / 1.5f, "enemy_shot");
+
+        world->eventBus->emit(ShootEvent{
+            .position = getWorldPosition(),
+            .direction = forwardWorld(),
+            .projectileType = "enemy_shot",
+            .soundName = "enemy_shot",
+            .effectName = "enemy_shot"
+            });
     }
 };
\ No newline at end of file
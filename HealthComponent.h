@@ -1,8 +1,10 @@
 #pragma once
 #include "BaseComponent.h"
 #include "glm/glm.hpp"
-#include "Services.h"
+#include "World.h"
 #include "EventBus.h"
+#include "Events.h"
+#include "Snapshot.h"
 #include <string>
 
 class HealthComponent : public BaseComponent {
@@ -19,34 +21,43 @@ public:
 
     // Apply damage with optional source
     void applyDamage(float amount, void* source = nullptr) {
+        applyHits(armorReduced(amount), 1, source);
+    }
+
+    // Damage left after armor for a single hit
+    float armorReduced(float amount) const {
+        return glm::max(0.0f, amount - armor);
+    }
+
+    // Apply already armor-reduced damage from several hits as one change
+    void applyHits(float total, int hits, void* source = nullptr) {
         if (!owner) return;
 
         if (health < 0) return;
+        if (total <= 0.0f) return;
 
-        float actual = glm::max(0.0f, amount - armor);
-        if (actual <= 0.0f) return;
+        health -= total;
 
-        health -= actual;
-
-        if (Services::eventBus) {
+        if (world) {
             DamageEvent e;
             e.target = owner;
-            e.amount = actual;
+            e.amount = total;
+            e.hits = hits;
             e.team = team;
 
-            Services::eventBus->emit<DamageEvent>(e);
+            world->eventBus->emit<DamageEvent>(e);
         }
 
         // Emit death event if health drops to zero
         if (health <= 0.0f) {
             health = 0.0f;
 
-            if (Services::eventBus) {
+            if (world) {
                 DeathEvent e;
                 e.target = owner;
                 e.team = team;
 
-                Services::eventBus->emit<DeathEvent>(e);
+                world->eventBus->emit<DeathEvent>(e);
             }
         }
     }
@@ -64,24 +75,36 @@ public:
         return health <= 0.0f;
     }
 
-    void respawn() {
+    // Back to full health; announce is off for ships only being made ready, like pool warm-up
+    void respawn(bool announce = true) {
         if (!owner) return;
 
         health = maxHealth;
 
-        if (Services::eventBus) {
+        if (announce && world) {
             RespawnEvent e;
             e.target = owner;
             e.team = team;
-            Services::eventBus->emit<RespawnEvent>(e);
+            world->eventBus->emit<RespawnEvent>(e);
         }
     }
 
     void setTeam(int t) { team = t; }
     void setMaxHealth(float maxHp) { maxHealth = maxHp; }
 
-    // Optional: override update if needed
-    void update(double dt) override {
-        // Could implement regen over time or other effects
+    void saveState(SnapshotWriter& out) const {
+        out.write(health);
+        out.write(maxHealth);
+        out.write(armor);
+        out.write(team);
+    }
+
+    void loadState(SnapshotReader& in) {
+        in.read(health);
+        in.read(maxHealth);
+        in.read(armor);
+        in.read(team);
     }
+
+    // No update: health only changes through damage/heal, so the scheduler skips it
 };
@@ -0,0 +1,296 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <vector>
+#include <fstream>
+#include <algorithm>
+#include "InputSystem.h"
+#include "Snapshot.h"
+
+// Binary input recordings: one record per input tick holding only what changed.
+//
+//   header   "V3IN" | u32 version | u64 world seed | u32 arena width, height
+//   tick     varint dt (microseconds) | varint change count | changes
+//   change   varint tag = index << 2 | kind, then for analog channels a zigzag varint delta
+//
+// Keys, mouse buttons and gamepad buttons toggle. Analog channels (mouse position,
+// gamepad axes) are quantized, and the recording side writes the quantized values
+// back so a live session and its replay see exactly the same input. The mouse is in
+// arena units, so a replay only matches the run it came from in an arena of the same size.
+
+namespace InputRecording {
+    constexpr char Magic[4] = { 'V', '3', 'I', 'N' };
+    constexpr uint32_t Version = 2;         // 1 had no arena and the mouse in window pixels
+    constexpr size_t HeaderSize = 24;
+
+    enum ChangeKind : uint32_t { Key = 0, MouseButton = 1, Analog = 2, GamepadButton = 3 };
+
+    constexpr int PadCount = 4;
+    constexpr int AxesPerPad = GLFW_GAMEPAD_AXIS_LAST;
+    constexpr int ButtonsPerPad = GLFW_GAMEPAD_BUTTON_LAST;
+    constexpr int MouseChannels = 2;
+    constexpr int AnalogChannels = MouseChannels + PadCount * AxesPerPad;
+
+    constexpr double MouseSteps = 16.0;     // 1/16 pixel
+    constexpr float AxisSteps = 32767.0f;
+
+    inline int64_t quantizeMouse(double v) { return static_cast<int64_t>(std::llround(v * MouseSteps)); }
+    inline int64_t quantizeAxis(float v) { return static_cast<int64_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * AxisSteps)); }
+    inline int64_t quantizeDt(double dt) { return static_cast<int64_t>(std::llround(std::max(0.0, dt) * 1e6)); }
+}
+
+
+// Read-only view of a whole file through the OS page cache (InputRecording.cpp)
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    bool open(const char* path);
+    void close();
+
+    const uint8_t* data() const { return bytes; }
+    size_t size() const { return length; }
+
+private:
+    const uint8_t* bytes = nullptr;
+    size_t length = 0;
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+};
+
+
+// Appends one tick at a time. The file stays replayable up to the last flushed tick.
+class InputRecorder {
+public:
+    ~InputRecorder() { close(); }
+
+    bool open(const char* path, uint64_t seed, uint32_t arenaWidth, uint32_t arenaHeight) {
+        close();
+        file.open(path, std::ios::binary | std::ios::trunc);
+        if (!file) return false;
+
+        uint8_t header[InputRecording::HeaderSize];
+        std::memcpy(header, InputRecording::Magic, 4);
+        writeLE(header + 4, InputRecording::Version, 4);
+        writeLE(header + 8, seed, 8);
+        writeLE(header + 16, arenaWidth, 4);
+        writeLE(header + 20, arenaHeight, 4);
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+        previous = RawInputData{};
+        std::fill(std::begin(analog), std::end(analog), 0);
+        buffer.clear();
+        buffer.reserve(FlushSize + 4096);
+        changes.reserve(1024);
+        ticks = 0;
+        written = sizeof(header);
+        return true;
+    }
+
+    void close() {
+        if (!file.is_open()) return;
+        flush();
+        file.close();
+    }
+
+    bool isOpen() const { return file.is_open(); }
+
+    // Quantizes raw in place and returns the quantized dt the sim should step with
+    double record(RawInputData& raw, double dt) {
+        using namespace InputRecording;
+
+        int64_t micros = quantizeDt(dt);
+        changes.clear();
+        uint32_t changeCount = 0;
+
+        for (int k = 0; k < GLFW_KEY_LAST; k++)
+            if (raw.keyDown[k] != previous.keyDown[k]) { writeVarint(changes, uint64_t(k) << 2 | Key); changeCount++; }
+
+        for (int b = 0; b < 8; b++)
+            if (raw.mouseDown[b] != previous.mouseDown[b]) { writeVarint(changes, uint64_t(b) << 2 | MouseButton); changeCount++; }
+
+        int64_t values[AnalogChannels];
+        values[0] = quantizeMouse(raw.mouseX);
+        values[1] = quantizeMouse(raw.mouseY);
+        for (int p = 0; p < PadCount; p++)
+            for (int a = 0; a < AxesPerPad; a++)
+                values[MouseChannels + p * AxesPerPad + a] = quantizeAxis(raw.gamepadAxes[p][a]);
+
+        for (int c = 0; c < AnalogChannels; c++) {
+            if (values[c] == analog[c]) continue;
+            writeVarint(changes, uint64_t(c) << 2 | Analog);
+            writeVarint(changes, zigzag(values[c] - analog[c]));
+            analog[c] = values[c];
+            changeCount++;
+        }
+
+        for (int p = 0; p < PadCount; p++)
+            for (int b = 0; b < ButtonsPerPad; b++)
+                if ((raw.gamepadButtons[p][b] != 0) != (previous.gamepadButtons[p][b] != 0)) {
+                    writeVarint(changes, uint64_t(p * ButtonsPerPad + b) << 2 | GamepadButton);
+                    changeCount++;
+                }
+
+        writeVarint(buffer, static_cast<uint64_t>(micros));
+        writeVarint(buffer, changeCount);
+        buffer.insert(buffer.end(), changes.begin(), changes.end());
+        if (buffer.size() >= FlushSize) flush();
+
+        // What the replay will reconstruct
+        raw.mouseX = analog[0] / MouseSteps;
+        raw.mouseY = analog[1] / MouseSteps;
+        for (int p = 0; p < PadCount; p++)
+            for (int a = 0; a < AxesPerPad; a++)
+                raw.gamepadAxes[p][a] = analog[MouseChannels + p * AxesPerPad + a] / AxisSteps;
+        for (int p = 0; p < PadCount; p++)
+            for (int b = 0; b < ButtonsPerPad; b++)
+                raw.gamepadButtons[p][b] = raw.gamepadButtons[p][b] ? 1 : 0;
+
+        previous = raw;
+        ticks++;
+        return micros / 1e6;
+    }
+
+    void flush() {
+        if (buffer.empty()) return;
+        file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+        file.flush();
+        written += buffer.size();
+        buffer.clear();
+    }
+
+    uint64_t tickCount() const { return ticks; }
+    uint64_t bytesWritten() const { return written + buffer.size(); }
+
+private:
+    static constexpr size_t FlushSize = 64 * 1024;
+
+    std::ofstream file;
+    std::vector<uint8_t> buffer;
+    std::vector<uint8_t> changes;
+    RawInputData previous;
+    int64_t analog[InputRecording::AnalogChannels] = {};
+    uint64_t ticks = 0;
+    uint64_t written = 0;
+
+    static void writeLE(uint8_t* out, uint64_t v, int bytes) {
+        for (int i = 0; i < bytes; i++)
+            out[i] = static_cast<uint8_t>(v >> (8 * i));
+    }
+};
+
+
+// Walks a recording tick by tick, straight out of the mapped file
+class InputReplayer {
+public:
+    bool open(const char* path) {
+        if (!file.open(path)) return false;
+        if (!openMemory(file.data(), file.size())) {
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    // Replay from bytes already in memory (the caller keeps them alive)
+    bool openMemory(const uint8_t* data, size_t size) {
+        using namespace InputRecording;
+        if (size < HeaderSize || std::memcmp(data, Magic, 4) != 0) return false;
+        if (readLE(data + 4, 4) != Version) return false;
+
+        seed = readLE(data + 8, 8);
+        width = static_cast<uint32_t>(readLE(data + 16, 4));
+        height = static_cast<uint32_t>(readLE(data + 20, 4));
+        cursor = data + HeaderSize;
+        end = data + size;
+        state = RawInputData{};
+        std::fill(std::begin(analog), std::end(analog), 0);
+        ticks = 0;
+        return true;
+    }
+
+    void close() {
+        file.close();
+        cursor = end = nullptr;
+    }
+
+    bool isOpen() const { return cursor != nullptr; }
+    bool finished() const { return cursor == end; }
+    uint64_t getSeed() const { return seed; }
+    uint32_t arenaWidth() const { return width; }
+    uint32_t arenaHeight() const { return height; }
+    uint64_t tickCount() const { return ticks; }
+
+    // Overwrites raw with the next tick. False at the end, or on a tick cut off mid-write.
+    bool next(RawInputData& raw, double& dt) {
+        using namespace InputRecording;
+        if (!cursor || cursor >= end) return false;
+
+        const uint8_t* p = cursor;
+        uint64_t micros, changeCount;
+        if (!readVarint(p, end, micros) || !readVarint(p, end, changeCount)) return false;
+
+        for (uint64_t i = 0; i < changeCount; i++) {
+            uint64_t tag;
+            if (!readVarint(p, end, tag)) return false;
+            uint64_t index = tag >> 2;
+
+            switch (tag & 3) {
+            case Key:
+                if (index >= GLFW_KEY_LAST) return false;
+                state.keyDown[index] = !state.keyDown[index];
+                break;
+            case MouseButton:
+                if (index >= 8) return false;
+                state.mouseDown[index] = !state.mouseDown[index];
+                break;
+            case Analog: {
+                uint64_t delta;
+                if (index >= AnalogChannels || !readVarint(p, end, delta)) return false;
+                analog[index] += unzigzag(delta);
+                break;
+            }
+            case GamepadButton: {
+                if (index >= PadCount * ButtonsPerPad) return false;
+                unsigned char& b = state.gamepadButtons[index / ButtonsPerPad][index % ButtonsPerPad];
+                b = b ? 0 : 1;
+                break;
+            }
+            }
+        }
+
+        state.mouseX = analog[0] / MouseSteps;
+        state.mouseY = analog[1] / MouseSteps;
+        for (int pad = 0; pad < PadCount; pad++)
+            for (int a = 0; a < AxesPerPad; a++)
+                state.gamepadAxes[pad][a] = analog[MouseChannels + pad * AxesPerPad + a] / AxisSteps;
+
+        raw = state;
+        dt = micros / 1e6;
+        cursor = p;
+        ticks++;
+        return true;
+    }
+
+private:
+    MappedFile file;
+    const uint8_t* cursor = nullptr;
+    const uint8_t* end = nullptr;
+    uint64_t seed = 0;
+    uint32_t width = 0, height = 0;
+    uint64_t ticks = 0;
+    RawInputData state;
+    int64_t analog[InputRecording::AnalogChannels] = {};
+
+    static uint64_t readLE(const uint8_t* in, int bytes) {
+        uint64_t v = 0;
+        for (int i = 0; i < bytes; i++)
+            v |= static_cast<uint64_t>(in[i]) << (8 * i);
+        return v;
+    }
+};
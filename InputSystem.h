@@ -1,6 +1,16 @@
 #pragma once
 #include <unordered_map>
+#include <vector>
+#include <array>
+#include <bitset>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <glm/glm.hpp>
 #include "GLFW/glfw3.h"    
+#include "GamepadSampler.h"
+
+using namespace glm;
 
 enum class Action {
     MoveHorizontal,
@@ -16,8 +26,11 @@ enum class Action {
 	QuaternaryAbility,
     Dash,
 
+    Count
 };
 
+constexpr size_t ActionCount = static_cast<size_t>(Action::Count);
+
 enum class DeviceType { Keyboard, Mouse, Gamepad };
 
 struct InputDevice {
@@ -109,43 +122,191 @@ struct InputBinding {
 
 
 
+// One binding after compile(): device already checked against the player,
+// only the fields the evaluation needs
+struct CompiledBinding {
+    enum class Source : uint8_t { Key, MouseButton, MouseAxis, GamepadButton, GamepadAxis };
+
+    Source source;
+    uint8_t pad = 0;        // gamepad index
+    int16_t code = 0;       // key, button or axis
+    float scale = 1.0f;
+    float offset = 0.0f;
+    float deadzone = 0.0f;
+
+    static bool compile(const InputBinding& b, CompiledBinding& out) {
+        out.scale = b.scale;
+        out.offset = b.offset;
+        out.deadzone = b.deadzone;
+
+        switch (b.device.type) {
+        case DeviceType::Keyboard:
+            if (b.code < 0 || b.code >= GLFW_KEY_LAST) return false;
+            out.source = Source::Key;
+            out.code = static_cast<int16_t>(b.code);
+            return true;
+        case DeviceType::Mouse:
+            if (b.axisCode == 0 || b.axisCode == 1) {
+                out.source = Source::MouseAxis;
+                out.code = static_cast<int16_t>(b.axisCode);
+                return true;
+            }
+            if (b.code < 0 || b.code >= 8) return false;
+            out.source = Source::MouseButton;
+            out.code = static_cast<int16_t>(b.code);
+            return true;
+        case DeviceType::Gamepad:
+            if (b.device.id < 0 || b.device.id >= 4) return false;
+            out.pad = static_cast<uint8_t>(b.device.id);
+            if (b.axisCode >= 0) {
+                out.source = Source::GamepadAxis;
+                out.code = static_cast<int16_t>(b.axisCode);
+                return true;
+            }
+            if (b.code < 0 || b.code >= GLFW_GAMEPAD_BUTTON_LAST) return false;
+            out.source = Source::GamepadButton;
+            out.code = static_cast<int16_t>(b.code);
+            return true;
+        }
+        return false;
+    }
+
+    // Raw value the binding reads, compared between updates to find what changed
+    float read(const RawInputData& raw) const {
+        switch (source) {
+        case Source::Key: return raw.keyDown[code] ? 1.0f : 0.0f;
+        case Source::MouseButton: return raw.mouseDown[code] ? 1.0f : 0.0f;
+        case Source::MouseAxis: return static_cast<float>(code == 0 ? raw.mouseX : raw.mouseY);
+        case Source::GamepadButton: return raw.gamepadButtons[pad][code];
+        case Source::GamepadAxis: return raw.gamepadAxes[pad][code];
+        }
+        return 0.0f;
+    }
+
+    bool sameSource(const CompiledBinding& other) const {
+        return source == other.source && pad == other.pad && code == other.code;
+    }
+
+    // Same results as InputBinding::matchesDigital / getAnalogValue
+    void evaluate(const RawInputData& raw, bool& digital, float& analog) const {
+        switch (source) {
+        case Source::Key:
+            if (raw.keyDown[code]) { digital = true; analog += scale + offset; }
+            else analog += offset;
+            break;
+        case Source::MouseButton:
+            if (raw.mouseDown[code]) digital = true;
+            analog += offset;
+            break;
+        case Source::MouseAxis:
+            analog += static_cast<float>(code == 0 ? raw.mouseX : raw.mouseY) * scale + offset;
+            break;
+        case Source::GamepadButton:
+            if (raw.gamepadButtons[pad][code]) digital = true;
+            analog += offset;
+            break;
+        case Source::GamepadAxis: {
+            float value = raw.gamepadAxes[pad][code];
+            if (std::abs(value) < deadzone) value = 0.0f;
+            else if (std::abs(value * scale + offset) > 0.5f) digital = true;
+            analog += value * scale + offset;
+            break;
+        }
+        }
+    }
+};
+
+
 class PlayerInput {
 public:
-    std::vector<InputDevice> devices;  // devices assigned to this player
+    // Setup; both mark the compiled table stale
+    void addDevice(const InputDevice& device) {
+        devices.push_back(device);
+        dirty = true;
+    }
 
-    // bindings: each action can have multiple bindings
-    std::unordered_map<Action, std::vector<InputBinding>> bindings;
+    void addBinding(Action action, const InputBinding& binding) {
+        bindings[index(action)].push_back(binding);
+        dirty = true;
+    }
 
-    // computed every frame
-    std::unordered_map<Action, bool> actionState;        // current frame
-    std::unordered_map<Action, bool> prevActionState;    // previous frame
-    std::unordered_map<Action, float> analogState;       // analog value for axes
+    void clearBindings() {
+        for (auto& list : bindings) list.clear();
+        dirty = true;
+    }
+
+    const std::vector<InputDevice>& getDevices() const { return devices; }
+    const std::vector<InputBinding>& getBindings(Action action) const { return bindings[index(action)]; }
+
+    // Whether any binding for the action survived compilation
+    bool hasBinding(Action action) {
+        if (dirty) compile();
+        return ranges[index(action) + 1] > ranges[index(action)];
+    }
+
+    // Flatten the bindings into one Action-ordered table, dropping the ones for
+    // devices this player doesn't own, and index them by the key, button or axis
+    // they read. Runs automatically after setup changes.
+    void compile() {
+        compiled.clear();
+        watched.clear();
+
+        for (size_t a = 0; a < ActionCount; a++) {
+            ranges[a] = static_cast<uint16_t>(compiled.size());
+            for (const auto& binding : bindings[a]) {
+                CompiledBinding c;
+                if (!playerHasDevice(binding.device) || !CompiledBinding::compile(binding, c)) continue;
+                compiled.push_back(c);
+                watch(c, a);
+            }
+        }
+        ranges[ActionCount] = static_cast<uint16_t>(compiled.size());
 
+        // Everything gets evaluated once against the next raw state
+        staleActions.set();
+        dirty = false;
+    }
+
+    // Only actions with a binding whose key, button or axis changed since the last
+    // update are evaluated again, the rest keep their state
     void update(const RawInputData& raw) {
-        prevActionState = actionState;
+        if (dirty) compile();
+
+        std::bitset<ActionCount> stale = staleActions;
+        staleActions.reset();
+        for (WatchedSource& w : watched) {
+            float value = w.binding.read(raw);
+            if (value == w.last) continue;
+            w.last = value;
+            stale |= w.actions;
+        }
 
-        for (auto& [action, bindingList] : bindings) {
+        // Double buffer: last frame's state stays readable for edge queries
+        current ^= 1;
+        auto& down = state[current];
+        down = state[current ^ 1];
+        evaluated = stale.count();
+        if (evaluated == 0) return;
+
+        for (size_t a = 0; a < ActionCount; a++) {
+            if (!stale[a]) continue;
             bool active = false;
             float analogValue = 0.0f;
 
-            for (auto& binding : bindingList) {
-                if (!playerHasDevice(binding.device)) continue;
-
-                if (binding.matchesDigital(raw)) {
-                    active = true;
-                }
-                analogValue += binding.getAnalogValue(raw);
-            }
+            for (uint16_t i = ranges[a]; i < ranges[a + 1]; i++)
+                compiled[i].evaluate(raw, active, analogValue);
 
-            actionState[action] = active;
-            analogState[action] = analogValue; // could be >1.0 if multiple sources; normalize if needed
+            down[a] = active;
+            analog[a] = analogValue; // could be >1.0 if multiple sources; normalize if needed
         }
     }
 
+    // Actions evaluated by the last update
+    size_t lastEvaluated() const { return evaluated; }
+
     // Digital queries
     bool isDown(Action action) const {
-        auto it = actionState.find(action);
-        return it != actionState.end() && it->second;
+        return state[current][index(action)];
     }
 
     bool isPressed(Action action) const {
@@ -158,8 +319,7 @@ public:
 
     // Analog query
     float getAnalog(Action action) const {
-        auto it = analogState.find(action);
-        return it != analogState.end() ? it->second : 0.0f;
+        return analog[index(action)];
     }
 
     vec2 getPosition(Action actionHorizontal, Action actionVertical) const {
@@ -167,9 +327,47 @@ public:
     }
 
 private:
+    std::vector<InputDevice> devices;  // devices assigned to this player
+
+    // bindings: each action can have multiple bindings
+    std::array<std::vector<InputBinding>, ActionCount> bindings;
+
+    // compiled table, bindings of action a are compiled[ranges[a] .. ranges[a + 1])
+    std::vector<CompiledBinding> compiled;
+    std::array<uint16_t, ActionCount + 1> ranges = {};
+    bool dirty = true;
+
+    // Every distinct key, button or axis the compiled bindings read, with the value
+    // seen last update and the actions bound to it
+    struct WatchedSource {
+        CompiledBinding binding;
+        float last;
+        std::bitset<ActionCount> actions;
+    };
+    std::vector<WatchedSource> watched;
+    std::bitset<ActionCount> staleActions;
+    size_t evaluated = 0;
+
+    // computed every frame
+    std::bitset<ActionCount> state[2];          // current and previous frame
+    int current = 0;
+    std::array<float, ActionCount> analog = {}; // analog value for axes
+
+    static size_t index(Action action) { return static_cast<size_t>(action); }
+
     bool prevIsDown(Action action) const {
-        auto it = prevActionState.find(action);
-        return it != prevActionState.end() && it->second;
+        return state[current ^ 1][index(action)];
+    }
+
+    void watch(const CompiledBinding& binding, size_t action) {
+        for (WatchedSource& w : watched) {
+            if (!w.binding.sameSource(binding)) continue;
+            w.actions.set(action);
+            return;
+        }
+        WatchedSource w{ binding, std::numeric_limits<float>::quiet_NaN(), {} };
+        w.actions.set(action);
+        watched.push_back(w);
     }
 
     bool playerHasDevice(const InputDevice& device) const {
@@ -181,44 +379,221 @@ private:
 };
 
 
+// Keyboard and mouse state built from GLFW callbacks instead of polling every key.
+// Events are queued as they arrive and folded into RawInputData once per update,
+// touching only the keys that changed.
+class KeyboardMouseEvents {
+public:
+    static constexpr int KeyCount = GLFW_KEY_LAST;
+    static constexpr int ButtonCount = 8;
+
+    KeyboardMouseEvents() {
+        for (auto* list : { &pendingKeyDown, &pendingKeyUp, &pendingButtonDown, &pendingButtonUp,
+                            &keysPressed, &keysReleased, &buttonsPressed, &buttonsReleased, &tapped })
+            list->reserve(32);
+    }
+
+    // Event entry points, called by the GLFW callbacks or fed synthetically
+    void onKey(int key, int action) {
+        if (key < 0 || key >= KeyCount) return;
+        if (action == GLFW_PRESS) { keys.set(key); pendingKeyDown.push_back(key); }
+        else if (action == GLFW_RELEASE) { keys.reset(key); pendingKeyUp.push_back(key); }
+    }
+
+    void onMouseButton(int button, int action) {
+        if (button < 0 || button >= ButtonCount) return;
+        if (action == GLFW_PRESS) { buttons.set(button); pendingButtonDown.push_back(button); }
+        else if (action == GLFW_RELEASE) { buttons.reset(button); pendingButtonUp.push_back(button); }
+    }
+
+    void onCursorPos(double x, double y) {
+        cursorX = x * cursorScaleX;
+        cursorY = y * cursorScaleY;
+    }
+
+    // Cursor positions are reported times this, e.g. to go from window pixels to the
+    // world's units so recorded input doesn't depend on the display
+    void setCursorScale(double x, double y) {
+        cursorX *= x / cursorScaleX;
+        cursorY *= y / cursorScaleY;
+        cursorScaleX = x;
+        cursorScaleY = y;
+    }
+
+    // Move the queued events into this tick's edge lists and update raw.
+    // A key pressed and released between two updates still reads as down
+    // for one tick, so short taps aren't lost.
+    void apply(RawInputData& raw) {
+        // Taps from the previous tick end now
+        for (int code : tapped) {
+            if (code < 0) raw.mouseDown[-code - 1] = buttons[-code - 1];
+            else raw.keyDown[code] = keys[code];
+        }
+        tapped.clear();
+
+        keysPressed.swap(pendingKeyDown);
+        keysReleased.swap(pendingKeyUp);
+        buttonsPressed.swap(pendingButtonDown);
+        buttonsReleased.swap(pendingButtonUp);
+        pendingKeyDown.clear();
+        pendingKeyUp.clear();
+        pendingButtonDown.clear();
+        pendingButtonUp.clear();
+
+        for (int key : keysPressed)
+            raw.keyDown[key] = true;
+        for (int key : keysReleased) {
+            if (keys[key]) continue;
+            if (raw.keyDown[key] && contains(keysPressed, key)) tapped.push_back(key);
+            else raw.keyDown[key] = false;
+        }
+
+        for (int button : buttonsPressed)
+            raw.mouseDown[button] = true;
+        for (int button : buttonsReleased) {
+            if (buttons[button]) continue;
+            if (raw.mouseDown[button] && contains(buttonsPressed, button)) tapped.push_back(-button - 1);
+            else raw.mouseDown[button] = false;
+        }
+
+        raw.mouseX = cursorX;
+        raw.mouseY = cursorY;
+    }
+
+    bool isKeyHeld(int key) const { return key >= 0 && key < KeyCount && keys[key]; }
+    bool wasKeyPressed(int key) const { return contains(keysPressed, key); }
+
+    // Edges seen during the last update
+    std::vector<int> keysPressed;
+    std::vector<int> keysReleased;
+    std::vector<int> buttonsPressed;
+    std::vector<int> buttonsReleased;
+
+private:
+    std::bitset<KeyCount> keys;
+    std::bitset<ButtonCount> buttons;
+    double cursorX = 0.0, cursorY = 0.0;
+    double cursorScaleX = 1.0, cursorScaleY = 1.0;
+
+    std::vector<int> pendingKeyDown, pendingKeyUp;
+    std::vector<int> pendingButtonDown, pendingButtonUp;
+    std::vector<int> tapped;    // keys (>= 0) and buttons (-button - 1) held down for one tick
+
+    static bool contains(const std::vector<int>& list, int value) {
+        for (int v : list)
+            if (v == value) return true;
+        return false;
+    }
+};
+
+
 class InputSystem {
 public:
     std::vector<InputDevice> devices;
     std::vector<PlayerInput> players;
 
-    RawInputData raw; // populated by polling GLFW
+    RawInputData raw; // keyboard/mouse from events, gamepads polled or sampled
+    KeyboardMouseEvents events;
+
+    // Every sample consumed this tick, per pad, oldest first: what the sampler delivered,
+    // or the one GLFW poll timed on glfwGetTime() for polled pads
+    std::array<std::vector<GamepadSample>, 4> gamepadSamples;
+
+    // Take gamepad state from a background sampler instead of polling GLFW once per frame.
+    // Pads the sampler isn't delivering are still polled through GLFW
+    void setGamepadSampler(GamepadSampler* newSampler) {
+        sampler = newSampler;
+        for (auto& samples : gamepadSamples) {
+            samples.clear();
+            samples.reserve(GamepadSampler::RingCapacity);
+        }
+    }
+
+    // Route this window's key, button and cursor callbacks into the event queue
+    void attach(GLFWwindow* window) {
+        active = this;
+
+        double x, y;
+        glfwGetCursorPos(window, &x, &y);
+        events.onCursorPos(x, y);
+
+        glfwSetKeyCallback(window, [](GLFWwindow*, int key, int, int action, int) {
+            if (active) active->events.onKey(key, action);
+            });
+        glfwSetMouseButtonCallback(window, [](GLFWwindow*, int button, int action, int) {
+            if (active) active->events.onMouseButton(button, action);
+            });
+        glfwSetCursorPosCallback(window, [](GLFWwindow*, double x, double y) {
+            if (active) active->events.onCursorPos(x, y);
+            });
+    }
 
+    // Call after glfwPollEvents
     void update() {
-        pollRawInput(); // fill raw with current input state
+        poll();
+        updatePlayers();
+    }
 
+    // Gather this tick's raw state without evaluating players, so it can be
+    // recorded or replaced (see InputRecording.h) before updatePlayers
+    void poll() {
+        events.apply(raw);
+        for (int i = 0; i < 4; ++i) {
+            sampledPads[i] = sampler && sampler->isSampling(i);
+            if (sampledPads[i]) consumeGamepadSamples(i);
+            else pollGamepad(i);
+        }
+    }
+
+    // Whether this tick's state of the pad came from the sampler
+    bool isSampled(int pad) const { return pad >= 0 && pad < 4 && sampledPads[pad]; }
+
+    // Evaluate every player against the current raw state
+    void updatePlayers() {
         for (PlayerInput& player : players)
             player.update(raw);
     }
 
 private:
-    void pollRawInput() {
-        // keyboard
-        for (int key = 0; key < GLFW_KEY_LAST; ++key)
-            raw.keyDown[key] = glfwGetKey(glfwGetCurrentContext(), key) == GLFW_PRESS;
+    inline static InputSystem* active = nullptr;
+    GamepadSampler* sampler = nullptr;
+    std::array<bool, 4> sampledPads = {};
+    std::array<uint32_t, 4> pollSequence = {};
+
+    // Players see the newest sample; the full list stays available for sub-frame consumers
+    void consumeGamepadSamples(int i) {
+        auto& samples = gamepadSamples[i];
+        samples.clear();
+        if (sampler->drain(i, samples) == 0) return;
+
+        const GLFWgamepadstate& state = samples.back().state;
+        for (int a = 0; a < GLFW_GAMEPAD_AXIS_LAST; ++a)
+            raw.gamepadAxes[i][a] = state.axes[a];
+
+        // A button that went down and up between two ticks is held for this one tick
+        for (int b = 0; b < GLFW_GAMEPAD_BUTTON_LAST; ++b) {
+            unsigned char down = state.buttons[b];
+            if (!down && !raw.gamepadButtons[i][b])
+                for (const GamepadSample& sample : samples)
+                    down |= sample.state.buttons[b];
+            raw.gamepadButtons[i][b] = down;
+        }
+    }
 
-        // mouse buttons
-        for (int i = 0; i < 8; ++i)
-            raw.mouseDown[i] = glfwGetMouseButton(glfwGetCurrentContext(), i) == GLFW_PRESS;
+    void pollGamepad(int i) {
+        gamepadSamples[i].clear();
+        if (!glfwJoystickIsGamepad(i)) return;
 
-        // mouse position
-        glfwGetCursorPos(glfwGetCurrentContext(), &raw.mouseX, &raw.mouseY);
+        GamepadSample sample;
+        if (glfwGetGamepadState(i, &sample.state)) {
+            for (int a = 0; a < GLFW_GAMEPAD_AXIS_LAST; ++a)
+                raw.gamepadAxes[i][a] = sample.state.axes[a];
+            for (int b = 0; b < GLFW_GAMEPAD_BUTTON_LAST; ++b)
+                raw.gamepadButtons[i][b] = sample.state.buttons[b];
 
-        // gamepads
-        for (int i = 0; i < 4; ++i) {
-            if (glfwJoystickIsGamepad(i)) {
-                GLFWgamepadstate state;
-                if (glfwGetGamepadState(i, &state)) {
-                    for (int a = 0; a < GLFW_GAMEPAD_AXIS_LAST; ++a)
-                        raw.gamepadAxes[i][a] = state.axes[a];
-                    for (int b = 0; b < GLFW_GAMEPAD_BUTTON_LAST; ++b)
-                        raw.gamepadButtons[i][b] = state.buttons[b];
-                }
-            }
+            sample.time = glfwGetTime();
+            sample.sequence = pollSequence[i]++;
+            gamepadSamples[i].push_back(sample);
         }
     }
 };
\ No newline at end of file
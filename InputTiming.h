@@ -0,0 +1,268 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include "GamepadSampler.h"
+
+
+// Fixed-range histogram updated one value at a time.
+// Values outside [low, high) land in the first or last bin, min/max stay exact.
+template <size_t Bins>
+class StreamingHistogram {
+public:
+    StreamingHistogram(double low, double high) : low(low), binWidth((high - low) / Bins) {}
+
+    void add(double value) {
+        double f = (value - low) / binWidth;
+        size_t bin = f <= 0.0 ? 0 : std::min(Bins - 1, static_cast<size_t>(f));
+        bins[bin]++;
+
+        n++;
+        sum += value;
+        sumSq += value * value;
+        minValue = n == 1 ? value : std::min(minValue, value);
+        maxValue = n == 1 ? value : std::max(maxValue, value);
+    }
+
+    void clear() {
+        bins.fill(0);
+        n = 0;
+        sum = sumSq = minValue = maxValue = 0.0;
+    }
+
+    uint64_t count() const { return n; }
+    double mean() const { return n ? sum / n : 0.0; }
+    double lowest() const { return minValue; }
+    double highest() const { return maxValue; }
+
+    double stddev() const {
+        if (n < 2) return 0.0;
+        double m = mean();
+        return std::sqrt(std::max(0.0, sumSq / n - m * m));
+    }
+
+    // Interpolated within the bin, p in 0..1
+    double percentile(double p) const {
+        if (n == 0) return 0.0;
+        double target = p * n;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < Bins; i++) {
+            if (seen + bins[i] >= target && bins[i] > 0) {
+                double inBin = (target - seen) / bins[i];
+                return std::clamp(binLow(i) + inBin * binWidth, minValue, maxValue);
+            }
+            seen += bins[i];
+        }
+        return maxValue;
+    }
+
+    size_t binCount() const { return Bins; }
+    uint64_t binValue(size_t i) const { return bins[i]; }
+    double binLow(size_t i) const { return low + i * binWidth; }
+    double binHigh(size_t i) const { return low + (i + 1) * binWidth; }
+
+private:
+    std::array<uint64_t, Bins> bins{};
+    double low, binWidth;
+    uint64_t n = 0;
+    double sum = 0.0, sumSq = 0.0;
+    double minValue = 0.0, maxValue = 0.0;
+};
+
+
+// Mean and spread of a stick while it is resting near the center
+struct StickNoise {
+    double rest = 0.15;     // raw magnitude below which the stick counts as untouched
+    uint64_t n = 0;
+    double meanX = 0.0, meanY = 0.0;
+    double m2X = 0.0, m2Y = 0.0;        // Welford accumulators
+    StreamingHistogram<50> magnitude{ 0.0, 0.15 };
+
+    void add(float x, float y) {
+        float mag = std::sqrt(x * x + y * y);
+        if (mag >= rest) return;
+
+        n++;
+        double dx = x - meanX;
+        meanX += dx / n;
+        m2X += dx * (x - meanX);
+        double dy = y - meanY;
+        meanY += dy / n;
+        m2Y += dy * (y - meanY);
+        magnitude.add(mag);
+    }
+
+    double stddevX() const { return n > 1 ? std::sqrt(m2X / (n - 1)) : 0.0; }
+    double stddevY() const { return n > 1 ? std::sqrt(m2Y / (n - 1)) : 0.0; }
+
+    void clear() {
+        n = 0;
+        meanX = meanY = m2X = m2Y = 0.0;
+        magnitude.clear();
+    }
+};
+
+
+// Timing of one pad's samples through the frame, all times on the clock the samples
+// were taken on (the sampler's, or glfwGetTime() for pads polled once per frame):
+//   poll interval     gap between consecutive samples
+//   change -> sim     a sample that differs from the previous one until the tick that consumes it
+//   change -> swap    the same change until the frame showing it is presented
+// Everything is updated in place, nothing allocates after construction.
+class InputTiming {
+public:
+    struct SampleRecord {
+        double sampleTime;
+        double consumeTime;
+        uint32_t sequence;
+        bool changed;
+    };
+
+    static constexpr size_t HistoryLength = 4096;   // recent samples kept for CSV export
+
+    StreamingHistogram<100> pollInterval{ 0.0, 0.005 };
+    StreamingHistogram<100> changeToSim{ 0.0, 0.050 };
+    StreamingHistogram<100> changeToSwap{ 0.0, 0.100 };
+    StickNoise leftNoise;
+    StickNoise rightNoise;
+
+    // Call after InputSystem::update with the samples it consumed for this pad
+    void onTick(const std::vector<GamepadSample>& samples, double now) {
+        auto start = Clock::now();
+
+        for (const GamepadSample& s : samples) {
+            if (hasPrevious) {
+                pollInterval.add(s.time - previous.time);
+                if (s.sequence != previous.sequence + 1) lostSamples += s.sequence - previous.sequence - 1;
+            }
+
+            bool changed = hasPrevious && stateChanged(previous.state, s.state);
+            if (changed) {
+                changeToSim.add(now - s.time);
+                if (!changePending) {
+                    changePending = true;
+                    pendingChangeTime = s.time;   // the oldest unseen change decides swap latency
+                }
+            }
+
+            const float* axes = s.state.axes;
+            leftNoise.add(axes[GLFW_GAMEPAD_AXIS_LEFT_X], axes[GLFW_GAMEPAD_AXIS_LEFT_Y]);
+            rightNoise.add(axes[GLFW_GAMEPAD_AXIS_RIGHT_X], axes[GLFW_GAMEPAD_AXIS_RIGHT_Y]);
+
+            history[historyHead] = SampleRecord{ s.time, now, s.sequence, changed };
+            historyHead = (historyHead + 1) % HistoryLength;
+            historyCount = std::min(historyCount + 1, HistoryLength);
+
+            previous = s;
+            hasPrevious = true;
+        }
+
+        overhead += std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Call right after glfwSwapBuffers
+    void onSwap(double now) {
+        if (changePending) {
+            changeToSwap.add(now - pendingChangeTime);
+            changePending = false;
+        }
+        if (frames++ > 0) frameSeconds += now - lastSwap;
+        lastSwap = now;
+    }
+
+    // Share of frame time spent in onTick
+    double overheadFraction() const { return frameSeconds > 0.0 ? overhead / frameSeconds : 0.0; }
+    uint64_t lostSampleCount() const { return lostSamples; }
+    uint64_t frameCount() const { return frames; }
+
+    void clear() {
+        pollInterval.clear();
+        changeToSim.clear();
+        changeToSwap.clear();
+        leftNoise.clear();
+        rightNoise.clear();
+        hasPrevious = changePending = false;
+        historyHead = historyCount = 0;
+        lostSamples = frames = 0;
+        overhead = frameSeconds = lastSwap = 0.0;
+    }
+
+    // Overlay text, one stat per line
+    void formatSummary(char* out, size_t size) const {
+        snprintf(out, size,
+            "poll   %.3f ms  sd %.3f  p99 %.3f  max %.3f\n"
+            "->sim  %.2f ms  p99 %.2f\n"
+            "->swap %.2f ms  p99 %.2f\n"
+            "rest L %.4f %.4f  R %.4f %.4f\n"
+            "lost %llu  cost %.3f%%",
+            pollInterval.mean() * 1e3, pollInterval.stddev() * 1e3, pollInterval.percentile(0.99) * 1e3, pollInterval.highest() * 1e3,
+            changeToSim.mean() * 1e3, changeToSim.percentile(0.99) * 1e3,
+            changeToSwap.mean() * 1e3, changeToSwap.percentile(0.99) * 1e3,
+            leftNoise.stddevX(), leftNoise.stddevY(), rightNoise.stddevX(), rightNoise.stddevY(),
+            static_cast<unsigned long long>(lostSamples), overheadFraction() * 100.0);
+    }
+
+    // Histograms, noise stats and the recent per-sample timestamps
+    bool writeCsv(const char* path) const {
+        std::ofstream f(path);
+        if (!f) return false;
+
+        f << std::fixed << std::setprecision(6);
+        f << "section,key,a,b,c\n";
+        writeHistogram(f, "poll_interval", pollInterval);
+        writeHistogram(f, "change_to_sim", changeToSim);
+        writeHistogram(f, "change_to_swap", changeToSwap);
+
+        f << "noise,left," << leftNoise.n << "," << leftNoise.stddevX() << "," << leftNoise.stddevY() << "\n";
+        f << "noise,right," << rightNoise.n << "," << rightNoise.stddevX() << "," << rightNoise.stddevY() << "\n";
+
+        size_t first = (historyHead + HistoryLength - historyCount) % HistoryLength;
+        for (size_t i = 0; i < historyCount; i++) {
+            const SampleRecord& r = history[(first + i) % HistoryLength];
+            f << "sample," << r.sequence << "," << r.sampleTime << "," << r.consumeTime << "," << (r.changed ? 1 : 0) << "\n";
+        }
+
+        return bool(f);
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    GamepadSample previous{};
+    bool hasPrevious = false;
+    bool changePending = false;
+    double pendingChangeTime = 0.0;
+    uint64_t lostSamples = 0;
+
+    std::array<SampleRecord, HistoryLength> history{};
+    size_t historyHead = 0;
+    size_t historyCount = 0;
+
+    uint64_t frames = 0;
+    double lastSwap = 0.0;
+    double frameSeconds = 0.0;
+    double overhead = 0.0;
+
+    // Buttons or a stick axis moving more than sensor noise
+    static bool stateChanged(const GLFWgamepadstate& a, const GLFWgamepadstate& b) {
+        for (int i = 0; i <= GLFW_GAMEPAD_BUTTON_LAST; i++)
+            if (a.buttons[i] != b.buttons[i]) return true;
+        for (int i = 0; i <= GLFW_GAMEPAD_AXIS_LAST; i++)
+            if (std::fabs(a.axes[i] - b.axes[i]) > 0.02f) return true;
+        return false;
+    }
+
+    template <size_t Bins>
+    static void writeHistogram(std::ofstream& f, const char* name, const StreamingHistogram<Bins>& h) {
+        f << name << ",summary," << h.count() << "," << h.mean() << "," << h.stddev() << "\n";
+        for (size_t i = 0; i < h.binCount(); i++)
+            if (h.binValue(i))
+                f << name << ",bin," << h.binLow(i) << "," << h.binHigh(i) << "," << h.binValue(i) << "\n";
+    }
+};
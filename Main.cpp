@@ -6,6 +6,7 @@
 #include <algorithm> // za max()
 #include <random>
 #include <iostream>
+#include <cstring>
 #include "Util.h"
 #include "SpriteRenderer.h"
 #include <glm/gtc/type_ptr.hpp>
@@ -28,15 +29,32 @@
 #include "PlayerController.h"
 
 #include "GamepadObject.h"
+#include "GamepadSampler.h"
+#include "InputTiming.h"
+#include "InputRecording.h"
+#include "WorldSnapshot.h"
+#include "Rollback.h"
+#include "SpectatorStream.h"
 #include "ship.h"
 #include "BindingGenerator.h"
 #include "CollisionSystem.h"
 #include "Guns.h"
 
 #include "SimpleShootingAi.h"
+#include "Director.h"
+#include "SwarmController.h"
+#include "Flocking.h"
+#include "WaveSpawner.h"
 #include "ShipFactory.h"
 
 #include "Services.h"
+#include "Random.h"
+#include "Registry.h"
+#include "World.h"
+#include "SystemScheduler.h"
+#include "DamageSystem.h"
+#include "Benchmark.h"
+#include "BatchRunner.h"
 
 using namespace glm;
 
@@ -47,13 +65,69 @@ int screenWidth = 800;
 int screenHeight = 800;
 
 bool debugWeapon = false;
+bool debugInput = false;    // draw the sampled stick trails
 bool debugDamage = false;
 
 
 
 
-int main()
+int main(int argc, char** argv)
 {
+    if (argc > 1 && std::string(argv[1]) == "--bench")
+        return Benchmark::run(argc, argv);
+    if (argc > 1 && std::string(argv[1]) == "--batch")
+        return BatchRunner::run(argc, argv);
+
+    // --record file writes every input tick, --replay file plays one back with its seed.
+    // --checksums file writes a world checksum per tick, or checks against it when replaying;
+    // it covers every ship, wave enemies included.
+    const char* recordPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* checksumPath = nullptr;
+
+    // Networked versus: --host port or --join host:port, the keyboard player drives
+    // ship 1 on the host and ship 2 on the joining side.
+    // --delay ticks of input delay, --rtt ms and --loss percent fake a bad connection.
+    // --session code: both players give the same one, peers with another code are ignored.
+    int hostPort = -1;
+    const char* joinAddress = nullptr;
+    std::string sessionCode;
+    RollbackConfig rollbackConfig;
+    double simulatedRtt = 0.0;
+    double simulatedLoss = 0.0;
+
+    // --spectate port streams the match to observers, wave enemies included
+    int spectatePort = -1;
+
+    // --waves file sends enemy waves from a wave table at player 2, local play only
+    const char* wavesPath = nullptr;
+
+    // --xinput 0,1 samples those pads through XInput at 1 kHz instead of polling GLFW
+    // once per frame (Windows only). XInput doesn't see DualShock, DualSense, Switch Pro
+    // or other HID pads, and its pad numbers only match GLFW's when the XInput pads are
+    // the first GLFW found; pads XInput doesn't report stay on GLFW polling.
+    unsigned xinputPads = 0;
+
+    for (int i = 1; i + 1 < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--record") recordPath = argv[++i];
+        else if (arg == "--replay") replayPath = argv[++i];
+        else if (arg == "--checksums") checksumPath = argv[++i];
+        else if (arg == "--host") hostPort = std::atoi(argv[++i]);
+        else if (arg == "--join") joinAddress = argv[++i];
+        else if (arg == "--delay") rollbackConfig.inputDelay = std::atoi(argv[++i]);
+        else if (arg == "--rtt") simulatedRtt = std::atof(argv[++i]) / 1000.0;
+        else if (arg == "--loss") simulatedLoss = std::atof(argv[++i]) / 100.0;
+        else if (arg == "--session") sessionCode = argv[++i];
+        else if (arg == "--spectate") spectatePort = std::atoi(argv[++i]);
+        else if (arg == "--waves") wavesPath = argv[++i];
+        else if (arg == "--xinput") {
+            for (const char* c = argv[++i]; *c; c++)
+                if (*c >= '0' && *c <= '3') xinputPads |= 1u << (*c - '0');
+        }
+    }
+    bool networked = hostPort >= 0 || joinAddress;
+
     // Inicijalizacija GLFW i postavljanje na verziju 3 sa programabilnim pajplajnom
     GLFWwindow* window = initGLFW();
 
@@ -86,7 +160,9 @@ int main()
 	unsigned int pulseShader = createShader("shaders/passthrough.vert", "shaders/pulse_effect.frag");
     unsigned int debugShader = createShader("shaders/color.vert", "shaders/color.frag");
 
-    glm::mat4 projection = glm::ortho(0.0f, (float)mode->width, 0.0f, (float)mode->height, -1.0f, 1.0f);
+    // The screen only shows the arena, the simulation never sees the monitor's size
+    const vec2 arena(World::ArenaWidth, World::ArenaHeight);
+    glm::mat4 projection = glm::ortho(0.0f, arena.x, 0.0f, arena.y, -1.0f, 1.0f);
     glUseProgram(rectShader);
     glUniformMatrix4fv(glGetUniformLocation(rectShader, "uProjection"), 1, GL_FALSE, glm::value_ptr(projection));
     glUseProgram(pulseShader);
@@ -113,7 +189,10 @@ int main()
 
     TextRenderer titleText;
     titleText.LoadFont("fonts/font.otf", 80, glm::vec3(0.8f, 0.5f, 0.1f)); // baked orange
-    titleText.position = vec2(mode->width * 0.22f, mode->height * 0.7f);
+    titleText.position = vec2(arena.x * 0.22f, arena.y * 0.7f);
+
+    TextRenderer timingText;
+    timingText.LoadFont("fonts/font.otf", 18, glm::vec3(0.6f, 0.9f, 0.6f));
 
     unsigned int signatureTexture = preprocessTexture("res/signature.png");
 
@@ -122,7 +201,6 @@ int main()
 
     PlayerInput playerInput;
     PlayerInput player2Input;
-    ShipFactory factory;
 
 
     InputDevice keyboard;
@@ -133,16 +211,60 @@ int main()
 	GamepadInput gamepadInput;
     
     
+    // Printed so a session can be replayed with the same seed
+    uint64_t worldSeed = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+
+    InputRecorder inputRecorder;
+    InputReplayer inputReplayer;
+    if (networked) {
+        // Both peers have to start from the same world
+        worldSeed = 0x5eedu;
+        recordPath = replayPath = checksumPath = nullptr;
+    }
+    else if (replayPath) {
+        if (!inputReplayer.open(replayPath)) {
+            printf("Couldn't open replay %s\n", replayPath);
+        }
+        else if (inputReplayer.arenaWidth() != arena.x || inputReplayer.arenaHeight() != arena.y) {
+            // It would play, but not the match that was recorded
+            printf("Replay %s was recorded in a %ux%u arena, this build simulates %.0fx%.0f\n", replayPath,
+                inputReplayer.arenaWidth(), inputReplayer.arenaHeight(), arena.x, arena.y);
+            inputReplayer.close();
+        }
+        else {
+            worldSeed = inputReplayer.getSeed();
+        }
+    }
+    else if (recordPath && !inputRecorder.open(recordPath, worldSeed, static_cast<uint32_t>(arena.x), static_cast<uint32_t>(arena.y))) {
+        printf("Couldn't open %s for recording\n", recordPath);
+    }
+    printf("World seed: %llu\n", static_cast<unsigned long long>(worldSeed));
+
+    // Everything the match simulates lives in this world, actors built from here on join it
+    World* world = new World(worldSeed);
+    World::makeCurrent(world);
+
     Services::init(
         new InputSystem,
-        new EventBus,
         new AssetManager,
 		new SoundManager,
         new EventHandler,
-		new ProjectileSystem,
-        new CollisionSystem
+        *world
     );
 
+    Services::inputSystem->attach(window);
+    Services::inputSystem->events.setCursorScale(arena.x / screenWidth, arena.y / screenHeight);
+
+    // Pads picked with --xinput are sampled at 1 kHz off the main thread, each tick
+    // consumes everything since the last one. The rest are polled through GLFW
+    GamepadSampler gamepadSampler;
+#ifdef _WIN32
+    if (xinputPads) {
+        gamepadSampler.start(std::make_unique<XInputGamepadSource>(), 1000.0, xinputPads);
+        Services::inputSystem->setGamepadSampler(&gamepadSampler);
+    }
+#endif
+
 
     // ----------------- new stuff -------------------
 
@@ -190,7 +312,7 @@ int main()
     };
 
 
-    bindKeyboardAndMouse(keyboard, mouse, playerInput, screenHeight);
+    bindKeyboardAndMouse(keyboard, mouse, playerInput, static_cast<int>(arena.y));
 
     bindGamepad(gamepad, player2Input);
 
@@ -208,7 +330,7 @@ int main()
 
     std::shared_ptr<Ship> playerShip = std::make_shared<Ship>();
     playerShip->spriteName = "ship";
-    playerShip->screenMax = vec2(screenWidth, screenHeight);
+    playerShip->setScreenBounds(vec2(0.0f), arena);
     playerShip->respawn(vec2(500, 500));
     playerShip->scale = vec2(50.0f);
 
@@ -217,7 +339,7 @@ int main()
     shipCollider->layer = CollisionLayer::Player;
     shipCollider->scale = vec2(0.8f);
     Services::collisions->addCollider(shipCollider);
-    playerShip->addChild(shipCollider);
+    playerShip->attachCollider(shipCollider);
 
     shipCollider->onCollisionEnter = [](Collider2D*) {
         std::cout << "Ship 1 collided with!\n";
@@ -239,7 +361,7 @@ int main()
 
     std::shared_ptr<Ship> player2Ship = std::make_shared<Ship>();
     player2Ship->spriteName = "ship";
-    player2Ship->screenMax = vec2(screenWidth, screenHeight);
+    player2Ship->setScreenBounds(vec2(0.0f), arena);
     player2Ship->respawn(vec2(500, 500));
     player2Ship->scale = vec2(50.0f);
 
@@ -248,7 +370,7 @@ int main()
     ship2Collider->layer = CollisionLayer::Player;
     ship2Collider->scale = vec2(0.8f);
     Services::collisions->addCollider(ship2Collider);
-    player2Ship->addChild(ship2Collider);
+    player2Ship->attachCollider(ship2Collider);
 
     // Create primary hardpoint and attach a weapon
     auto primaryHP2 = std::make_shared<Hardpoint>();
@@ -259,7 +381,7 @@ int main()
     // Add hardpoint to ship and bind to action
     player2Ship->addHardpoint(primaryHP2, 0);
 
-    auto enemyship = factory.spawnEnemy(vec2(1000, 700), 0);
+    auto enemyship = ShipFactory::spawnEnemy(*world, vec2(1000, 700), 0);
 
     PlayerController playerController(&Services::inputSystem->players[0]);
     PlayerController player2Controller(&Services::inputSystem->players[1]);
@@ -270,9 +392,78 @@ int main()
 	player2Controller.possess(player2Ship.get());
     aiController.possess(enemyship.get());
 
+    // AIs on screen think every tick, the director spreads the rest over ticks
+    Director director;
+    director.addOpponent(player2Ship.get());
+    director.addAI(&aiController);
+    director.setView(vec2(0.0f), arena);
+
+    WorldSnapshot worldState(*world);
+    worldState.track(playerShip.get());
+    worldState.track(player2Ship.get());
+    worldState.track(enemyship.get());
+
+    SpectatorServer spectators(*world);
+    double spectatorAccumulator = 0.0;
+    if (spectatePort >= 0) {
+        spectators.track(playerShip.get());
+        spectators.track(player2Ship.get());
+        spectators.track(enemyship.get());
+    }
+
+    // Wave enemies are flown together by one swarm controller, closing in on player 2
+    // along a field seeded from player 2 alone, and kept apart by a flock
+    std::unique_ptr<WaveSpawner> waves;
+    SwarmController swarm;
+    Flock flock;
+    std::unique_ptr<FlowField> toPlayer2;
+    std::vector<vec2> player2At(1);
+    if (wavesPath && !networked) {
+        WaveTable table;
+        std::string error;
+        if (WaveTable::load(wavesPath, table, error)) {
+            // Live wave ships are checksummed and streamed like the fixed ones
+            if (spectatePort >= 0) spectators.reserveDynamic(static_cast<size_t>(table.totalShips()));
+            waves = std::make_unique<WaveSpawner>(*world, std::move(table));
+            waves->onSpawn = [&](Ship& ship) {
+                swarm.add(&ship);
+                flock.add(&ship);
+                worldState.track(&ship);
+                if (spectatePort >= 0) spectators.addDynamic(&ship);
+            };
+            waves->onDespawn = [&](Ship& ship) {
+                swarm.remove(&ship);
+                flock.remove(&ship);
+                worldState.untrack(&ship);
+                if (spectatePort >= 0) spectators.removeDynamic(&ship);
+            };
+            waves->prewarm();
+            toPlayer2 = std::make_unique<FlowField>(vec2(0.0f), arena, 32.0f, 1);
+            director.setFlowField(player2Ship.get(), toPlayer2.get());
+        }
+        else {
+            printf("%s\n", error.c_str());
+        }
+    }
+
+    // Networked: the pools are filled up front so both peers hold the same objects
+    UdpSocket socket;
+    LinkConditioner link;
+    std::unique_ptr<RollbackSession> rollback;
+    PlayerController localSampler(&Services::inputSystem->players[0]);
+    PlayerController* shipControllers[2] = { &playerController, &player2Controller };
+    double rollbackAccumulator = 0.0;
+    bool desyncReported = false;
+
+    ChecksumTrace checksums;
+    if (checksumPath) {
+        bool opened = replayPath ? checksums.openVerify(checksumPath) : checksums.openWrite(checksumPath);
+        if (!opened) printf("Couldn't open checksums %s\n", checksumPath);
+    }
+
     std::shared_ptr<GamepadObject> gamepadVisualizer = std::make_shared<GamepadObject>();
     gamepadVisualizer->initHiearchy();
-    gamepadVisualizer->position = vec2(screenWidth / 2, screenHeight * 0.3);
+    gamepadVisualizer->position = vec2(arena.x / 2, arena.y * 0.3f);
 
     int framerateCap = 75;
     double frameInterval = 1.0f / framerateCap;
@@ -283,7 +474,7 @@ int main()
     // Somewhere in initialization, after the EventBus is ready:
     if (Services::eventBus) {
         Services::eventBus->subscribe<DamageEvent>([](const DamageEvent& e) {
-            printf("Damage dealt: %.2f to target %p (team %d)\n", e.amount, e.target, e.team);
+            printf("Damage dealt: %.2f in %d hits to target %p (team %d)\n", e.amount, e.hits, e.target, e.team);
             });
     }
 
@@ -297,6 +488,85 @@ int main()
 
     LineVisualizer line(vec2(0), vec2(0), vec3(255, 255, 0));
 
+    // F3 toggles the timing overlay, F5 writes input_timing.csv. Sampled pads are timed
+    // on the sampler clock, polled ones on glfwGetTime(); switching starts over
+    InputTiming inputTiming;
+    bool timingSampled = false;
+    auto timingClock = [&] { return timingSampled ? gamepadSampler.now() : glfwGetTime(); };
+    bool showInputTiming = false;
+    char timingSummary[512] = "";
+    double nextSummaryTime = 0.0;
+
+    SystemScheduler systems;
+    addGameplayPasses(systems);
+
+    // One simulation step, after the controllers have driven the ships
+    auto simulate = [&](double dt, bool presentEvents) {
+        if (toPlayer2) {
+            player2At[0] = player2Ship->getWorldPosition();
+            toPlayer2->rebuildIfNeeded(player2At);
+        }
+        director.update(dt);
+
+        if (waves) {
+            waves->update(dt);
+            for (size_t i = 0; i < swarm.size(); i++)
+                swarm.setTarget(i, player2Ship->getWorldPosition(), toPlayer2.get());
+            swarm.update();
+            for (auto& ship : waves->active())
+                ship->update(dt);
+            flock.update(dt);
+        }
+
+        playerShip->update(dt);
+        player2Ship->update(dt);
+        enemyship->update(dt);
+
+        systems.update(*Services::registry, dt);
+        Services::projectiles->update(dt);
+        Services::collisions->update();
+        Services::damage->flush(*Services::registry);
+
+        if (presentEvents)
+            Services::eventHandler->processEvents();
+        Services::eventBus->clear();
+    };
+
+    if (networked) {
+        Services::projectiles->prewarm(1024);
+        director.settings.farInterval = 1;      // AI state isn't rolled back
+
+        rollbackConfig.localPlayer = joinAddress ? 1 : 0;
+        rollbackConfig.sessionId = RollbackConfig::makeSessionId(sessionCode, worldSeed, arena.x, arena.y, rollbackConfig.tickSeconds);
+        localSampler.possess(rollbackConfig.localPlayer == 0 ? playerShip.get() : player2Ship.get());
+
+        link.latency = simulatedRtt / 2.0;
+        link.loss = simulatedLoss;
+        link.seed(rollbackConfig.localPlayer + 1);
+
+        bool connected = socket.open(joinAddress ? 0 : static_cast<uint16_t>(hostPort)) &&
+            (!joinAddress || socket.setPeer(joinAddress));
+        if (connected) {
+            rollback = std::make_unique<RollbackSession>(worldState, socket, link, rollbackConfig,
+                [&](const PlayerCommand (&commands)[2], bool resimulating) {
+                    for (int p = 0; p < 2; p++)
+                        shipControllers[p]->apply(commands[p]);
+                    simulate(rollbackConfig.tickSeconds, !resimulating);
+                });
+            printf("Versus on port %u as player %d, session %08x\n", socket.localPort(), rollbackConfig.localPlayer + 1, rollbackConfig.sessionId);
+        }
+        else {
+            printf("Couldn't set up the connection, playing locally\n");
+        }
+    }
+
+    if (spectatePort >= 0) {
+        if (spectators.open(static_cast<uint16_t>(spectatePort)))
+            printf("Spectators on port %u\n", spectators.localPort());
+        else
+            printf("Couldn't open spectator port %d\n", spectatePort);
+    }
+
     while (!glfwWindowShouldClose(window))
     {
         double time = glfwGetTime();
@@ -304,33 +574,65 @@ int main()
         lastTime = time;
 
 
-        Services::inputSystem->update();
-        
-		playerController.update(dt);
-		player2Controller.update(dt);
+        Services::inputSystem->poll();
+        if (inputRecorder.isOpen()) {
+            dt = inputRecorder.record(Services::inputSystem->raw, dt);
+        }
+        else if (inputReplayer.isOpen() && !inputReplayer.next(Services::inputSystem->raw, dt)) {
+            printf("Replay finished after %llu ticks\n", static_cast<unsigned long long>(inputReplayer.tickCount()));
+            inputReplayer.close();
+        }
+        Services::inputSystem->updatePlayers();
 
-		aiController.setTarget(player2Ship->getWorldPosition(), player2Ship->getVelocity());
-        //aiController.setTarget(enemyship->getWorldPosition(), enemyship->velocity);
-		aiController.update(dt);
+        if (Services::inputSystem->isSampled(gamepad.id) != timingSampled) {
+            timingSampled = !timingSampled;
+            inputTiming.clear();
+        }
+        inputTiming.onTick(Services::inputSystem->gamepadSamples[gamepad.id], timingClock());
 
-		//printf("Player 1 Pos: (%.2f, %.2f) Vel: (%.2f, %.2f)\n", playerShip->position.x, playerShip->position.y, playerShip->physics.velocity.x, playerShip->physics.velocity.y);
+        if (Services::inputSystem->events.wasKeyPressed(GLFW_KEY_F3))
+            showInputTiming = !showInputTiming;
+        if (Services::inputSystem->events.wasKeyPressed(GLFW_KEY_F5))
+            printf(inputTiming.writeCsv("input_timing.csv") ? "Wrote input_timing.csv\n" : "Couldn't write input_timing.csv\n");
         
-        playerShip->update(dt);
-        player2Ship->update(dt);
-        enemyship->update(dt);
-
-        Services::projectiles->update(dt);
+        if (rollback) {
+            // Fixed ticks, the local command is simulated on the tick it was sampled
+            rollbackAccumulator = std::min(rollbackAccumulator + dt, 0.25);
+            while (rollbackAccumulator >= rollbackConfig.tickSeconds) {
+                rollback->advance(localSampler.sample(), time);
+                rollbackAccumulator -= rollbackConfig.tickSeconds;
+            }
 
-        
-        gamepadInput.updateFromGLFW(gamepad.id);
-        gamepadVisualizer->updateFromInput(gamepadInput);
-        gamepadVisualizer->update(dt);
+            if (rollback->desyncTick() >= 0 && !desyncReported) {
+                printf("Desync with the other player at tick %lld\n", static_cast<long long>(rollback->desyncTick()));
+                desyncReported = true;
+            }
+        }
+        else {
+            playerController.update(dt);
+            player2Controller.update(dt);
+            simulate(dt, true);
 
-        Services::collisions->update();
+            if (checksums.isOpen() && !checksums.tick(worldState.checksum()))
+                printf("Simulation diverged from the recording at tick %lld\n", static_cast<long long>(checksums.firstDivergentTick()));
+        }
 
+        if (spectatePort >= 0) {
+            spectatorAccumulator = std::min(spectatorAccumulator + dt, 0.25);
+            if (spectatorAccumulator >= 1.0 / spectators.settings.sendRate) {
+                spectators.publish(time);
+                spectatorAccumulator -= 1.0 / spectators.settings.sendRate;
+            }
+        }
 
-        Services::eventHandler->processEvents();
-        Services::eventBus->clear();
+        if (Services::inputSystem->isSampled(gamepad.id)) {
+            gamepadVisualizer->updateFromSamples(Services::inputSystem->gamepadSamples[gamepad.id]);
+        }
+        else {
+            gamepadInput.updateFromGLFW(gamepad.id);
+            gamepadVisualizer->updateFromInput(gamepadInput);
+        }
+        gamepadVisualizer->update(dt);
 
         if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 			glfwSetWindowShouldClose(window, true);
@@ -352,7 +654,7 @@ int main()
 
             {
                 auto size = vec2(100, 100);
-                auto pos = vec2(screenWidth - 60, 60);
+                auto pos = vec2(arena.x - 60, 60);
                 spriteRenderer.Draw(signatureTexture, pos, size);
             }
             
@@ -363,12 +665,44 @@ int main()
 
             spriteRenderer.Draw(Services::assets->getTexture(enemyship->spriteName)->id, enemyship->getWorldMatrix());
 
+            if (waves) {
+                for (auto& ship : waves->active())
+                    spriteRenderer.Draw(Services::assets->getTexture(ship->spriteName)->id, ship->getWorldMatrix());
+            }
+
             Services::projectiles->render(spriteRenderer, *Services::assets);
             
+            if (debugInput) {
+                gamepadVisualizer->forEachTrailSegment([&](vec2 from, vec2 to) {
+                    line.start = from;
+                    line.end = to;
+                    line.Draw(debugShader, static_cast<int>(arena.x), static_cast<int>(arena.y));
+                    });
+            }
+
+            if (showInputTiming) {
+                // Text is rebuilt a few times a second, the stats themselves update every tick
+                if (renderTime >= nextSummaryTime) {
+                    inputTiming.formatSummary(timingSummary, sizeof(timingSummary));
+                    nextSummaryTime = renderTime + 0.25;
+                }
+
+                vec2 origin = gamepadVisualizer->position + vec2(300.0f, 100.0f);
+                const char* lineStart = timingSummary;
+                for (int row = 0; *lineStart; row++) {
+                    const char* lineEnd = strchr(lineStart, '\n');
+                    size_t length = lineEnd ? size_t(lineEnd - lineStart) : strlen(lineStart);
+
+                    timingText.position = origin - vec2(0.0f, row * 24.0f);
+                    timingText.DrawText(spriteRenderer, std::string(lineStart, length));
+                    lineStart += length + (lineEnd ? 1 : 0);
+                }
+            }
+
             if (debugWeapon) {
                 line.start = laserMinigun->getWorldPosition();
                 line.end = line.start + laserMinigun->forwardWorld() * 1000.0f;
-                line.Draw(debugShader, screenWidth, screenHeight);
+                line.Draw(debugShader, static_cast<int>(arena.x), static_cast<int>(arena.y));
             }
 
 
@@ -379,6 +713,7 @@ int main()
             
             //directionLine.Draw(colorShader, mode->width, mode->height);
             glfwSwapBuffers(window);
+            inputTiming.onSwap(timingClock());
 
             currentTime = glfwGetTime();
             renderTime = currentTime - renderTime;
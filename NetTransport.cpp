@@ -0,0 +1,179 @@
+#include "NetTransport.h"
+#include <cstring>
+#include <cstdlib>
+#include <string>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#pragma comment(lib, "Ws2_32.lib")
+
+namespace {
+    using SocketHandle = SOCKET;
+    int openSockets = 0;
+
+    bool startNetworking() {
+        if (openSockets++ > 0) return true;
+        WSADATA data;
+        if (WSAStartup(MAKEWORD(2, 2), &data) == 0) return true;
+        openSockets--;
+        return false;
+    }
+
+    void stopNetworking() {
+        if (--openSockets == 0) WSACleanup();
+    }
+
+    bool makeNonBlocking(SocketHandle s) {
+        u_long on = 1;
+        return ioctlsocket(s, FIONBIO, &on) == 0;
+    }
+
+    void closeSocket(SocketHandle s) { closesocket(s); }
+
+    // A send to a closed port comes back as a reset on the next receive
+    bool retryReceive() { return WSAGetLastError() == WSAECONNRESET; }
+}
+
+#else
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+
+namespace {
+    using SocketHandle = int;
+
+    bool startNetworking() { return true; }
+    void stopNetworking() {}
+
+    bool makeNonBlocking(SocketHandle s) {
+        int flags = fcntl(s, F_GETFL, 0);
+        return flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+    }
+
+    void closeSocket(SocketHandle s) { ::close(s); }
+
+    bool retryReceive() { return errno == EINTR || errno == ECONNREFUSED; }
+}
+#endif
+
+
+bool NetAddress::resolve(const char* host, uint16_t port, NetAddress& out) {
+    in_addr ip{};
+    if (inet_pton(AF_INET, host, &ip) != 1) {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* found = nullptr;
+        if (getaddrinfo(host, nullptr, &hints, &found) != 0 || !found) return false;
+        ip = reinterpret_cast<sockaddr_in*>(found->ai_addr)->sin_addr;
+        freeaddrinfo(found);
+    }
+
+    out.ip = ip.s_addr;
+    out.port = htons(port);
+    return true;
+}
+
+
+bool UdpSocket::open(uint16_t port) {
+    close();
+    if (!startNetworking()) return false;
+
+    SocketHandle s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == static_cast<SocketHandle>(InvalidHandle)) {
+        stopNetworking();
+        return false;
+    }
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+
+    socklen_t length = sizeof(address);
+    if (bind(s, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        !makeNonBlocking(s) ||
+        getsockname(s, reinterpret_cast<sockaddr*>(&address), &length) != 0) {
+        closeSocket(s);
+        stopNetworking();
+        return false;
+    }
+
+    handle = static_cast<intptr_t>(s);
+    boundPort = ntohs(address.sin_port);
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle == InvalidHandle) return;
+    closeSocket(static_cast<SocketHandle>(handle));
+    stopNetworking();
+    handle = InvalidHandle;
+    boundPort = 0;
+    peerAddress = NetAddress{};
+}
+
+bool UdpSocket::setPeer(const char* address) {
+    const char* colon = std::strrchr(address, ':');
+    if (!colon) return false;
+    std::string host(address, colon);
+    int port = std::atoi(colon + 1);
+    if (port <= 0 || port > 65535) return false;
+    return setPeer(host.c_str(), static_cast<uint16_t>(port));
+}
+
+bool UdpSocket::setPeer(const char* host, uint16_t port) {
+    return NetAddress::resolve(host, port, peerAddress);
+}
+
+bool UdpSocket::sendTo(const NetAddress& to, const uint8_t* data, size_t size) {
+    if (handle == InvalidHandle || !to.isValid()) return false;
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = to.ip;
+    address.sin_port = to.port;
+
+    auto sent = sendto(static_cast<SocketHandle>(handle), reinterpret_cast<const char*>(data), static_cast<int>(size), 0,
+        reinterpret_cast<sockaddr*>(&address), sizeof(address));
+    return sent == static_cast<decltype(sent)>(size);
+}
+
+int UdpSocket::receive(uint8_t* buffer, size_t capacity) {
+    NetAddress from;
+    int received;
+    while ((received = receiveFrom(buffer, capacity, from)) >= 0) {
+        if (!hasPeer())
+            peerAddress = from;
+        // Anyone else is ignored
+        if (from == peerAddress)
+            return received;
+    }
+    return -1;
+}
+
+int UdpSocket::receiveFrom(uint8_t* buffer, size_t capacity, NetAddress& from) {
+    if (handle == InvalidHandle) return -1;
+
+    for (;;) {
+        sockaddr_in address{};
+        socklen_t length = sizeof(address);
+        auto received = recvfrom(static_cast<SocketHandle>(handle), reinterpret_cast<char*>(buffer), static_cast<int>(capacity), 0,
+            reinterpret_cast<sockaddr*>(&address), &length);
+        if (received < 0) {
+            if (retryReceive()) continue;
+            return -1;
+        }
+
+        from.ip = address.sin_addr.s_addr;
+        from.port = address.sin_port;
+        return static_cast<int>(received);
+    }
+}
@@ -0,0 +1,136 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include "Random.h"
+
+// IPv4 address and port, both in network byte order
+struct NetAddress {
+    uint32_t ip = 0;
+    uint16_t port = 0;
+
+    bool isValid() const { return port != 0; }
+    bool operator==(const NetAddress& other) const { return ip == other.ip && port == other.port; }
+
+    // host as a dotted IPv4 address or a name (NetTransport.cpp)
+    static bool resolve(const char* host, uint16_t port, NetAddress& out);
+};
+
+
+// Non-blocking UDP endpoint (NetTransport.cpp). send/receive talk to a single peer;
+// without setPeer the first sender becomes the peer, which is how the host side works.
+// sendTo/receiveFrom serve any number of peers from one port.
+class UdpSocket {
+public:
+    UdpSocket() = default;
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+    ~UdpSocket() { close(); }
+
+    // port 0 picks a free one
+    bool open(uint16_t port);
+    void close();
+
+    // "host:port", the host as a dotted IPv4 address or a name
+    bool setPeer(const char* address);
+    bool setPeer(const char* host, uint16_t port);
+
+    bool send(const uint8_t* data, size_t size) { return sendTo(peerAddress, data, size); }
+    bool sendTo(const NetAddress& to, const uint8_t* data, size_t size);
+
+    // Size of the next datagram from the peer, -1 when nothing is waiting
+    int receive(uint8_t* buffer, size_t capacity);
+
+    // Next datagram from anyone
+    int receiveFrom(uint8_t* buffer, size_t capacity, NetAddress& from);
+
+    bool isOpen() const { return handle != InvalidHandle; }
+    bool hasPeer() const { return peerAddress.isValid(); }
+    const NetAddress& peer() const { return peerAddress; }
+    uint16_t localPort() const { return boundPort; }
+
+private:
+    static constexpr intptr_t InvalidHandle = -1;
+
+    intptr_t handle = InvalidHandle;
+    uint16_t boundPort = 0;
+    NetAddress peerAddress;
+};
+
+
+// Holds back outgoing packets to fake a real connection on localhost:
+// one-way latency plus uniform jitter, and random loss. Jitter can reorder packets.
+// Use one on each side, the round trip is twice the latency.
+class LinkConditioner {
+public:
+    double latency = 0.0;   // seconds, one way
+    double jitter = 0.0;    // +- seconds
+    double loss = 0.0;      // chance 0..1 that a packet is dropped
+
+    void seed(uint64_t value) { rng.seed(value, 7); }
+    bool isActive() const { return latency > 0.0 || jitter > 0.0 || loss > 0.0; }
+
+    void send(UdpSocket& socket, const uint8_t* data, size_t size, double now) {
+        sendTo(socket, NetAddress{}, data, size, now);
+    }
+
+    // An invalid address sends to whoever is the socket's peer when the packet goes out
+    void sendTo(UdpSocket& socket, const NetAddress& to, const uint8_t* data, size_t size, double now) {
+        sentCount++;
+        if (!isActive()) {
+            transmit(socket, to, data, size);
+            return;
+        }
+        if (loss > 0.0 && rng.nextOpenDouble() < loss) {
+            droppedCount++;
+            return;
+        }
+
+        double delay = latency + (rng.nextOpenDouble() * 2.0 - 1.0) * jitter;
+        Packet& packet = queueSlot();
+        packet.due = now + (delay > 0.0 ? delay : 0.0);
+        packet.to = to;
+        packet.bytes.assign(data, data + size);
+    }
+
+    // Sends every held packet that is due
+    void flush(UdpSocket& socket, double now) {
+        for (size_t i = 0; i < pendingCount;) {
+            if (queue[i].due > now) {
+                i++;
+                continue;
+            }
+            transmit(socket, queue[i].to, queue[i].bytes.data(), queue[i].bytes.size());
+            std::swap(queue[i], queue[--pendingCount]);
+        }
+    }
+
+    uint64_t sent() const { return sentCount; }
+    uint64_t dropped() const { return droppedCount; }
+    size_t pending() const { return pendingCount; }
+
+private:
+    struct Packet {
+        double due = 0.0;
+        NetAddress to;
+        std::vector<uint8_t> bytes;
+    };
+
+    // Slots past pendingCount keep their byte buffers for reuse
+    std::vector<Packet> queue;
+    size_t pendingCount = 0;
+    Pcg32 rng{ 0x1a7e, 7 };
+    uint64_t sentCount = 0;
+    uint64_t droppedCount = 0;
+
+    static void transmit(UdpSocket& socket, const NetAddress& to, const uint8_t* data, size_t size) {
+        if (to.isValid()) socket.sendTo(to, data, size);
+        else socket.send(data, size);
+    }
+
+    Packet& queueSlot() {
+        if (pendingCount == queue.size())
+            queue.emplace_back();
+        return queue[pendingCount++];
+    }
+};
@@ -8,7 +8,7 @@ public:
 
 
     // Physics component handles mass, forces, friction, torque, etc.
-    std::shared_ptr<PhysicsComponent> physics;
+    ComponentRef<PhysicsComponent> physics;
 
     PhysicalActor2D() {
 		physics = addComponent<PhysicsComponent>();
@@ -39,11 +39,22 @@ public:
         physics->reset();
     }
 
-    void update(double dt) override {
-        physics->update(dt);
-	}
+    // Takes the actor out of the physics passes until resumePhysics, settings are kept
+    void suspendPhysics() {
+        if (!physics) return;
+        suspendedPhysics = *physics;
+        removeComponent<PhysicsComponent>();
+    }
+
+    void resumePhysics() {
+        if (physics) return;
+        addComponent<PhysicsComponent>(suspendedPhysics);
+    }
 
     // Convenience getters
     glm::vec2 getVelocity() const { return physics->velocity; }
     float getAngularVelocity() const { return physics->angularVelocity; }
+
+private:
+    PhysicsComponent suspendedPhysics;
 };
\ No newline at end of file
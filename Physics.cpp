@@ -18,6 +18,7 @@ void PhysicsComponent::update(double dt) {
     Actor2D& actor = static_cast<Actor2D&>(*owner);
     actor.position += velocity * static_cast<float>(dt);
     actor.rotation += angularVelocity * static_cast<float>(dt);
+    actor.markDirty();
 
     if (isKinematic) return;
 
@@ -47,3 +48,27 @@ void PhysicsComponent::reset() {
     velocity = glm::vec2(0.0f);
     angularVelocity = 0.0f;
 }
+
+void ScreenBoundsComponent::apply(PhysicsComponent& physics) {
+    if (min == max) return;
+
+    Actor2D& actor = static_cast<Actor2D&>(*owner);
+    glm::vec2& position = actor.position;
+    glm::vec2 velocity = physics.velocity;
+    float angularVelocity = physics.angularVelocity;
+
+    // X-axis
+    if (position.x < min.x) { position.x = min.x;
+        if (velocity.x < 0.0f) { velocity.x = -velocity.x * restitution; angularVelocity += velocity.y * spinFactor; } }
+    else if (position.x > max.x) { position.x = max.x;
+        if (velocity.x > 0.0f) { velocity.x = -velocity.x * restitution; angularVelocity -= velocity.y * spinFactor; } }
+
+    // Y-axis
+    if (position.y < min.y) { position.y = min.y;
+        if (velocity.y < 0.0f) { velocity.y = -velocity.y * restitution; angularVelocity -= velocity.x * spinFactor; } }
+    else if (position.y > max.y) { position.y = max.y;
+        if (velocity.y > 0.0f) { velocity.y = -velocity.y * restitution; angularVelocity += velocity.x * spinFactor; } }
+
+    physics.velocity = velocity;
+    physics.angularVelocity = angularVelocity;
+}
@@ -1,6 +1,7 @@
 #pragma once
 #include "glm/glm.hpp"
 #include "BaseComponent.h"
+#include "Snapshot.h"
 
 
 class PhysicalActor2D;
@@ -49,4 +50,40 @@ public:
     void applyImpulse(const glm::vec2& impulse);
     void applyAngularImpulse(float impulse);
     void reset();
+
+    void saveState(SnapshotWriter& out) const {
+        out.write(mass);
+        out.write(friction);
+        out.write(angularFriction);
+        out.write(isKinematic);
+        out.write(velocity);
+        out.write(angularVelocity);
+    }
+
+    void loadState(SnapshotReader& in) {
+        in.read(mass);
+        in.read(friction);
+        in.read(angularFriction);
+        in.read(isKinematic);
+        in.read(velocity);
+        in.read(angularVelocity);
+    }
+};
+
+
+// Keeps the owner inside a rectangle, bouncing off the edges.
+// Has no update of its own, it runs as a PhysicsComponent + ScreenBoundsComponent pass.
+class ScreenBoundsComponent : public BaseComponent {
+public:
+    glm::vec2 min{ 0.0f };
+    glm::vec2 max{ 0.0f };
+    float restitution = 0.5f;
+    float spinFactor = 0.3f;
+
+    ScreenBoundsComponent() = default;
+    ScreenBoundsComponent(glm::vec2 min, glm::vec2 max, float restitution, float spinFactor)
+        : min(min), max(max), restitution(restitution), spinFactor(spinFactor) {
+    }
+
+    void apply(PhysicsComponent& physics);
 };
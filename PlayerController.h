@@ -4,6 +4,39 @@
 #include "Actor.h"
 #include "PhysicalActor2D.h"
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+// One player's input for one tick, quantized so every peer of a networked match
+// applies exactly the same values to the pawn
+struct PlayerCommand {
+    static constexpr float Steps = 32767.0f;
+    static constexpr int AbilityCount = 4;
+    static constexpr uint8_t DashBit = 1 << AbilityCount;
+
+    int16_t moveX = 0, moveY = 0;
+    int16_t aimX = 0, aimY = 0;
+    uint8_t buttons = 0;    // bit i: ability i, then dash
+
+    static int16_t quantize(float v) {
+        return static_cast<int16_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * Steps));
+    }
+
+    void setMove(glm::vec2 v) { moveX = quantize(v.x); moveY = quantize(v.y); }
+    void setAim(glm::vec2 v) { aimX = quantize(v.x); aimY = quantize(v.y); }
+    glm::vec2 move() const { return glm::vec2(moveX, moveY) / Steps; }
+    glm::vec2 aim() const { return glm::vec2(aimX, aimY) / Steps; }
+
+    void setButton(int bit, bool down) { if (down) buttons |= uint8_t(1 << bit); }
+    bool ability(int index) const { return buttons & (1 << index); }
+    bool dash() const { return buttons & DashBit; }
+
+    bool operator==(const PlayerCommand& other) const {
+        return moveX == other.moveX && moveY == other.moveY &&
+            aimX == other.aimX && aimY == other.aimY && buttons == other.buttons;
+    }
+};
 
 class PlayerController {
     IControllable* pawn = nullptr;
@@ -29,27 +62,43 @@ public:
 
     void update(double dt) {
         if (!pawn || !input) return;
+        apply(sample());
+    }
+
+    // Read this tick's input. A bound mouse aims from the pawn toward the cursor.
+    PlayerCommand sample() const {
+        PlayerCommand command;
+        if (!input) return command;
 
-        // Movement
-        pawn->setMoveDirection(input->getPosition(Action::MoveHorizontal, Action::MoveVertical));
+        command.setMove(input->getPosition(Action::MoveHorizontal, Action::MoveVertical));
+
+        glm::vec2 aim = input->getPosition(Action::AimHorizontal, Action::AimVertical);
+        if (input->hasBinding(Action::MousePositionHorizontal) ||
+            input->hasBinding(Action::MousePositionVertical)) {
+            glm::vec2 toCursor = input->getPosition(Action::MousePositionHorizontal, Action::MousePositionVertical) - pawnPosition();
+            aim = glm::length(toCursor) > 0.05f ? glm::normalize(toCursor) : glm::vec2(0.0f);
+        }
+        command.setAim(aim);
+
+        command.setButton(0, input->isDown(Action::PrimaryAbility));
+        command.setButton(1, input->isDown(Action::SecondaryAbility));
+        command.setButton(2, input->isDown(Action::TertiaryAbility));
+        command.setButton(3, input->isDown(Action::QuaternaryAbility));
+        command.setButton(PlayerCommand::AbilityCount, input->isDown(Action::Dash));
+        return command;
+    }
 
-        // Aim
-        pawn->setAimDirection(input->getPosition(Action::AimHorizontal, Action::AimVertical));
+    // Drive the pawn from a command, local or received from a peer
+    void apply(const PlayerCommand& command) {
+        if (!pawn) return;
 
-        if (input->bindings.find(Action::MousePositionHorizontal) != input->bindings.end() ||
-            input->bindings.find(Action::MousePositionVertical) != input->bindings.end()) {
-            // If mouse position is bound, use it for aiming
-            glm::vec2 pawnPos = pawnPosition();
-			pawn->setAimDirection(input->getPosition(Action::MousePositionHorizontal, Action::MousePositionVertical) - pawnPos);
-		}
+        pawn->setMoveDirection(command.move());
+        pawn->setAimDirection(command.aim());
 
-		pawn->useAbility(0, input->isDown(Action::PrimaryAbility));
-		pawn->useAbility(1, input->isDown(Action::SecondaryAbility));
-		pawn->useAbility(2, input->isDown(Action::TertiaryAbility));
-		pawn->useAbility(3, input->isDown(Action::QuaternaryAbility));
+        for (int i = 0; i < PlayerCommand::AbilityCount; i++)
+            pawn->useAbility(i, command.ability(i));
 
-        // Dash
-        pawn->dash(input->isDown(Action::Dash));
+        pawn->dash(command.dash());
     }
 
     glm::vec2 pawnPosition() const {
@@ -0,0 +1,134 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <glm/glm.hpp>
+
+// Uniform grid over a set of points, rebuilt whenever the points move.
+// Cells are sized for about one point each, or as asked for radius queries,
+// points are stored cell by cell.
+class PointGrid {
+public:
+    // cellSize 0 sizes cells for about one point each
+    void build(const std::vector<glm::vec2>& points, float wantedCellSize = 0.0f) {
+        cellStart.clear();
+        cellItems.clear();
+        if (points.empty()) return;
+
+        origin = points[0];
+        glm::vec2 max = points[0];
+        for (const glm::vec2& p : points) {
+            origin = glm::min(origin, p);
+            max = glm::max(max, p);
+        }
+
+        glm::vec2 extent = glm::max(max - origin, glm::vec2(1.0f));
+        cellSize = wantedCellSize > 0.0f ? wantedCellSize : std::max(1.0f, std::sqrt(extent.x * extent.y / points.size()));
+        columns = std::clamp(static_cast<int>(extent.x / cellSize) + 1, 1, MaxCells);
+        rows = std::clamp(static_cast<int>(extent.y / cellSize) + 1, 1, MaxCells);
+        cellSize = std::max(extent.x / columns, extent.y / rows) * 1.0001f;
+
+        // Counting sort into cells
+        cellStart.assign(columns * rows + 1, 0);
+        cellOf.resize(points.size());
+        for (size_t i = 0; i < points.size(); i++) {
+            cellOf[i] = cellIndex(cellX(points[i].x), cellY(points[i].y));
+            cellStart[cellOf[i] + 1]++;
+        }
+        for (size_t c = 1; c < cellStart.size(); c++)
+            cellStart[c] += cellStart[c - 1];
+
+        cellItems.resize(points.size());
+        cellPoints.resize(points.size());
+        fill.assign(cellStart.begin(), cellStart.end() - 1);
+        for (size_t i = 0; i < points.size(); i++) {
+            int slot = fill[cellOf[i]]++;
+            cellItems[slot] = static_cast<int>(i);
+            cellPoints[slot] = points[i];
+        }
+    }
+
+    // Up to k nearest points to p, nearest first. Returns how many were found.
+    int nearest(glm::vec2 p, int k, int* outIndex, float* outDistSqr) const {
+        if (cellItems.empty() || k <= 0) return 0;
+
+        int cx = cellX(p.x), cy = cellY(p.y);
+        int found = 0;
+        int maxRing = std::max({ cx, columns - 1 - cx, cy, rows - 1 - cy });
+
+        for (int ring = 0; ring <= maxRing; ring++) {
+            int x0 = std::max(cx - ring, 0), x1 = std::min(cx + ring, columns - 1);
+            for (int y = std::max(cy - ring, 0); y <= std::min(cy + ring, rows - 1); y++) {
+                if (y == cy - ring || y == cy + ring) {
+                    // Top and bottom rows of the ring are contiguous in memory
+                    visitCells(cellIndex(x0, y), cellIndex(x1, y), p, k, found, outIndex, outDistSqr);
+                }
+                else {
+                    if (cx - ring >= 0) visitCells(cellIndex(cx - ring, y), cellIndex(cx - ring, y), p, k, found, outIndex, outDistSqr);
+                    if (cx + ring < columns) visitCells(cellIndex(cx + ring, y), cellIndex(cx + ring, y), p, k, found, outIndex, outDistSqr);
+                }
+            }
+
+            // Anything not visited yet lies past the nearest edge of this block
+            // that still has cells beyond it
+            if (found == k) {
+                float reach = std::numeric_limits<float>::max();
+                if (cx - ring > 0) reach = std::min(reach, p.x - (origin.x + (cx - ring) * cellSize));
+                if (cx + ring < columns - 1) reach = std::min(reach, origin.x + (cx + ring + 1) * cellSize - p.x);
+                if (cy - ring > 0) reach = std::min(reach, p.y - (origin.y + (cy - ring) * cellSize));
+                if (cy + ring < rows - 1) reach = std::min(reach, origin.y + (cy + ring + 1) * cellSize - p.y);
+                if (outDistSqr[k - 1] <= reach * reach) break;
+            }
+        }
+        return found;
+    }
+
+    // fn(index, distSqr) for every point within radius of p, cell by cell
+    template <typename Fn>
+    void forEachWithin(glm::vec2 p, float radius, Fn&& fn) const {
+        if (cellItems.empty()) return;
+
+        int x0 = cellX(p.x - radius), x1 = cellX(p.x + radius);
+        float radiusSqr = radius * radius;
+        for (int y = cellY(p.y - radius); y <= cellY(p.y + radius); y++) {
+            for (int i = cellStart[cellIndex(x0, y)]; i < cellStart[cellIndex(x1, y) + 1]; i++) {
+                glm::vec2 d = cellPoints[i] - p;
+                float distSqr = glm::dot(d, d);
+                if (distSqr <= radiusSqr) fn(cellItems[i], distSqr);
+            }
+        }
+    }
+
+private:
+    static constexpr int MaxCells = 256;
+
+    glm::vec2 origin = glm::vec2(0.0f);
+    float cellSize = 1.0f;
+    int columns = 0, rows = 0;
+    std::vector<int> cellStart, cellItems, cellOf, fill;
+    std::vector<glm::vec2> cellPoints;      // points in cell order
+
+    int cellX(float x) const { return std::clamp(static_cast<int>((x - origin.x) / cellSize), 0, columns - 1); }
+    int cellY(float y) const { return std::clamp(static_cast<int>((y - origin.y) / cellSize), 0, rows - 1); }
+    int cellIndex(int x, int y) const { return y * columns + x; }
+
+    // Points of cells first..last (same row), inserted into the sorted k best
+    void visitCells(int first, int last, glm::vec2 p, int k, int& found, int* outIndex, float* outDistSqr) const {
+        for (int i = cellStart[first]; i < cellStart[last + 1]; i++) {
+            glm::vec2 d = cellPoints[i] - p;
+            float distSqr = glm::dot(d, d);
+            if (found == k && distSqr >= outDistSqr[k - 1]) continue;
+            int item = cellItems[i];
+
+            int slot = found < k ? found++ : k - 1;
+            while (slot > 0 && outDistSqr[slot - 1] > distSqr) {
+                outDistSqr[slot] = outDistSqr[slot - 1];
+                outIndex[slot] = outIndex[slot - 1];
+                slot--;
+            }
+            outDistSqr[slot] = distSqr;
+            outIndex[slot] = item;
+        }
+    }
+};
@@ -0,0 +1,179 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <new>
+
+
+// Fixed-size block allocator backed by chunks that are never returned to the heap.
+// The block size is taken from the first allocation, which for allocate_shared is
+// the combined control block + object.
+class BlockArena {
+public:
+    explicit BlockArena(size_t blocksPerChunk = 64) : blocksPerChunk(blocksPerChunk) {}
+
+    BlockArena(const BlockArena&) = delete;
+    BlockArena& operator=(const BlockArena&) = delete;
+
+    ~BlockArena() {
+        for (void* chunk : chunks)
+            ::operator delete(chunk);
+    }
+
+    void* allocate(size_t size, size_t alignment) {
+        if (blockSize == 0)
+            blockSize = roundUp(size < sizeof(FreeBlock) ? sizeof(FreeBlock) : size);
+
+        // Anything that doesn't fit a block goes to the heap
+        if (alignment > alignof(std::max_align_t))
+            return ::operator new(size, std::align_val_t(alignment));
+        if (size > blockSize)
+            return ::operator new(size);
+
+        if (!freeBlocks)
+            grow();
+
+        FreeBlock* block = freeBlocks;
+        freeBlocks = block->next;
+        return block;
+    }
+
+    // Same size and alignment as the allocation
+    void deallocate(void* p, size_t size, size_t alignment) noexcept {
+        if (alignment > alignof(std::max_align_t)) {
+            ::operator delete(p, std::align_val_t(alignment));
+            return;
+        }
+        if (size > blockSize) {
+            ::operator delete(p);
+            return;
+        }
+
+        FreeBlock* block = static_cast<FreeBlock*>(p);
+        block->next = freeBlocks;
+        freeBlocks = block;
+    }
+
+    size_t chunkCount() const { return chunks.size(); }
+
+private:
+    struct FreeBlock {
+        FreeBlock* next;
+    };
+
+    size_t blocksPerChunk;
+    size_t blockSize = 0;
+    FreeBlock* freeBlocks = nullptr;
+    std::vector<void*> chunks;
+
+    static size_t roundUp(size_t size) {
+        const size_t a = alignof(std::max_align_t);
+        return (size + a - 1) / a * a;
+    }
+
+    void grow() {
+        char* chunk = static_cast<char*>(::operator new(blockSize * blocksPerChunk));
+        chunks.push_back(chunk);
+
+        for (size_t i = 0; i < blocksPerChunk; i++) {
+            FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + i * blockSize);
+            block->next = freeBlocks;
+            freeBlocks = block;
+        }
+    }
+};
+
+
+// Allocator handed to std::allocate_shared so the control block comes from an arena
+template <typename T>
+struct PoolAllocator {
+    using value_type = T;
+
+    BlockArena* arena;
+
+    explicit PoolAllocator(BlockArena* arena) noexcept : arena(arena) {}
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept : arena(other.arena) {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        arena->deallocate(p, n * sizeof(T), alignof(T));
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U>& other) const noexcept { return arena == other.arena; }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U>& other) const noexcept { return arena != other.arena; }
+};
+
+
+// Free-list of recyclable objects. Released objects are reset in place
+// (T::resetForPool, if it exists) instead of being destroyed, so steady-state
+// acquire/release never touches the heap.
+// The pool must outlive every shared_ptr it hands out.
+template <typename T>
+class ObjectPool {
+public:
+    explicit ObjectPool(size_t blocksPerChunk = 64) : arena(blocksPerChunk) {}
+
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    // Constructor arguments are only used when the free-list is empty
+    template <typename... Args>
+    std::shared_ptr<T> acquire(Args&&... args) {
+        if (!freeList.empty()) {
+            auto obj = std::move(freeList.back());
+            freeList.pop_back();
+            return obj;
+        }
+
+        return create(std::forward<Args>(args)...);
+    }
+
+    void release(std::shared_ptr<T> obj) {
+        if (!obj) return;
+
+        if constexpr (requires(T & t) { t.resetForPool(); })
+            obj->resetForPool();
+
+        freeList.push_back(std::move(obj));
+    }
+
+    // Fill the free-list ahead of time so gameplay never hits the allocator
+    template <typename... Args>
+    void prewarm(size_t count, Args&&... args) {
+        freeList.reserve(freeList.size() + count);
+        for (size_t i = 0; i < count; i++)
+            freeList.push_back(create(args...));
+    }
+
+    size_t available() const { return freeList.size(); }
+    size_t totalCreated() const { return created; }
+
+    // Free objects in hand-out order (back first), for snapshots
+    const std::vector<std::shared_ptr<T>>& freeObjects() const { return freeList; }
+
+    // Replace the free-list with objects that are already reset, e.g. on snapshot restore
+    void setFreeObjects(std::vector<std::shared_ptr<T>>&& objects) {
+        freeList = std::move(objects);
+    }
+
+private:
+    BlockArena arena;
+    std::vector<std::shared_ptr<T>> freeList;
+    size_t created = 0;
+
+    template <typename... Args>
+    std::shared_ptr<T> create(Args&&... args) {
+        created++;
+        if (freeList.capacity() < created)
+            freeList.reserve(created * 2);
+        return std::allocate_shared<T>(PoolAllocator<T>(&arena), std::forward<Args>(args)...);
+    }
+};
@@ -8,13 +8,41 @@
 
 #include "Collider.h"
 #include "CollisionSystem.h"
-#include "Services.h"
+#include "World.h"
 
 #include "TeamRules.h"
 #include "HealthComponent.h"
+#include "DamageSystem.h"
 
 using namespace glm;
 
+// Knockback and damage for a laser hit, shared by projectiles and hitscan weapons
+inline void applyLaserHit(World* world, const ColliderUserData& target, const vec2& velocity, float damage, float knockbackScale, int team, Transform2D* source)
+{
+    if (target.physics)
+        target.physics->applyImpulse(velocity * damage * knockbackScale);
+
+    // Team filter, read from the health component so team changes apply right away
+    HealthComponent* health = target.health.get();
+    if (!TeamRules::canDamage(team, health ? health->team : -1)) return;
+
+    // Applied after collision, grouped per target
+    if (world)
+        world->damage->queue(target.entity, damage, source);
+    else if (health)
+        health->applyDamage(damage, source);
+}
+
+// Stable reference to a live projectile inside ProjectileSystem
+struct ProjectileHandle {
+    static constexpr uint32_t InvalidSlot = 0xFFFFFFFFu;
+
+    uint32_t slot = InvalidSlot;
+    uint32_t generation = 0;
+
+    bool isValid() const { return slot != InvalidSlot; }
+};
+
 class Projectile : public Actor2D{
 public:
     Transform2D* owner = nullptr; // The originator of the projectile
@@ -22,36 +50,89 @@ public:
     float lifetime; // seconds
     int team;
 
-   
+    // Assigned by ProjectileSystem when the projectile is added
+    ProjectileHandle handle;
+    std::vector<ProjectileHandle>* killQueue = nullptr;
+
+    // Recycled projectiles keep their collider between uses
+    std::shared_ptr<Collider2D> collider;
+    bool pooled = false;
+    uint32_t poolId = ProjectileHandle::InvalidSlot;   // creation order in ProjectileSystem, names pooled objects in snapshots
 
     Projectile() = default;
 
 	virtual void init() {}
 
     void makeCollider(float size) {
-        auto collider = std::make_shared<Collider2D>(Collider2D::ShapeType::Circle);
+        if (collider) {
+            collider->setEnabled(true);
+            return;
+        }
+
+        collider = world->collisions->acquireCollider(Collider2D::ShapeType::Circle);
         collider->layer = CollisionLayer::Projectile;
         collider->mask = CollisionLayer::All - CollisionLayer::Projectile;
         collider->scale = vec2(0.2f);
+        collider->userData.owner = this;
+        collider->userData.entity = getEntity();
         addChild(collider);
 
         // Set the collision callback
         collider->onCollisionEnter = [this](Collider2D* other) {
+            if (isDead() || !other) return;
+
             // Call the virtual function
-            this->hitSomething(other ? dynamic_cast<Transform2D*>(other->parent.lock().get()) : nullptr);
+            this->hitSomething(other->userData);
             };
-        Services::collisions->addCollider(collider);
     }
 
-    virtual void hitSomething(Transform2D* other) {
-        if (other) {
-            // Example: print or apply damage
-            // printf("Hit actor with sprite: %s\n", other->spriteName.c_str());
-        }
+    // Called by ObjectPool when the projectile is handed back
+    virtual void resetForPool() {
+        if (collider)
+            collider->setEnabled(false);
+
+        owner = nullptr;
+        lifetime = 0.0f;
+        handle = ProjectileHandle{};
+        killQueue = nullptr;
+    }
+
+    virtual void hitSomething(const ColliderUserData& other) {
         // Default: destroy the projectile
+        kill();
+    }
+
+    // Removed by the owning system on its next update
+    void kill() {
+        if (isDead()) return;
+
         lifetime = 0.0f;
+        if (killQueue && handle.isValid())
+            killQueue->push_back(handle);
     }
+
     bool isDead() const { return lifetime <= 0.0f; }
+
+protected:
+    // The owner pointer is not saved, restored projectiles are ownerless
+    void saveOwnState(SnapshotWriter& out) const override {
+        Actor2D::saveOwnState(out);
+        out.write(velocity);
+        out.write(lifetime);
+        out.write(team);
+        out.write(handle);
+        out.writeString(spriteName);
+    }
+
+    void loadOwnState(SnapshotReader& in) override {
+        Actor2D::loadOwnState(in);
+        in.read(velocity);
+        in.read(lifetime);
+        in.read(team);
+        in.read(handle);
+        in.readString(spriteName);
+        owner = nullptr;
+    }
 };
 
 
@@ -60,9 +141,18 @@ public:
     float damage = 0.0f;
     float knockbackScale = 1.0f / 100.0f;
 
+    // Pooled instances are constructed empty and filled in with reset()
+    LaserProjectile() {
+        spriteName = "laser_shot";
+    }
+
     // Constructor with all needed parameters
     LaserProjectile(vec2 startPos, vec2 velocity, float lifetime, float damage, int team, Transform2D* owner = nullptr)
     {
+        reset(startPos, velocity, lifetime, damage, team, owner);
+    }
+
+    void reset(vec2 startPos, vec2 velocity, float lifetime, float damage, int team, Transform2D* owner = nullptr) {
         this->position = startPos;  // inherited from Transform2D
         this->velocity = velocity;
         this->setRotation(velocity);
@@ -71,28 +161,17 @@ public:
         this->team = team;
         this->owner = owner; // assign the owner
         this->spriteName = "laser_shot"; // optional, can be set externally
+        markDirty();
     }
      
     void init() override {
         makeCollider(0.5f);
     }
 
-    void hitSomething(Transform2D* other) {
+    void hitSomething(const ColliderUserData& other) override {
+        applyLaserHit(world, other, velocity, damage, knockbackScale, team, owner);
 
-        if (auto phys = dynamic_cast<PhysicalActor2D*>(other)) {
-            phys->applyImpulse(velocity * damage * knockbackScale);
-        }
-        
-        if (auto dmg = dynamic_cast<Actor2D*>(other)->getComponent<HealthComponent>()) {
-
-            // Team filter
-            if (TeamRules::canDamage(this->team, dmg->team)) {
-
-                dmg->applyDamage(damage, this->owner);
-            }
-        }
-
-        lifetime = 0;
+        kill();
     }
 
     // Update moves the projectile and decreases lifetime
@@ -102,5 +181,18 @@ public:
 
         markDirty();
     }
+
+protected:
+    void saveOwnState(SnapshotWriter& out) const override {
+        Projectile::saveOwnState(out);
+        out.write(damage);
+        out.write(knockbackScale);
+    }
+
+    void loadOwnState(SnapshotReader& in) override {
+        Projectile::loadOwnState(in);
+        in.read(damage);
+        in.read(knockbackScale);
+    }
 };
 
@@ -1,18 +1,52 @@
 #pragma once
 #include "Projectile.h"
 #include <vector>
+#include <string>
+#include <cmath>
 #include "AssetManager.h"
+#include "TimingWheel.h"
+#include "Pool.h"
+#include "World.h"
+
+// Visual-only streak for hitscan shots, travels from origin to the hit point
+struct Tracer {
+    vec2 origin;
+    vec2 direction;     // normalized
+    float length;       // distance to the hit point
+    float speed;
+    vec2 scale;
+    std::string spriteName;
+    float age = 0.0f;
+
+    bool isDone() const { return age * speed >= length; }
+};
 
 class ProjectileSystem {
 public:
+    // Expiry resolution of the timing wheel
+    static constexpr double tickSeconds = 1.0 / 120.0;
+
     std::vector<std::shared_ptr<Projectile>> projectiles;
+    std::vector<Tracer> tracers;
+
+    // Set by the World that owns this system, lasers join it when they are registered
+    World* world = nullptr;
+
+    // Pooled lasers still in flight live in the pool's arena, drop them before it goes
+    ~ProjectileSystem() {
+        projectiles.clear();
+        allLasers.clear();
+    }
 
     // Update all projectiles
     void update(double dt) {
+        elapsed += dt;
+
         for (auto& p : projectiles)
             p->update(dt);
 
         removeDead();
+        updateTracers(dt);
     }
 
     // Draw all projectiles
@@ -21,19 +55,254 @@ public:
             auto* tex = assets.getTexture(p->spriteName);
             renderer.Draw(tex->id, p->getWorldMatrix());
         }
+
+        for (auto& t : tracers) {
+            auto* tex = assets.getTexture(t.spriteName);
+            if (!tex) continue;
+
+            Transform2D streak;
+            streak.position = t.origin + t.direction * (t.age * t.speed);
+            streak.setRotation(t.direction);
+            streak.scale = t.scale;
+            renderer.Draw(tex->id, streak.getWorldMatrix());
+        }
     }
 
     // Add any projectile type
     void addProjectile(const std::shared_ptr<Projectile>& proj) {
+        uint32_t slot = allocateSlot();
+        slots[slot].dense = static_cast<uint32_t>(projectiles.size());
+
+        proj->handle = ProjectileHandle{ slot, slots[slot].generation };
+        proj->killQueue = &pendingKills;
         projectiles.push_back(proj);
+
+        uint64_t expiry = static_cast<uint64_t>(std::ceil((elapsed + proj->lifetime) / tickSeconds));
+        expiryWheel.schedule(expiry, proj->handle);
+    }
+
+    // Add a batch of projectiles spawned in the same tick
+    void addProjectiles(const std::vector<std::shared_ptr<Projectile>>& batch) {
+        projectiles.reserve(projectiles.size() + batch.size());
+        for (auto& proj : batch)
+            addProjectile(proj);
+    }
+
+    // Recycled laser projectile, call reset() and init() before adding it
+    std::shared_ptr<LaserProjectile> acquireLaser() {
+        auto p = laserPool.acquire();
+        p->pooled = true;
+        registerLaser(p);
+        return p;
+    }
+
+    void prewarm(size_t lasers) {
+        laserPool.prewarm(lasers);
+        projectiles.reserve(projectiles.size() + lasers);
+        expiryWheel.reserve(lasers);
+        if (world)
+            world->collisions->prewarmColliders(lasers);
+        for (auto& p : laserPool.freeObjects())
+            registerLaser(p);
+    }
+
+    // O(1) removal, the last projectile takes the freed place
+    void removeProjectile(ProjectileHandle handle) {
+        if (!isAlive(handle)) return;
+
+        uint32_t index = slots[handle.slot].dense;
+        auto removed = std::move(projectiles[index]);
+
+        if (index + 1 != projectiles.size()) {
+            projectiles[index] = std::move(projectiles.back());
+            slots[projectiles[index]->handle.slot].dense = index;
+        }
+        projectiles.pop_back();
+
+        releaseSlot(handle.slot);
+        removed->handle = ProjectileHandle{};
+        removed->killQueue = nullptr;
+
+        if (removed->pooled)
+            laserPool.release(std::static_pointer_cast<LaserProjectile>(std::move(removed)));
+    }
+
+    bool isAlive(ProjectileHandle handle) const {
+        return handle.isValid() &&
+            handle.slot < slots.size() &&
+            slots[handle.slot].generation == handle.generation &&
+            slots[handle.slot].dense != ProjectileHandle::InvalidSlot;
+    }
+
+    void addTracer(const Tracer& tracer) {
+        tracers.push_back(tracer);
+    }
+
+    // Live projectiles in update order, the pool's free-list order, handle slots and
+    // the expiry wheel. Pooled lasers are named by poolId; only pooled projectiles
+    // can be saved. Take snapshots between ticks.
+    bool saveState(SnapshotWriter& out) const {
+        out.write(elapsed);
+        out.write(static_cast<uint32_t>(allLasers.size()));
+
+        out.write(static_cast<uint32_t>(projectiles.size()));
+        for (auto& p : projectiles) {
+            if (!p->pooled) return false;
+            out.write(p->poolId);
+            p->saveState(out);
+        }
+
+        const auto& free = laserPool.freeObjects();
+        out.write(static_cast<uint32_t>(free.size()));
+        for (auto& p : free)
+            out.write(p->poolId);
+
+        out.writeVector(slots);
+        out.writeVector(freeSlots);
+        out.writeVector(pendingKills);
+        expiryWheel.saveState(out);
+
+        out.write(static_cast<uint32_t>(tracers.size()));
+        for (const Tracer& t : tracers) {
+            out.write(t.origin);
+            out.write(t.direction);
+            out.write(t.length);
+            out.write(t.speed);
+            out.write(t.scale);
+            out.writeString(t.spriteName);
+            out.write(t.age);
+        }
+        return true;
+    }
+
+    // Lasers created after the snapshot go back to the pool behind the saved
+    // free-list, in creation order, so re-simulation hands them out like the
+    // original run created them.
+    bool loadState(SnapshotReader& in) {
+        uint32_t savedLasers = 0, liveCount = 0;
+        in.read(elapsed);
+        if (!in.read(savedLasers) || savedLasers > allLasers.size()) return in.fail();
+
+        // Same cleanup as the pool's release, the free-list is rebuilt below
+        for (auto& p : projectiles)
+            p->resetForPool();
+        projectiles.clear();
+
+        if (!in.read(liveCount)) return false;
+        projectiles.reserve(liveCount);
+        for (uint32_t i = 0; i < liveCount; i++) {
+            uint32_t id = 0;
+            if (!in.read(id) || id >= savedLasers) return in.fail();
+
+            auto& p = allLasers[id];
+            p->init();
+            if (!p->loadState(in)) return false;
+            p->killQueue = &pendingKills;
+            projectiles.push_back(p);
+        }
+
+        uint32_t freeCount = 0;
+        if (!in.read(freeCount) || freeCount > savedLasers) return in.fail();
+
+        std::vector<std::shared_ptr<LaserProjectile>> free;
+        free.reserve(allLasers.size() - savedLasers + freeCount);
+        for (size_t id = allLasers.size(); id-- > savedLasers;)
+            free.push_back(allLasers[id]);
+        for (uint32_t i = 0; i < freeCount; i++) {
+            uint32_t id = 0;
+            if (!in.read(id) || id >= savedLasers) return in.fail();
+            free.push_back(allLasers[id]);
+        }
+        if (free.size() + projectiles.size() != allLasers.size()) return in.fail();
+        laserPool.setFreeObjects(std::move(free));
+
+        in.readVector(slots);
+        in.readVector(freeSlots);
+        in.readVector(pendingKills);
+        if (!expiryWheel.loadState(in)) return false;
+
+        uint32_t tracerCount = 0;
+        if (!in.read(tracerCount)) return false;
+        tracers.resize(tracerCount);
+        for (Tracer& t : tracers) {
+            in.read(t.origin);
+            in.read(t.direction);
+            in.read(t.length);
+            in.read(t.speed);
+            in.read(t.scale);
+            in.readString(t.spriteName);
+            in.read(t.age);
+        }
+        return in.good();
     }
 
 private:
+    void updateTracers(double dt) {
+        for (size_t i = 0; i < tracers.size();) {
+            tracers[i].age += static_cast<float>(dt);
+            if (tracers[i].isDone()) {
+                tracers[i] = std::move(tracers.back());
+                tracers.pop_back();
+            }
+            else {
+                ++i;
+            }
+        }
+    }
+
+    struct Slot {
+        uint32_t dense = ProjectileHandle::InvalidSlot; // index into projectiles
+        uint32_t generation = 0;
+    };
+
+    ObjectPool<LaserProjectile> laserPool{ 256 };
+    std::vector<std::shared_ptr<LaserProjectile>> allLasers;   // every pooled laser by poolId
+    std::vector<Slot> slots;
+    std::vector<uint32_t> freeSlots;
+    std::vector<ProjectileHandle> pendingKills;
+    TimingWheel<ProjectileHandle> expiryWheel;
+    double elapsed = 0.0;
+
+    void registerLaser(const std::shared_ptr<LaserProjectile>& p) {
+        if (p->poolId != ProjectileHandle::InvalidSlot) return;
+        p->poolId = static_cast<uint32_t>(allLasers.size());
+        allLasers.push_back(p);
+        p->world = world;
+
+        // Pair the laser with its collider right away, so which collider a laser owns
+        // follows creation order and not the order lasers happen to be fired in
+        if (world && !p->collider) {
+            p->init();
+            p->collider->setEnabled(false);
+        }
+    }
+
+    uint32_t allocateSlot() {
+        if (!freeSlots.empty()) {
+            uint32_t slot = freeSlots.back();
+            freeSlots.pop_back();
+            return slot;
+        }
+        slots.push_back(Slot{});
+        return static_cast<uint32_t>(slots.size() - 1);
+    }
+
+    void releaseSlot(uint32_t slot) {
+        slots[slot].dense = ProjectileHandle::InvalidSlot;
+        slots[slot].generation++;
+        freeSlots.push_back(slot);
+    }
+
+    // Only touches projectiles killed by collisions or expiring this tick
     void removeDead() {
-        projectiles.erase(
-            std::remove_if(projectiles.begin(), projectiles.end(),
-                [](auto& p) { return p->isDead(); }),
-            projectiles.end()
-        );
+        for (auto handle : pendingKills)
+            removeProjectile(handle);
+        pendingKills.clear();
+
+        // Stale handles (already killed) fail the generation check
+        uint64_t tick = static_cast<uint64_t>(elapsed / tickSeconds);
+        expiryWheel.advance(tick, [this](ProjectileHandle handle) {
+            removeProjectile(handle);
+            });
     }
 };
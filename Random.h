@@ -0,0 +1,238 @@
+#pragma once
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <vector>
+#include "Snapshot.h"
+
+
+// PCG32 (XSH-RR): small, fast and reproducible, one instance per consumer
+class Pcg32 {
+public:
+    uint64_t state = 0x853c49e6748fea9bULL;
+    uint64_t inc = 0xda3e39cb94b95bdbULL;   // stream selector, always odd
+
+    Pcg32() = default;
+    Pcg32(uint64_t seedValue, uint64_t stream = 1) { seed(seedValue, stream); }
+
+    void seed(uint64_t seedValue, uint64_t stream = 1) {
+        state = 0u;
+        inc = (stream << 1u) | 1u;
+        nextU32();
+        state += seedValue;
+        nextU32();
+    }
+
+    uint32_t nextU32() {
+        uint64_t old = state;
+        state = old * 6364136223846793005ULL + inc;
+        uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+        uint32_t rot = static_cast<uint32_t>(old >> 59u);
+        return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+    }
+
+    uint64_t nextU64() {
+        return (static_cast<uint64_t>(nextU32()) << 32) | nextU32();
+    }
+
+    // [0, 1)
+    float nextFloat() {
+        return (nextU32() >> 8) * (1.0f / 16777216.0f);
+    }
+
+    // (0, 1), safe to take the log of
+    double nextOpenDouble() {
+        return (static_cast<double>(nextU32()) + 0.5) * (1.0 / 4294967296.0);
+    }
+
+    float uniform(float min, float max) {
+        return min + (max - min) * nextFloat();
+    }
+
+    bool operator==(const Pcg32& other) const {
+        return state == other.state && inc == other.inc;
+    }
+};
+
+
+// Marsaglia-Tsang ziggurat for standard normal samples.
+// The fast path (one multiply and compare) covers ~99% of draws.
+class Ziggurat {
+public:
+    static float normal(Pcg32& rng) {
+        const Tables& t = tables();
+
+        int32_t hz = static_cast<int32_t>(rng.nextU32());
+        uint32_t iz = hz & 127;
+        if (magnitude(hz) < t.kn[iz])
+            return hz * t.wn[iz];
+
+        return normalSlow(rng, hz, iz);
+    }
+
+    // Fill out with N(mean, stddev) samples
+    static void fillNormal(Pcg32& rng, float* out, size_t count, float mean = 0.0f, float stddev = 1.0f) {
+        const Tables& t = tables();
+
+        for (size_t i = 0; i < count; i++) {
+            int32_t hz = static_cast<int32_t>(rng.nextU32());
+            uint32_t iz = hz & 127;
+
+            float x = (magnitude(hz) < t.kn[iz]) ? hz * t.wn[iz] : normalSlow(rng, hz, iz);
+            out[i] = mean + stddev * x;
+        }
+    }
+
+    // Fill out with U[min, max) samples
+    static void fillUniform(Pcg32& rng, float* out, size_t count, float min = 0.0f, float max = 1.0f) {
+        const float range = max - min;
+        for (size_t i = 0; i < count; i++)
+            out[i] = min + range * ((rng.nextU32() >> 8) * (1.0f / 16777216.0f));
+    }
+
+private:
+    struct Tables {
+        uint32_t kn[128];
+        float wn[128];
+        float fn[128];
+
+        Tables() {
+            const double m1 = 2147483648.0;
+            const double vn = 9.91256303526217e-3;
+            double dn = 3.442619855899;
+            double tn = dn;
+            double q = vn / std::exp(-0.5 * dn * dn);
+
+            kn[0] = static_cast<uint32_t>((dn / q) * m1);
+            kn[1] = 0;
+            wn[0] = static_cast<float>(q / m1);
+            wn[127] = static_cast<float>(dn / m1);
+            fn[0] = 1.0f;
+            fn[127] = static_cast<float>(std::exp(-0.5 * dn * dn));
+
+            for (int i = 126; i >= 1; i--) {
+                dn = std::sqrt(-2.0 * std::log(vn / dn + std::exp(-0.5 * dn * dn)));
+                kn[i + 1] = static_cast<uint32_t>((dn / tn) * m1);
+                tn = dn;
+                fn[i] = static_cast<float>(std::exp(-0.5 * dn * dn));
+                wn[i] = static_cast<float>(dn / m1);
+            }
+        }
+    };
+
+    static const Tables& tables() {
+        static const Tables t;
+        return t;
+    }
+
+    static uint32_t magnitude(int32_t v) {
+        return v < 0 ? 0u - static_cast<uint32_t>(v) : static_cast<uint32_t>(v);
+    }
+
+    // Wedges and tail, rarely taken
+    static float normalSlow(Pcg32& rng, int32_t hz, uint32_t iz) {
+        const Tables& t = tables();
+        const float r = 3.442620f;
+
+        for (;;) {
+            float x = hz * t.wn[iz];
+
+            if (iz == 0) {
+                float y;
+                do {
+                    x = static_cast<float>(-std::log(rng.nextOpenDouble()) * 0.2904764);
+                    y = static_cast<float>(-std::log(rng.nextOpenDouble()));
+                } while (y + y < x * x);
+                return (hz > 0) ? r + x : -r - x;
+            }
+
+            if (t.fn[iz] + rng.nextFloat() * (t.fn[iz - 1] - t.fn[iz]) < std::exp(-0.5f * x * x))
+                return x;
+
+            hz = static_cast<int32_t>(rng.nextU32());
+            iz = hz & 127;
+            if (magnitude(hz) < t.kn[iz])
+                return hz * t.wn[iz];
+        }
+    }
+};
+
+
+// Batched N(0, 1) samples, refilled a block at a time
+class NormalSampleBuffer {
+public:
+    explicit NormalSampleBuffer(size_t blockSize = 64) : samples(blockSize), cursor(blockSize) {}
+
+    float next(Pcg32& rng) {
+        if (cursor >= samples.size()) {
+            Ziggurat::fillNormal(rng, samples.data(), samples.size());
+            cursor = 0;
+        }
+        return samples[cursor++];
+    }
+
+    // Throw away buffered samples, e.g. after reseeding
+    void reset() { cursor = samples.size(); }
+
+    // Only the samples not handed out yet matter
+    void saveState(SnapshotWriter& out) const {
+        out.write(static_cast<uint32_t>(samples.size() - cursor));
+        out.writeBytes(samples.data() + cursor, (samples.size() - cursor) * sizeof(float));
+    }
+
+    bool loadState(SnapshotReader& in) {
+        uint32_t left = 0;
+        if (!in.read(left) || left > samples.size()) return in.fail();
+        cursor = samples.size() - left;
+        return in.readBytes(samples.data() + cursor, left * sizeof(float));
+    }
+
+private:
+    std::vector<float> samples;
+    size_t cursor;
+};
+
+
+// Per-world random source. Every consumer (weapon, AI, spawner) takes its own
+// stream so results don't depend on who draws first.
+class RandomService {
+public:
+    explicit RandomService(uint64_t worldSeed = 0x5eed5eedULL) { reseed(worldSeed); }
+
+    void reseed(uint64_t worldSeed) {
+        seed = worldSeed;
+        nextStream = 1;
+        root.seed(worldSeed, 0);
+    }
+
+    uint64_t getSeed() const { return seed; }
+
+    // Shared world generator for one-off draws
+    Pcg32& world() { return root; }
+
+    // Independent generator, streams are handed out in creation order
+    Pcg32 makeStream() {
+        return Pcg32(seed, nextStream++);
+    }
+
+    Pcg32 makeStream(uint64_t streamId) {
+        return Pcg32(seed, streamId);
+    }
+
+    void saveState(SnapshotWriter& out) const {
+        out.write(seed);
+        out.write(nextStream);
+        out.write(root);
+    }
+
+    void loadState(SnapshotReader& in) {
+        in.read(seed);
+        in.read(nextStream);
+        in.read(root);
+    }
+
+private:
+    uint64_t seed = 0;
+    uint64_t nextStream = 1;
+    Pcg32 root;
+};
@@ -0,0 +1,551 @@
+#pragma once
+#include <vector>
+#include <map>
+#include <memory>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <string_view>
+#include <algorithm>
+#include <utility>
+#include <tuple>
+#include <type_traits>
+#include "Snapshot.h"
+
+
+// Archetype based component storage.
+// Every distinct set of component types is an archetype that keeps each type in
+// its own contiguous column, so a query walks plain arrays instead of chasing
+// pointers. Adding or removing a component moves the entity to another archetype.
+
+using ComponentTypeId = uint64_t;
+
+namespace ecs_detail {
+    constexpr uint64_t fnv1a(std::string_view text) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (char c : text) {
+            hash ^= static_cast<uint8_t>(c);
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+}
+
+// Hash of the instantiated signature, known at compile time and stable across translation units
+template <typename T>
+constexpr ComponentTypeId componentTypeId() {
+#if defined(_MSC_VER)
+    return ecs_detail::fnv1a(__FUNCSIG__);
+#else
+    return ecs_detail::fnv1a(__PRETTY_FUNCTION__);
+#endif
+}
+
+
+struct Entity {
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFF;
+
+    uint32_t index = InvalidIndex;
+    uint32_t generation = 0;
+
+    bool isValid() const { return index != InvalidIndex; }
+    bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+    bool operator!=(const Entity& other) const { return !(*this == other); }
+};
+
+
+// How to move and destroy a component without knowing its type
+struct ComponentInfo {
+    ComponentTypeId id;
+    size_t size;
+    size_t align;
+    void (*moveConstruct)(void* dst, void* src);    // src is destroyed afterwards
+    void (*destroy)(void* p);
+
+    // Set when T has saveState/loadState, otherwise the type isn't part of snapshots
+    void (*save)(const void* p, SnapshotWriter& out);
+    void (*load)(void* p, SnapshotReader& in);
+
+    template <typename T>
+    static const ComponentInfo& of() {
+        static const ComponentInfo info{
+            componentTypeId<T>(),
+            sizeof(T),
+            alignof(T),
+            [](void* dst, void* src) {
+                T* from = static_cast<T*>(src);
+                new (dst) T(std::move(*from));
+                from->~T();
+            },
+            [](void* p) { static_cast<T*>(p)->~T(); },
+            saveFn<T>(),
+            loadFn<T>()
+        };
+        return info;
+    }
+
+private:
+    template <typename T>
+    static constexpr auto saveFn() -> void (*)(const void*, SnapshotWriter&) {
+        if constexpr (requires(const T & t, SnapshotWriter & w) { t.saveState(w); })
+            return [](const void* p, SnapshotWriter& out) { static_cast<const T*>(p)->saveState(out); };
+        else
+            return nullptr;
+    }
+
+    template <typename T>
+    static constexpr auto loadFn() -> void (*)(void*, SnapshotReader&) {
+        if constexpr (requires(T & t, SnapshotReader & r) { t.loadState(r); })
+            return [](void* p, SnapshotReader& in) { static_cast<T*>(p)->loadState(in); };
+        else
+            return nullptr;
+    }
+};
+
+
+// Contiguous, type erased array of one component type
+class ComponentColumn {
+public:
+    explicit ComponentColumn(const ComponentInfo& info) : info(&info) {}
+
+    ComponentColumn(ComponentColumn&& other) noexcept
+        : info(other.info), data(other.data), count(other.count), capacity(other.capacity) {
+        other.data = nullptr;
+        other.count = other.capacity = 0;
+    }
+
+    ComponentColumn(const ComponentColumn&) = delete;
+    ComponentColumn& operator=(const ComponentColumn&) = delete;
+
+    ~ComponentColumn() {
+        for (size_t i = 0; i < count; i++)
+            info->destroy(at(i));
+        release();
+    }
+
+    ComponentTypeId id() const { return info->id; }
+    const ComponentInfo& getInfo() const { return *info; }
+    size_t size() const { return count; }
+
+    void* at(size_t row) { return data + row * info->size; }
+
+    template <typename T>
+    T* as() { return std::launder(reinterpret_cast<T*>(data)); }
+
+    template <typename T, typename... Args>
+    T& emplace(Args&&... args) {
+        reserve(count + 1);
+        T* c = new (at(count)) T(std::forward<Args>(args)...);
+        count++;
+        return *c;
+    }
+
+    // Move an element in from another column of the same type
+    void pushMoved(void* src) {
+        reserve(count + 1);
+        info->moveConstruct(at(count), src);
+        count++;
+    }
+
+    void destroyAt(size_t row) { info->destroy(at(row)); }
+
+    // Close the gap left at an already destroyed row with the last element
+    void fillHole(size_t row) {
+        size_t last = count - 1;
+        if (row != last)
+            info->moveConstruct(at(row), at(last));
+        count--;
+    }
+
+    void reserve(size_t wanted) {
+        if (wanted <= capacity) return;
+
+        size_t newCapacity = capacity ? capacity * 2 : 8;
+        while (newCapacity < wanted) newCapacity *= 2;
+
+        char* newData = static_cast<char*>(::operator new(newCapacity * info->size, std::align_val_t(info->align)));
+        for (size_t i = 0; i < count; i++)
+            info->moveConstruct(newData + i * info->size, at(i));
+
+        release();
+        data = newData;
+        capacity = newCapacity;
+    }
+
+private:
+    const ComponentInfo* info;
+    char* data = nullptr;
+    size_t count = 0;
+    size_t capacity = 0;
+
+    void release() {
+        if (data)
+            ::operator delete(data, std::align_val_t(info->align));
+        data = nullptr;
+    }
+};
+
+
+// All entities that have exactly the same component types
+class Archetype {
+public:
+    std::vector<ComponentTypeId> types;     // sorted, parallel to columns
+    std::vector<ComponentColumn> columns;
+    std::vector<Entity> entities;
+
+    size_t size() const { return entities.size(); }
+
+    int columnIndex(ComponentTypeId id) const {
+        auto it = std::lower_bound(types.begin(), types.end(), id);
+        if (it == types.end() || *it != id) return -1;
+        return static_cast<int>(it - types.begin());
+    }
+
+    bool has(ComponentTypeId id) const { return columnIndex(id) >= 0; }
+
+private:
+    friend class Registry;
+
+    // Cached archetype transitions, keyed by the component added or removed
+    std::vector<std::pair<ComponentTypeId, Archetype*>> addEdges;
+    std::vector<std::pair<ComponentTypeId, Archetype*>> removeEdges;
+
+    static Archetype* findEdge(const std::vector<std::pair<ComponentTypeId, Archetype*>>& edges, ComponentTypeId id) {
+        for (auto& [type, target] : edges)
+            if (type == id) return target;
+        return nullptr;
+    }
+};
+
+
+class Registry;
+
+// Handle to a component that stays valid while its storage moves around
+template <typename T>
+class ComponentRef {
+public:
+    ComponentRef() = default;
+    ComponentRef(Registry* registry, Entity entity) : registry(registry), entity(entity) {}
+    ComponentRef(std::nullptr_t) {}
+
+    T* get() const;
+    T* operator->() const { return get(); }
+    T& operator*() const { return *get(); }
+    explicit operator bool() const { return get() != nullptr; }
+
+    Entity getEntity() const { return entity; }
+
+private:
+    Registry* registry = nullptr;
+    Entity entity;
+};
+
+
+class Registry {
+public:
+    Registry() {
+        // Entities without components live in the empty archetype
+        archetypes.push_back(std::make_unique<Archetype>());
+        archetypeBySignature[{}] = archetypes.back().get();
+    }
+
+    Registry(const Registry&) = delete;
+    Registry& operator=(const Registry&) = delete;
+
+    Entity create() {
+        uint32_t index;
+        if (!freeIndices.empty()) {
+            index = freeIndices.back();
+            freeIndices.pop_back();
+        }
+        else {
+            index = static_cast<uint32_t>(records.size());
+            records.push_back(Record{});
+        }
+
+        Record& r = records[index];
+        r.alive = true;
+
+        Entity e{ index, r.generation };
+        Archetype* empty = archetypes.front().get();
+        r.archetype = empty;
+        r.row = static_cast<uint32_t>(empty->entities.size());
+        empty->entities.push_back(e);
+
+        aliveCount++;
+        return e;
+    }
+
+    void destroy(Entity e) {
+        if (!isAlive(e)) return;
+
+        Record& r = records[e.index];
+        for (auto& column : r.archetype->columns)
+            column.destroyAt(r.row);
+        removeRow(*r.archetype, r.row);
+
+        r.alive = false;
+        r.archetype = nullptr;
+        r.generation++;
+        freeIndices.push_back(e.index);
+        aliveCount--;
+    }
+
+    bool isAlive(Entity e) const {
+        return e.index < records.size() && records[e.index].alive && records[e.index].generation == e.generation;
+    }
+
+    size_t entityCount() const { return aliveCount; }
+    size_t archetypeCount() const { return archetypes.size(); }
+
+    // Replaces an existing component of the same type
+    template <typename T, typename... Args>
+    T& add(Entity e, Args&&... args) {
+        constexpr ComponentTypeId id = componentTypeId<T>();
+        Record& r = records[e.index];
+
+        int existing = r.archetype->columnIndex(id);
+        if (existing >= 0) {
+            T* c = static_cast<T*>(r.archetype->columns[existing].at(r.row));
+            *c = T(std::forward<Args>(args)...);
+            return *c;
+        }
+
+        Archetype* target = addTarget(*r.archetype, ComponentInfo::of<T>());
+        moveEntity(e, *target);
+
+        return target->columns[target->columnIndex(id)].template emplace<T>(std::forward<Args>(args)...);
+    }
+
+    template <typename T>
+    void remove(Entity e) {
+        if (!isAlive(e)) return;
+
+        constexpr ComponentTypeId id = componentTypeId<T>();
+        Record& r = records[e.index];
+        if (!r.archetype->has(id)) return;
+
+        moveEntity(e, *removeTarget(*r.archetype, id));
+    }
+
+    template <typename T>
+    T* get(Entity e) {
+        if (!isAlive(e)) return nullptr;
+
+        const Record& r = records[e.index];
+        int column = r.archetype->columnIndex(componentTypeId<T>());
+        if (column < 0) return nullptr;
+        return static_cast<T*>(r.archetype->columns[column].at(r.row));
+    }
+
+    template <typename T>
+    bool has(Entity e) const {
+        return isAlive(e) && records[e.index].archetype->has(componentTypeId<T>());
+    }
+
+    template <typename T>
+    ComponentRef<T> ref(Entity e) { return ComponentRef<T>(this, e); }
+
+    // Snapshot the entity's components that support it, tagged with their type ids
+    void saveComponents(Entity e, SnapshotWriter& out) {
+        if (!isAlive(e)) {
+            out.write(uint32_t(0));
+            return;
+        }
+
+        const Record& r = records[e.index];
+        uint32_t saved = 0;
+        for (auto& column : r.archetype->columns)
+            if (column.getInfo().save) saved++;
+
+        out.write(saved);
+        for (auto& column : r.archetype->columns) {
+            const ComponentInfo& info = column.getInfo();
+            if (!info.save) continue;
+            out.write(info.id);
+            info.save(column.at(r.row), out);
+        }
+    }
+
+    // The entity must still have the same set of saved component types
+    bool loadComponents(Entity e, SnapshotReader& in) {
+        uint32_t saved = 0;
+        if (isAlive(e)) {
+            for (auto& column : records[e.index].archetype->columns)
+                if (column.getInfo().save) saved++;
+        }
+        if (!in.expect(saved)) return false;
+        if (saved == 0) return true;
+
+        const Record& r = records[e.index];
+        for (auto& column : r.archetype->columns) {
+            const ComponentInfo& info = column.getInfo();
+            if (!info.save) continue;
+            if (!in.expect(info.id)) return false;
+            info.load(column.at(r.row), in);
+        }
+        return in.good();
+    }
+
+    // Linear pass over every entity that has all of Ts.
+    // Adding/removing components or entities inside the callback is not allowed.
+    template <typename... Ts>
+    class View {
+    public:
+        explicit View(Registry& registry) : registry(registry) {}
+
+        // fn(Ts&...) or fn(Entity, Ts&...)
+        template <typename F>
+        void each(F&& fn) {
+            constexpr ComponentTypeId ids[] = { componentTypeId<Ts>()... };
+
+            for (auto& arch : registry.archetypes) {
+                if (arch->entities.empty()) continue;
+
+                int columns[sizeof...(Ts)];
+                if (!findColumns(*arch, ids, columns)) continue;
+
+                eachRow(*arch, columns, fn, std::index_sequence_for<Ts...>{});
+            }
+        }
+
+        size_t count() {
+            constexpr ComponentTypeId ids[] = { componentTypeId<Ts>()... };
+
+            size_t total = 0;
+            int columns[sizeof...(Ts)];
+            for (auto& arch : registry.archetypes)
+                if (findColumns(*arch, ids, columns))
+                    total += arch->entities.size();
+            return total;
+        }
+
+    private:
+        Registry& registry;
+
+        static bool findColumns(const Archetype& arch, const ComponentTypeId* ids, int* columns) {
+            for (size_t i = 0; i < sizeof...(Ts); i++) {
+                columns[i] = arch.columnIndex(ids[i]);
+                if (columns[i] < 0) return false;
+            }
+            return true;
+        }
+
+        template <typename F, size_t... I>
+        static void eachRow(Archetype& arch, const int* columns, F& fn, std::index_sequence<I...>) {
+            std::tuple<Ts*...> arrays{ arch.columns[columns[I]].template as<Ts>()... };
+            const size_t n = arch.entities.size();
+
+            for (size_t row = 0; row < n; row++) {
+                if constexpr (std::is_invocable_v<F&, Entity, Ts&...>)
+                    fn(arch.entities[row], std::get<I>(arrays)[row]...);
+                else
+                    fn(std::get<I>(arrays)[row]...);
+            }
+        }
+    };
+
+    template <typename... Ts>
+    View<Ts...> view() { return View<Ts...>(*this); }
+
+private:
+    struct Record {
+        Archetype* archetype = nullptr;
+        uint32_t row = 0;
+        uint32_t generation = 0;
+        bool alive = false;
+    };
+
+    std::vector<Record> records;
+    std::vector<uint32_t> freeIndices;
+    size_t aliveCount = 0;
+
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::map<std::vector<ComponentTypeId>, Archetype*> archetypeBySignature;
+    std::map<ComponentTypeId, const ComponentInfo*> infos;
+
+    Archetype* getArchetype(const std::vector<ComponentTypeId>& types) {
+        auto it = archetypeBySignature.find(types);
+        if (it != archetypeBySignature.end())
+            return it->second;
+
+        auto arch = std::make_unique<Archetype>();
+        arch->types = types;
+        arch->columns.reserve(types.size());
+        for (ComponentTypeId id : types)
+            arch->columns.emplace_back(*infos[id]);
+
+        Archetype* result = arch.get();
+        archetypes.push_back(std::move(arch));
+        archetypeBySignature[types] = result;
+        return result;
+    }
+
+    Archetype* addTarget(Archetype& from, const ComponentInfo& info) {
+        if (Archetype* cached = Archetype::findEdge(from.addEdges, info.id))
+            return cached;
+
+        infos[info.id] = &info;
+
+        std::vector<ComponentTypeId> types = from.types;
+        types.insert(std::upper_bound(types.begin(), types.end(), info.id), info.id);
+
+        Archetype* target = getArchetype(types);
+        from.addEdges.push_back({ info.id, target });
+        return target;
+    }
+
+    Archetype* removeTarget(Archetype& from, ComponentTypeId id) {
+        if (Archetype* cached = Archetype::findEdge(from.removeEdges, id))
+            return cached;
+
+        std::vector<ComponentTypeId> types = from.types;
+        types.erase(std::find(types.begin(), types.end(), id));
+
+        Archetype* target = getArchetype(types);
+        from.removeEdges.push_back({ id, target });
+        return target;
+    }
+
+    // Carry shared components over, drop the ones the target doesn't have
+    void moveEntity(Entity e, Archetype& to) {
+        Record& r = records[e.index];
+        Archetype& from = *r.archetype;
+        uint32_t row = r.row;
+
+        for (size_t i = 0; i < from.columns.size(); i++) {
+            int dst = to.columnIndex(from.types[i]);
+            if (dst >= 0)
+                to.columns[dst].pushMoved(from.columns[i].at(row));
+            else
+                from.columns[i].destroyAt(row);
+        }
+
+        removeRow(from, row);
+
+        r.archetype = &to;
+        r.row = static_cast<uint32_t>(to.entities.size());
+        to.entities.push_back(e);
+    }
+
+    // Swap-remove a row whose components were already moved out or destroyed
+    void removeRow(Archetype& arch, uint32_t row) {
+        for (auto& column : arch.columns)
+            column.fillHole(row);
+
+        uint32_t last = static_cast<uint32_t>(arch.entities.size() - 1);
+        if (row != last) {
+            Entity moved = arch.entities[last];
+            arch.entities[row] = moved;
+            records[moved.index].row = row;
+        }
+        arch.entities.pop_back();
+    }
+};
+
+
+template <typename T>
+T* ComponentRef<T>::get() const {
+    return registry ? registry->get<T>(entity) : nullptr;
+}
@@ -0,0 +1,303 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <algorithm>
+#include <string>
+#include "PlayerController.h"
+#include "NetTransport.h"
+#include "WorldSnapshot.h"
+#include "Snapshot.h"
+
+// Two-player rollback over UDP.
+//
+// Each fixed tick the local command is simulated right away (plus inputDelay ticks,
+// if set) while the remote player's command is predicted by repeating the last one
+// received. When the real command arrives and differs from the prediction, the world
+// is restored to the snapshot of that tick and every tick since is simulated again.
+//
+// Packets carry every local command the peer hasn't acknowledged yet, so a lost packet
+// is covered by the next one, plus the checksum of the newest tick both sides agree on.
+// A checksum that differs from the peer's is reported as a desync.
+//
+// Both peers have to build the same world (same seed, arena, actors and prewarmed pools);
+// a pool that grows during a misprediction keeps its extra objects, so size pools
+// for the whole match.
+struct RollbackConfig {
+    int localPlayer = 0;            // 0 or 1, which command slot this peer fills
+    int inputDelay = 0;             // ticks between sampling a local command and simulating it
+    int maxPrediction = 12;         // ticks the sim may run past the last confirmed remote command
+    double tickSeconds = 1.0 / 60.0;
+    uint32_t sessionId = 0;         // packets from another session are ignored, see makeSessionId
+
+    // Hash of everything both peers have to agree on, so peers that don't agree never
+    // hear each other instead of desyncing later. code tells matches with the same
+    // settings apart, e.g. one the players picked together
+    static uint32_t makeSessionId(const std::string& code, uint64_t seed, float arenaWidth, float arenaHeight, double tickSeconds) {
+        uint64_t hash = 14695981039346656037ull;
+        auto mix = [&](const void* data, size_t size) {
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            for (size_t i = 0; i < size; i++) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+        };
+        mix(code.data(), code.size());
+        mix(&seed, sizeof(seed));
+        mix(&arenaWidth, sizeof(arenaWidth));
+        mix(&arenaHeight, sizeof(arenaHeight));
+        mix(&tickSeconds, sizeof(tickSeconds));
+        return static_cast<uint32_t>(hash ^ (hash >> 32));
+    }
+};
+
+class RollbackSession {
+public:
+    static constexpr int Window = 128;          // ticks of history kept, more than prediction + delay + round trip
+    static constexpr int MaxPacketCommands = Window;
+
+    // Simulate one tick with commands[player]; events are only presented when not resimulating
+    using StepFn = std::function<void(const PlayerCommand (&commands)[2], bool resimulating)>;
+
+    RollbackSession(WorldSnapshot& world, UdpSocket& socket, LinkConditioner& link, const RollbackConfig& config, StepFn step)
+        : world(world), socket(socket), link(link), config(config), step(std::move(step)) {
+        packet.reserve(64 + MaxPacketCommands * CommandBytes);
+        for (auto& s : snapshots) s.reserve(64 * 1024);
+        localTicks.fill(-1);
+        remoteTicks.fill(-1);
+        checksumTicks.fill(-1);
+        peerChecksumTicks.fill(-1);
+
+        // Ticks inside the input delay have no sampled command, both sides run them idle
+        for (int64_t t = 0; t < config.inputDelay; t++) {
+            localCommands[slot(t)] = PlayerCommand{};
+            localTicks[slot(t)] = t;
+        }
+        latestLocal = config.inputDelay - 1;
+    }
+
+    // Tick whose local command the next advance() takes
+    int64_t localInputTick() const { return currentTick + config.inputDelay; }
+
+    // Runs one tick. False when stalled, waiting for the remote player to catch up;
+    // call again next tick with a command for the same localInputTick().
+    bool advance(const PlayerCommand& local, double now) {
+        receivePackets();
+
+        if (currentTick - remoteConfirmed > config.maxPrediction) {
+            stalls++;
+            sendPacket(now);
+            link.flush(socket, now);
+            return false;
+        }
+
+        int64_t inputTick = localInputTick();
+        localCommands[slot(inputTick)] = local;
+        localTicks[slot(inputTick)] = inputTick;
+        latestLocal = inputTick;
+
+        if (rollbackFrom < currentTick) {
+            int64_t depth = currentTick - rollbackFrom;
+            rollbacks++;
+            resimulatedTicks += depth;
+            maxRollback = std::max(maxRollback, depth);
+
+            world.restore(snapshots[slot(rollbackFrom)]);
+            for (int64_t t = rollbackFrom; t < currentTick; t++)
+                simulate(t, true);
+        }
+        rollbackFrom = INT64_MAX;
+
+        simulate(currentTick, false);
+        currentTick++;
+
+        updateChecksums();
+        sendPacket(now);
+        link.flush(socket, now);
+        return true;
+    }
+
+    int64_t tick() const { return currentTick; }
+    int64_t remoteConfirmedTick() const { return remoteConfirmed; }
+
+    // Newest tick whose starting state can no longer change
+    int64_t confirmedTick() const { return std::min(remoteConfirmed + 1, currentTick - 1); }
+
+    // Checksum of the state at the start of a confirmed tick, if still in the window
+    bool checksumAt(int64_t t, uint64_t& out) const {
+        if (t < 0 || checksumTicks[slot(t)] != t) return false;
+        out = checksums[slot(t)];
+        return true;
+    }
+
+    uint64_t rollbackCount() const { return rollbacks; }
+    uint64_t resimulatedTickCount() const { return resimulatedTicks; }
+    int64_t maxRollbackDepth() const { return maxRollback; }
+    uint64_t stallCount() const { return stalls; }
+    uint64_t checksumsCompared() const { return compared; }
+    int64_t desyncTick() const { return desyncAt; }     // -1 while in sync
+    uint64_t packetsReceived() const { return received; }
+
+private:
+    static constexpr uint32_t Magic = 0x42523356;    // "V3RB"
+    static constexpr size_t CommandBytes = 9;
+
+    WorldSnapshot& world;
+    UdpSocket& socket;
+    LinkConditioner& link;
+    RollbackConfig config;
+    StepFn step;
+
+    int64_t currentTick = 0;
+    int64_t rollbackFrom = INT64_MAX;
+
+    // Rings indexed by tick % Window, the tick arrays tell which tick a slot holds
+    std::array<PlayerCommand, Window> localCommands{};
+    std::array<int64_t, Window> localTicks;
+    int64_t latestLocal = -1;
+    int64_t peerAck = -1;               // newest local command the peer has confirmed
+
+    std::array<PlayerCommand, Window> remoteCommands{};
+    std::array<int64_t, Window> remoteTicks;
+    std::array<PlayerCommand, Window> usedRemote{};      // what each simulated tick assumed
+    int64_t remoteConfirmed = -1;       // every remote command up to here has arrived
+    PlayerCommand lastConfirmedRemote;
+
+    std::array<std::vector<uint8_t>, Window> snapshots;  // state at the start of each tick
+    std::array<uint64_t, Window> checksums{};
+    std::array<int64_t, Window> checksumTicks;
+    std::array<uint64_t, Window> peerChecksums{};
+    std::array<int64_t, Window> peerChecksumTicks;
+    int64_t lastChecksum = -1;
+
+    std::vector<uint8_t> packet;
+    uint8_t receiveBuffer[2048];
+
+    uint64_t rollbacks = 0, resimulatedTicks = 0, stalls = 0, compared = 0, received = 0;
+    int64_t maxRollback = 0;
+    int64_t desyncAt = -1;
+
+    static size_t slot(int64_t t) { return static_cast<size_t>(t % Window); }
+
+    PlayerCommand localCommand(int64_t t) const {
+        return localTicks[slot(t)] == t ? localCommands[slot(t)] : PlayerCommand{};
+    }
+
+    // Confirmed command, or the newest confirmed one repeated
+    PlayerCommand remoteCommand(int64_t t) const {
+        if (t < 0) return PlayerCommand{};
+        if (remoteTicks[slot(t)] == t) return remoteCommands[slot(t)];
+        return lastConfirmedRemote;
+    }
+
+    void simulate(int64_t t, bool resimulating) {
+        world.save(snapshots[slot(t)]);
+
+        PlayerCommand commands[2];
+        PlayerCommand remote = remoteCommand(t);
+        usedRemote[slot(t)] = remote;
+        commands[config.localPlayer] = localCommand(t);
+        commands[1 - config.localPlayer] = remote;
+        step(commands, resimulating);
+    }
+
+    void updateChecksums() {
+        for (int64_t t = std::max(lastChecksum + 1, currentTick - Window + 1); t <= confirmedTick(); t++) {
+            checksums[slot(t)] = snapshotChecksum(snapshots[slot(t)]);
+            checksumTicks[slot(t)] = t;
+            lastChecksum = t;
+            compareChecksum(t);
+        }
+    }
+
+    void compareChecksum(int64_t t) {
+        if (checksumTicks[slot(t)] != t || peerChecksumTicks[slot(t)] != t) return;
+        compared++;
+        if (checksums[slot(t)] != peerChecksums[slot(t)] && desyncAt < 0)
+            desyncAt = t;
+    }
+
+    // header | ack | checksum tick, checksum | first tick, count, commands
+    void sendPacket(double now) {
+        int64_t first = std::max({ peerAck + 1, latestLocal - MaxPacketCommands + 1, int64_t(0) });
+        uint32_t count = latestLocal >= first ? static_cast<uint32_t>(latestLocal - first + 1) : 0;
+
+        packet.clear();
+        {
+            SnapshotWriter out(packet);
+            out.write(Magic);
+            out.write(config.sessionId);
+            out.write(remoteConfirmed);
+            out.write(lastChecksum);
+            out.write(lastChecksum >= 0 ? checksums[slot(lastChecksum)] : uint64_t(0));
+            out.write(first);
+            out.write(count);
+            for (int64_t t = first; t < first + count; t++) {
+                const PlayerCommand& c = localCommands[slot(t)];
+                out.write(c.moveX);
+                out.write(c.moveY);
+                out.write(c.aimX);
+                out.write(c.aimY);
+                out.write(c.buttons);
+            }
+        }
+        link.send(socket, packet.data(), packet.size(), now);
+    }
+
+    void receivePackets() {
+        int size;
+        while ((size = socket.receive(receiveBuffer, sizeof(receiveBuffer))) >= 0)
+            readPacket(receiveBuffer, static_cast<size_t>(size));
+    }
+
+    void readPacket(const uint8_t* data, size_t size) {
+        SnapshotReader in(data, size);
+        int64_t ack, checksumTick, first;
+        uint64_t checksum;
+        uint32_t count;
+        if (!in.expect(Magic) || !in.expect(config.sessionId)) return;
+        in.read(ack);
+        in.read(checksumTick);
+        in.read(checksum);
+        in.read(first);
+        if (!in.read(count) || count > MaxPacketCommands) return;
+        received++;
+
+        peerAck = std::max(peerAck, std::min(ack, latestLocal));
+
+        if (checksumTick >= 0 && checksumTick > currentTick - Window) {
+            peerChecksums[slot(checksumTick)] = checksum;
+            peerChecksumTicks[slot(checksumTick)] = checksumTick;
+            compareChecksum(checksumTick);
+        }
+
+        for (uint32_t i = 0; i < count; i++) {
+            PlayerCommand c;
+            in.read(c.moveX);
+            in.read(c.moveY);
+            in.read(c.aimX);
+            in.read(c.aimY);
+            in.read(c.buttons);
+            if (!in.good()) return;
+            storeRemote(first + i, c);
+        }
+
+        while (remoteTicks[slot(remoteConfirmed + 1)] == remoteConfirmed + 1) {
+            remoteConfirmed++;
+            lastConfirmedRemote = remoteCommands[slot(remoteConfirmed)];
+        }
+    }
+
+    void storeRemote(int64_t t, const PlayerCommand& c) {
+        if (t <= remoteConfirmed || t >= remoteConfirmed + Window) return;
+        if (remoteTicks[slot(t)] == t) return;
+
+        remoteCommands[slot(t)] = c;
+        remoteTicks[slot(t)] = t;
+
+        // Already simulated with a guess that turned out wrong
+        if (t < currentTick && !(usedRemote[slot(t)] == c))
+            rollbackFrom = std::min(rollbackFrom, t);
+    }
+};
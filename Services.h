@@ -1,4 +1,5 @@
 #pragma once
+#include "World.h"
 
 // Forward declarations
 class InputSystem;
@@ -8,6 +9,9 @@ class SoundManager;
 class EventHandler;
 class ProjectileSystem;
 class CollisionSystem;
+class RandomService;
+class Registry;
+class DamageSystem;
 
 struct Services {
 
@@ -19,25 +23,30 @@ struct Services {
     inline static EventHandler* eventHandler = nullptr;
     inline static ProjectileSystem* projectiles = nullptr;
 	inline static CollisionSystem* collisions = nullptr;
+    inline static RandomService* random = nullptr;
+    inline static Registry* registry = nullptr;
+    inline static DamageSystem* damage = nullptr;
 
 
-    // Initialize everything
+    // App-wide systems plus shortcuts to the world the app plays. Gameplay code
+    // reaches its own world through Actor2D::world instead.
     static void init(
         InputSystem* inputSystem_,
-        EventBus* eventBus_,
         AssetManager* assetManager_,
         SoundManager* soundManager_,
         EventHandler* eventHandler_,
-        ProjectileSystem* projectileSystem_,
-		CollisionSystem* collisionSystem_
+        World& world
     )
     {
         inputSystem = inputSystem_;
-        eventBus = eventBus_;
         assets = assetManager_;
         sound = soundManager_;
         eventHandler = eventHandler_;
-        projectiles = projectileSystem_;
-		collisions = collisionSystem_;
+        eventBus = world.eventBus.get();
+        projectiles = world.projectiles.get();
+		collisions = world.collisions.get();
+        random = world.random.get();
+        registry = world.registry.get();
+        damage = world.damage.get();
     }
 };
@@ -1,15 +1,21 @@
 #pragma once
 #include "Ship.h"
-#include "Services.h"
+#include "World.h"
 #include "Guns.h"
+#include "Pool.h"
 #include <memory>
+#include <vector>
 #include <glm/glm.hpp>
 
+// Ships come from their world's pools, recycled ones keep their collider,
+// components and hardpoints. Enemies have a pool of their own so a recycled
+// enemy always comes back armed; prewarmEnemies fills it with ready ships.
 class ShipFactory {
 public:
 
     // Spawn a generic ship at a position with optional scale and sprite
     static std::shared_ptr<Ship> spawnShip(
+        World& world,
         const glm::vec2& position,
         float rotation = 0.0f,
         const glm::vec2& scale = glm::vec2(50.0f),
@@ -17,39 +23,86 @@ public:
         int collisionLayer = CollisionLayer::Enemy, // default enemy layer
 		const float colliderScale = 0.8f
     ) {
-        auto ship = std::make_shared<Ship>();
-
-        ship->spriteName = spriteName;
-        ship->scale = scale;
-        ship->respawn(position, rotation);
-
-        // Screen bounds for AI/player ships
-        ship->screenMin = glm::vec2(0.0f);
-        ship->screenMax = glm::vec2(1920.0f, 1080.0f); // optionally configurable
+        return activate(world, *world.ships, position, rotation, scale, spriteName, collisionLayer, colliderScale);
+    }
 
-        // Collider
-        auto collider = std::make_shared<Collider2D>(Collider2D::ShapeType::Circle);
-        collider->layer = collisionLayer;
-        collider->mask = CollisionLayer::All; // collide with everything
-        collider->scale = glm::vec2(colliderScale);
-        ship->addChild(collider);
-        Services::collisions->addCollider(collider);
+    // Hand a ship back for reuse by a later spawn
+    static void despawn(World& world, std::shared_ptr<Ship> ship) {
+        world.ships->release(std::move(ship));
+    }
 
-        return ship;
+    static void prewarm(World& world, size_t count) {
+        World::Scope scope(world);
+        world.ships->prewarm(count);
+        for (auto& ship : world.ships->freeObjects())
+            ship->resetForPool();
     }
 
     // Convenience for spawning AI enemy ships
     static std::shared_ptr<Ship> spawnEnemy(
+        World& world,
         const glm::vec2& position,
         float rotation = 0.0f,
         const glm::vec2& scale = glm::vec2(50.0f),
         const std::string& spriteName = "enemy_ship_basic"
     ) {
-        auto enemyShip = spawnShip(position, rotation, scale, spriteName, CollisionLayer::Enemy, 0.9f);
+        return activateEnemy(world, position, rotation, scale, spriteName, true);
+    }
+
+    // Enemies go back to their own pool, armed
+    static void despawnEnemy(World& world, std::shared_ptr<Ship> ship) {
+        world.enemyShips->release(std::move(ship));
+    }
+
+    // Assembles enemies up to count waiting in the pool, collider registered and gun
+    // mounted, so spawning one later only resets and enables it. Nothing is announced,
+    // these ships never entered play
+    static void prewarmEnemies(World& world, size_t count) {
+        if (world.enemyShips->available() >= count) return;
 
-        enemyShip->getComponent<HealthComponent>()->setTeam(1);
+        std::vector<std::shared_ptr<Ship>> ready;
+        ready.reserve(count - world.enemyShips->available());
+        while (world.enemyShips->available() + ready.size() < count)
+            ready.push_back(activateEnemy(world, glm::vec2(0.0f), 0.0f, glm::vec2(50.0f), "enemy_ship_basic", false));
+        for (auto& ship : ready)
+            despawnEnemy(world, std::move(ship));
+    }
+
+    // Convenience for spawning player ships
+    static std::shared_ptr<Ship> spawnPlayer(
+        World& world,
+        const glm::vec2& position,
+        float rotation = 0.0f,
+        const glm::vec2& scale = glm::vec2(50.0f),
+        const std::string& spriteName = "ship"
+    ) {
+        auto ship = spawnShip(world, position, rotation, scale, spriteName, CollisionLayer::Player);
+        ship->setTeam(0);
+        return ship;
+    }
+
+private:
+    static std::shared_ptr<Ship> activateEnemy(
+        World& world,
+        const glm::vec2& position,
+        float rotation,
+        const glm::vec2& scale,
+        const std::string& spriteName,
+        bool announce
+    ) {
+        auto enemyShip = activate(world, *world.enemyShips, position, rotation, scale, spriteName, CollisionLayer::Enemy, 0.9f, announce);
+
+        enemyShip->setTeam(1);
+
+        // Recycled enemies still carry their gun, set up for another kind maybe
+        if (!enemyShip->hardpoints.empty()) {
+            if (auto gun = std::dynamic_pointer_cast<EnemyGun>(enemyShip->hardpoints[0]->weapon))
+                gun->resetToDefaults();
+            return enemyShip;
+        }
 
         // --- Add a single hardpoint with EnemyGun bound to action 0 ---
+        World::Scope scope(world);
         auto gun = std::make_shared<EnemyGun>();
         auto hardpoint = std::make_shared<Hardpoint>();
         hardpoint->position = vec2(0, -1.0f);
@@ -60,13 +113,39 @@ public:
         return enemyShip;
     }
 
-    // Convenience for spawning player ships
-    static std::shared_ptr<Ship> spawnPlayer(
+    // announce: emit the RespawnEvent, off while warming up a pool
+    static std::shared_ptr<Ship> activate(
+        World& world,
+        ObjectPool<Ship>& pool,
         const glm::vec2& position,
-        float rotation = 0.0f,
-        const glm::vec2& scale = glm::vec2(50.0f),
-        const std::string& spriteName = "ship"
+        float rotation,
+        const glm::vec2& scale,
+        const std::string& spriteName,
+        int collisionLayer,
+        float colliderScale,
+        bool announce = true
     ) {
-        return spawnShip(position, rotation, scale, spriteName, CollisionLayer::Player);
+        // New ships and their guns are built inside the world they spawn in
+        World::Scope scope(world);
+        auto ship = pool.acquire();
+
+        ship->spriteName = spriteName;
+        ship->scale = scale;
+        ship->rotation = rotation;
+        ship->resumePhysics();
+        ship->respawn(position, rotation, announce);
+
+        // Screen bounds for AI/player ships
+        ship->setScreenBounds(glm::vec2(0.0f), glm::vec2(World::ArenaWidth, World::ArenaHeight));
+
+        // Collider
+        if (!ship->collider)
+            ship->attachCollider(world.collisions->acquireCollider(Collider2D::ShapeType::Circle));
+        ship->collider->setEnabled(true);
+        ship->collider->layer = collisionLayer;
+        ship->collider->mask = CollisionLayer::All; // collide with everything
+        ship->collider->scale = glm::vec2(colliderScale);
+
+        return ship;
     }
 };
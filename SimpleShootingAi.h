@@ -1,5 +1,6 @@
 #pragma once
 #include "IControllable.h"
+#include "FlowField.h"
 #include <glm/glm.hpp>
 
 class SimpleShootingAi {
@@ -10,11 +11,13 @@ class SimpleShootingAi {
 
     glm::vec2 targetPosition = glm::vec2(0.0f);
     glm::vec2 targetVelocity = glm::vec2(0.0f);
+    bool aiming = false;            // last think aimed at the target
+    const FlowField* flowField = nullptr; // leads to the target, when given one
 
+public:
     float preferredDistance = 500.0f; // desired distance from target
     float maxMoveSpeed = 1.0f;        // normalized 0..1 input for pawn movement
 
-public:
     SimpleShootingAi() = default;
 
     void possess(IControllable* target) {
@@ -29,13 +32,20 @@ public:
         physPawn = nullptr;
     }
 
-    // Update the target info (from Director)
-    void setTarget(const glm::vec2& pos, const glm::vec2& vel) {
+    // Update the target info (from Director). With a field seeded from this target
+    // the AI closes in along it instead of straight on
+    void setTarget(const glm::vec2& pos, const glm::vec2& vel, const FlowField* field = nullptr) {
         targetPosition = pos;
         targetVelocity = vel;
+        flowField = field;
     }
 
     void update(double dt) {
+        think(dt);
+    }
+
+    // Full decision: keep the preferred distance, aim at the target, fire when in range
+    void think(double dt) {
         if (!pawn) return;
         glm::vec2 pawnPos = pawnPosition();
 
@@ -50,6 +60,11 @@ public:
 
         if (distance > preferredDistance + 20.0f) {
             moveInput = direction; // move toward
+
+            // Around obstacles, where the field knows a way
+            glm::vec2 flow = flowField ? flowField->direction(pawnPos) : glm::vec2(0.0f);
+            if (flow.x != 0.0f || flow.y != 0.0f)
+                moveInput = flow;
         }
         else if (distance < preferredDistance - 20.0f) {
             moveInput = -direction; // move away
@@ -88,6 +103,20 @@ public:
         if (tooClose) inRange = false; // don't fire when too close
         pawn->useAbility(0, inRange); // primary fire
         // Additional abilities can be handled similarly
+
+        aiming = !tooClose;
+    }
+
+    // Between thinks: keep the last move and fire decision, follow the target
+    // along its last known velocity with the aim
+    void coast(double dt) {
+        if (!pawn) return;
+        targetPosition += targetVelocity * static_cast<float>(dt);
+        if (!aiming) return;
+
+        glm::vec2 toTarget = targetPosition - pawnPosition();
+        if (glm::dot(toTarget, toTarget) > 1e-6f)
+            pawn->setAimDirection(glm::normalize(toTarget));
     }
 
     glm::vec2 pawnPosition() const {
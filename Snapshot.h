@@ -0,0 +1,159 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+
+
+// Flat, pointer-free byte streams for world snapshots.
+// Everything is written raw in native layout; a snapshot is only meant to be
+// read back by the same build (rollback, replays, divergence checks).
+// The writer grows the buffer geometrically and trims it to what was written
+// when it goes out of scope.
+class SnapshotWriter {
+public:
+    explicit SnapshotWriter(std::vector<uint8_t>& out) : out(out), used(out.size()) {}
+    ~SnapshotWriter() { out.resize(used); }
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    template <typename T>
+    void write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+        writeBytes(&value, sizeof(T));
+    }
+
+    void writeBytes(const void* data, size_t size) {
+        if (used + size > out.size())
+            out.resize(std::max(used + size, out.size() * 2 + 256));
+        std::memcpy(out.data() + used, data, size);
+        used += size;
+    }
+
+    template <typename T>
+    void writeVector(const std::vector<T>& values) {
+        static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+        write(static_cast<uint32_t>(values.size()));
+        if (!values.empty())
+            writeBytes(values.data(), values.size() * sizeof(T));
+    }
+
+    void writeString(const std::string& text) {
+        write(static_cast<uint32_t>(text.size()));
+        writeBytes(text.data(), text.size());
+    }
+
+    size_t size() const { return used; }
+
+private:
+    std::vector<uint8_t>& out;
+    size_t used;
+};
+
+
+// Reads what SnapshotWriter wrote. Any mismatch (short buffer, wrong count)
+// clears good() and every later read fails, so callers check once at the end.
+class SnapshotReader {
+public:
+    SnapshotReader(const uint8_t* data, size_t size) : cursor(data), end(data + size) {}
+    explicit SnapshotReader(const std::vector<uint8_t>& data) : SnapshotReader(data.data(), data.size()) {}
+
+    template <typename T>
+    bool read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>, "snapshot values must be trivially copyable");
+        return readBytes(&value, sizeof(T));
+    }
+
+    // Reads a value that has to match what the current world has (counts, type ids)
+    template <typename T>
+    bool expect(const T& value) {
+        T stored{};
+        if (!read(stored)) return false;
+        if (std::memcmp(&stored, &value, sizeof(T)) != 0) fail();
+        return ok;
+    }
+
+    bool readBytes(void* data, size_t size) {
+        if (!ok || size_t(end - cursor) < size) return fail();
+        std::memcpy(data, cursor, size);
+        cursor += size;
+        return true;
+    }
+
+    template <typename T>
+    bool readVector(std::vector<T>& values) {
+        uint32_t count = 0;
+        if (!read(count) || size_t(end - cursor) < size_t(count) * sizeof(T)) return fail();
+        values.resize(count);
+        return count == 0 || readBytes(values.data(), count * sizeof(T));
+    }
+
+    bool readString(std::string& text) {
+        uint32_t length = 0;
+        if (!read(length) || size_t(end - cursor) < length) return fail();
+        text.assign(reinterpret_cast<const char*>(cursor), length);
+        cursor += length;
+        return true;
+    }
+
+    bool fail() {
+        ok = false;
+        return false;
+    }
+
+    bool good() const { return ok; }
+    bool atEnd() const { return cursor == end; }
+
+private:
+    const uint8_t* cursor;
+    const uint8_t* end;
+    bool ok = true;
+};
+
+
+// Variable-length integers for compact streams (input recordings, spectator deltas):
+// 7 bits per byte, low bits first. zigzag maps small negative values to small codes.
+inline void writeVarint(std::vector<uint8_t>& out, uint64_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+inline bool readVarint(const uint8_t*& p, const uint8_t* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        uint8_t b = *p++;
+        v |= static_cast<uint64_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+inline uint64_t zigzag(int64_t v) { return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63); }
+inline int64_t unzigzag(uint64_t v) { return static_cast<int64_t>(v >> 1) ^ -static_cast<int64_t>(v & 1); }
+
+
+// 64-bit hash of a snapshot, 8 bytes per step
+inline uint64_t snapshotChecksum(const uint8_t* data, size_t size) {
+    uint64_t h = 0x9e3779b97f4a7c15ULL ^ size;
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = (h ^ word) * 0xff51afd7ed558ccdULL;
+        h ^= h >> 32;
+    }
+    for (; i < size; i++)
+        h = (h ^ data[i]) * 0x100000001b3ULL;
+    return h ^ (h >> 29);
+}
+
+inline uint64_t snapshotChecksum(const std::vector<uint8_t>& data) {
+    return snapshotChecksum(data.data(), data.size());
+}
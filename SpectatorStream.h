@@ -0,0 +1,653 @@
+#pragma once
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include "Actor.h"
+#include "PhysicalActor2D.h"
+#include "HealthComponent.h"
+#include "ProjectileSystem.h"
+#include "World.h"
+#include "NetTransport.h"
+#include "Snapshot.h"
+
+// Spectator streaming: the server sends the world to any number of observers over UDP.
+//
+// State is quantized (1/8 px positions, 16-bit angles) and each packet is a delta against
+// the newest packet the client acknowledged, so no packet depends on one that may be lost.
+// Positions are predicted from a velocity both sides already hold: anything flying
+// straight costs nothing until it turns, spawns or goes away. When a client's bandwidth
+// can't cover every change, per-client priority accumulators decide what goes out first
+// and the rest waits for a later packet.
+//
+//   server -> client   "V3SP" | u32 seq | u32 baseline seq | varint count | records by id
+//   record             varint id - previous id | u8 flags | the fields the flags name
+//   spawn              u8 kind | team << 2, zigzag x, y, vx, vy, u16 rotation, [u8 health]
+//   client -> server   "V3SA" | u32 newest seq held
+namespace Spectator {
+    constexpr uint32_t StateMagic = 0x50533356;     // "V3SP"
+    constexpr uint32_t AckMagic = 0x41533356;       // "V3SA"
+    constexpr uint32_t NoSeq = 0xffffffffu;
+    constexpr int Window = 32;                      // packets a baseline may trail the newest one
+    constexpr size_t HeaderBytes = 12;
+    constexpr float PositionSteps = 8.0f;           // 1/8 px
+    constexpr int VelocityShift = 3;                // velocities in 1/64 px, finer so straight paths predict for longer
+    constexpr float AngleSteps = 65536.0f / glm::two_pi<float>();
+
+    enum Kind : uint8_t { Actor = 1, Projectile = 2 };
+
+    enum RecordFlags : uint8_t {
+        Removed = 1 << 0,
+        Spawned = 1 << 1,       // every field, absolute; health only with Changed
+        Moved = 1 << 2,         // correction to the predicted position
+        Accelerated = 1 << 3,
+        Turned = 1 << 4,
+        Changed = 1 << 5,       // team and health
+    };
+
+    struct EntityState {
+        int32_t x = 0, y = 0;           // 1/8 px at tick
+        int32_t vx = 0, vy = 0;         // 1/64 px per packet
+        uint32_t tick = 0;              // seq of the packet the position belongs to
+        uint16_t rotation = 0;          // full turn = 65536
+        uint8_t kind = 0;               // 2 bits on the wire
+        uint8_t team = 0;               // 6 bits
+        uint8_t health = 0;             // 255 = full
+        bool present = false;
+        uint32_t generation = 0;        // server only, a reused id is a new entity
+
+        int32_t predictedX(uint32_t seq) const { return x + travelled(vx, seq); }
+        int32_t predictedY(uint32_t seq) const { return y + travelled(vy, seq); }
+
+        int32_t travelled(int32_t v, uint32_t seq) const {
+            int64_t steps = static_cast<int64_t>(v) * static_cast<int32_t>(seq - tick);
+            return static_cast<int32_t>((steps + (1 << (VelocityShift - 1))) >> VelocityShift);
+        }
+
+        glm::vec2 position(uint32_t seq) const { return glm::vec2(predictedX(seq), predictedY(seq)) / PositionSteps; }
+        float angle() const { return rotation / AngleSteps; }
+
+        // Everything a client can know about
+        bool sameAs(const EntityState& o) const {
+            if (present != o.present) return false;
+            return !present || (x == o.x && y == o.y && vx == o.vx && vy == o.vy && tick == o.tick &&
+                rotation == o.rotation && kind == o.kind && team == o.team && health == o.health);
+        }
+    };
+
+    inline const EntityState& stateAt(const std::vector<EntityState>& states, size_t id) {
+        static const EntityState absent;
+        return id < states.size() ? states[id] : absent;
+    }
+
+    inline int32_t quantizePosition(float v) { return static_cast<int32_t>(std::lround(v * PositionSteps)); }
+    inline uint16_t quantizeAngle(float radians) { return static_cast<uint16_t>(std::lround(radians * AngleSteps) & 0xffff); }
+
+    inline int32_t angleDelta(uint16_t from, uint16_t to) { return static_cast<int16_t>(static_cast<uint16_t>(to - from)); }
+
+    inline void writeSigned(std::vector<uint8_t>& out, int64_t v) { writeVarint(out, zigzag(v)); }
+
+    inline bool readSigned(const uint8_t*& p, const uint8_t* end, int32_t& v) {
+        uint64_t raw;
+        if (!readVarint(p, end, raw)) return false;
+        v = static_cast<int32_t>(unzigzag(raw));
+        return true;
+    }
+
+    inline bool readByte(const uint8_t*& p, const uint8_t* end, uint8_t& v) {
+        if (p == end) return false;
+        v = *p++;
+        return true;
+    }
+
+    // Record turning what the client holds (had) into now, exact once it goes out
+    inline void encodeRecord(std::vector<uint8_t>& out, const EntityState& had, const EntityState& now, uint32_t seq) {
+        if (!now.present) {
+            out.push_back(Removed);
+            return;
+        }
+
+        if (!had.present || had.generation != now.generation || had.kind != now.kind) {
+            bool hurt = now.health != 255;
+            out.push_back(hurt ? Spawned | Changed : Spawned);
+            out.push_back(static_cast<uint8_t>(now.kind | now.team << 2));
+            writeSigned(out, now.x);
+            writeSigned(out, now.y);
+            writeSigned(out, now.vx);
+            writeSigned(out, now.vy);
+            out.push_back(static_cast<uint8_t>(now.rotation));
+            out.push_back(static_cast<uint8_t>(now.rotation >> 8));
+            if (hurt) out.push_back(now.health);
+            return;
+        }
+
+        int32_t dx = now.x - had.predictedX(seq), dy = now.y - had.predictedY(seq);
+        uint8_t flags = 0;
+        if (dx || dy) flags |= Moved;
+        if (now.vx != had.vx || now.vy != had.vy) flags |= Accelerated;
+        if (now.rotation != had.rotation) flags |= Turned;
+        if (now.team != had.team || now.health != had.health) flags |= Changed;
+
+        out.push_back(flags);
+        if (flags & Moved) { writeSigned(out, dx); writeSigned(out, dy); }
+        if (flags & Accelerated) { writeSigned(out, now.vx - had.vx); writeSigned(out, now.vy - had.vy); }
+        if (flags & Turned) writeSigned(out, angleDelta(had.rotation, now.rotation));
+        if (flags & Changed) { out.push_back(now.team); out.push_back(now.health); }
+    }
+
+    // The client's side of encodeRecord; the server runs it too, so both hold the same view
+    inline bool applyRecord(EntityState& e, const uint8_t*& p, const uint8_t* end, uint32_t seq) {
+        uint8_t flags;
+        if (!readByte(p, end, flags)) return false;
+
+        if (flags & Removed) {
+            e = EntityState{};
+            return true;
+        }
+
+        if (flags & Spawned) {
+            e = EntityState{};
+            uint8_t kindTeam, low, high;
+            e.health = 255;
+            if (!readByte(p, end, kindTeam) ||
+                !readSigned(p, end, e.x) || !readSigned(p, end, e.y) ||
+                !readSigned(p, end, e.vx) || !readSigned(p, end, e.vy) ||
+                !readByte(p, end, low) || !readByte(p, end, high) ||
+                ((flags & Changed) && !readByte(p, end, e.health)))
+                return false;
+            e.kind = kindTeam & 3;
+            e.team = kindTeam >> 2;
+            e.rotation = static_cast<uint16_t>(low | high << 8);
+            e.tick = seq;
+            e.present = true;
+            return true;
+        }
+
+        if (!e.present) return false;
+
+        int32_t x = e.predictedX(seq), y = e.predictedY(seq);
+        int32_t a, b;
+        if (flags & Moved) {
+            if (!readSigned(p, end, a) || !readSigned(p, end, b)) return false;
+            x += a;
+            y += b;
+        }
+        e.x = x;
+        e.y = y;
+        e.tick = seq;
+
+        if (flags & Accelerated) {
+            if (!readSigned(p, end, a) || !readSigned(p, end, b)) return false;
+            e.vx += a;
+            e.vy += b;
+        }
+        if (flags & Turned) {
+            if (!readSigned(p, end, a)) return false;
+            e.rotation = static_cast<uint16_t>(e.rotation + a);
+        }
+        if (flags & Changed) {
+            if (!readByte(p, end, e.team) || !readByte(p, end, e.health)) return false;
+        }
+        return true;
+    }
+}
+
+
+// Streams tracked actors and the world's projectiles to every client that sends it an ack.
+// Ids: tracked actors first, in track() order, then the reserveDynamic() slots for actors
+// that come and go, then projectile slots; track and reserve before the first publish.
+class SpectatorServer {
+public:
+    static constexpr size_t MaxClients = 32;
+
+    struct Settings {
+        double sendRate = 30.0;             // publish() calls per second
+        size_t bytesPerSecond = 24 * 1024;  // per client
+        size_t maxPacket = 1200;            // under a typical MTU
+        int32_t positionTolerance = 4;      // 1/8 px the prediction may drift before a correction is due
+        int32_t velocityTolerance = 8;      // 1/64 px per packet
+        int32_t angleTolerance = 256;       // 1/256 turn
+        float actorPriority = 8.0f;
+        float projectilePriority = 1.0f;
+        float spawnPriority = 4.0f;         // times the above for spawns and removals
+        double clientTimeout = 5.0;
+    };
+
+    struct ClientStats {
+        uint64_t packets = 0;
+        uint64_t bytes = 0;
+        uint64_t records = 0;
+        uint64_t deferred = 0;              // changes that didn't fit and waited
+        double positionError = 0.0;         // px, summed over compared entities
+        uint64_t compared = 0;
+        uint64_t missing = 0;               // on the server, not yet on the client (or an older one in its id)
+        uint64_t stale = 0;                 // still on the client, gone on the server
+    };
+
+    Settings settings;
+    LinkConditioner link;
+
+    explicit SpectatorServer(World& world) : source(world) {}
+
+    bool open(uint16_t port) { return socket.open(port); }
+    uint16_t localPort() const { return socket.localPort(); }
+
+    void track(Actor2D* actor) {
+        actors.push_back(actor);
+        physical.push_back(dynamic_cast<PhysicalActor2D*>(actor));
+    }
+
+    // Slots for actors added and removed during the match, e.g. pooled enemies
+    void reserveDynamic(size_t count) {
+        dynamicActors.resize(count, nullptr);
+        dynamicPhysical.resize(count, nullptr);
+        dynamicGenerations.resize(count, 0);
+    }
+
+    // Takes a free slot, a reused one reads as a new entity. False when all are taken
+    bool addDynamic(Actor2D* actor) {
+        for (size_t i = 0; i < dynamicActors.size(); i++) {
+            if (dynamicActors[i]) continue;
+            dynamicActors[i] = actor;
+            dynamicPhysical[i] = dynamic_cast<PhysicalActor2D*>(actor);
+            dynamicGenerations[i]++;
+            return true;
+        }
+        return false;
+    }
+
+    void removeDynamic(Actor2D* actor) {
+        for (size_t i = 0; i < dynamicActors.size(); i++) {
+            if (dynamicActors[i] != actor) continue;
+            dynamicActors[i] = nullptr;
+            dynamicPhysical[i] = nullptr;
+            return;
+        }
+    }
+
+    // Reads acks, takes the world's state and sends each client its delta
+    void publish(double now) {
+        receiveAcks(now);
+        gather();
+
+        for (size_t i = 0; i < clients.size();) {
+            if (now - clients[i].lastHeard > settings.clientTimeout) {
+                clients.erase(clients.begin() + i);
+                continue;
+            }
+            sendTo(clients[i], now);
+            i++;
+        }
+
+        link.flush(socket, now);
+        seq++;
+    }
+
+    uint32_t sequence() const { return seq; }
+    const std::vector<Spectator::EntityState>& world() const { return current; }
+
+    size_t clientCount() const { return clients.size(); }
+    const ClientStats& clientStats(size_t i) const { return clients[i].stats; }
+
+    int findClient(const NetAddress& address) const {
+        for (size_t i = 0; i < clients.size(); i++)
+            if (clients[i].address == address) return static_cast<int>(i);
+        return -1;
+    }
+
+    // What a client holds once it has packet s, while s is in the window
+    const std::vector<Spectator::EntityState>* sentView(size_t client, uint32_t s) const {
+        const Client& c = clients[client];
+        return c.viewSeq[slot(s)] == s ? &c.views[slot(s)] : nullptr;
+    }
+
+private:
+    struct Client {
+        NetAddress address;
+        double lastHeard = 0.0;
+        uint32_t acked = Spectator::NoSeq;
+        double budget = 0.0;            // bytes
+        std::array<std::vector<Spectator::EntityState>, Spectator::Window> views;
+        std::array<uint32_t, Spectator::Window> viewSeq;
+        std::vector<float> priority;    // per id, grows while a change waits
+        ClientStats stats;
+
+        Client() { viewSeq.fill(Spectator::NoSeq); }
+    };
+
+    struct Candidate {
+        uint32_t id;
+        float priority;
+    };
+
+    struct Record {
+        uint32_t id;
+        uint32_t offset, size;
+    };
+
+    World& source;
+    UdpSocket socket;
+    std::vector<Actor2D*> actors;
+    std::vector<PhysicalActor2D*> physical;     // for velocities, null for other actors
+    std::vector<Actor2D*> dynamicActors;        // per reserved slot, null when free
+    std::vector<PhysicalActor2D*> dynamicPhysical;
+    std::vector<uint32_t> dynamicGenerations;
+    std::vector<Client> clients;
+    uint32_t seq = 0;
+
+    std::vector<Spectator::EntityState> current, previous;
+    std::vector<glm::vec2> positions, previousPositions;    // unrounded, for velocities
+    const std::vector<Spectator::EntityState> empty;
+
+    // Scratch reused every publish
+    std::vector<Candidate> candidates;
+    std::vector<Record> records;
+    std::vector<uint8_t> recordBytes;
+    std::vector<uint8_t> packet;
+    uint8_t receiveBuffer[64];
+
+    static size_t slot(uint32_t s) { return s % Spectator::Window; }
+
+    void receiveAcks(double now) {
+        NetAddress from;
+        int size;
+        while ((size = socket.receiveFrom(receiveBuffer, sizeof(receiveBuffer), from)) >= 0) {
+            SnapshotReader in(receiveBuffer, static_cast<size_t>(size));
+            uint32_t ack;
+            if (!in.expect(Spectator::AckMagic) || !in.read(ack)) continue;
+
+            int index = findClient(from);
+            if (index < 0) {
+                if (clients.size() == MaxClients) continue;
+                clients.emplace_back();
+                clients.back().address = from;
+                index = static_cast<int>(clients.size() - 1);
+            }
+
+            Client& c = clients[index];
+            c.lastHeard = now;
+            if (ack != Spectator::NoSeq && ack < seq && (c.acked == Spectator::NoSeq || ack > c.acked))
+                c.acked = ack;
+        }
+    }
+
+    void gather() {
+        using namespace Spectator;
+        previous.swap(current);
+        previousPositions.swap(positions);
+
+        size_t slots = 0;
+        for (auto& p : source.projectiles->projectiles)
+            slots = std::max<size_t>(slots, p->handle.slot + 1);
+        const size_t firstProjectile = actors.size() + dynamicActors.size();
+        current.assign(firstProjectile + slots, EntityState{});
+        positions.resize(current.size());
+
+        const float velocityScale = PositionSteps * (1 << VelocityShift);
+        auto take = [&](size_t id, Transform2D& t, const glm::vec2* velocity, uint8_t kind, uint32_t generation, int team, float health) {
+            EntityState& e = current[id];
+            e.present = true;
+            e.kind = kind;
+            e.generation = generation;
+            e.team = static_cast<uint8_t>(team);
+            e.health = static_cast<uint8_t>(std::lround(std::clamp(health, 0.0f, 1.0f) * 255.0f));
+            e.x = quantizePosition(t.position.x);
+            e.y = quantizePosition(t.position.y);
+            e.rotation = quantizeAngle(t.rotation);
+            e.tick = seq;
+            positions[id] = t.position;
+
+            // Per packet, in the units the prediction steps in. Without a velocity of its
+            // own the entity's movement since the last publish stands in, from its second one on
+            glm::vec2 step(0.0f);
+            const EntityState& before = stateAt(previous, id);
+            if (velocity)
+                step = *velocity * static_cast<float>(1.0 / settings.sendRate);
+            else if (before.present && before.generation == generation && before.kind == kind)
+                step = t.position - previousPositions[id];
+            e.vx = static_cast<int32_t>(std::lround(step.x * velocityScale));
+            e.vy = static_cast<int32_t>(std::lround(step.y * velocityScale));
+        };
+
+        auto takeActor = [&](size_t id, Actor2D& actor, PhysicalActor2D* physics, uint32_t generation) {
+            auto health = actor.getComponent<HealthComponent>();
+            float fraction = health && health->maxHealth > 0.0f ? health->health / health->maxHealth : 1.0f;
+            glm::vec2 velocity = physics ? physics->getVelocity() : glm::vec2(0.0f);
+            take(id, actor, physics ? &velocity : nullptr, Spectator::Actor, generation, health ? health->team : 0, fraction);
+        };
+        for (size_t i = 0; i < actors.size(); i++)
+            takeActor(i, *actors[i], physical[i], 0);
+        for (size_t i = 0; i < dynamicActors.size(); i++)
+            if (dynamicActors[i]) takeActor(actors.size() + i, *dynamicActors[i], dynamicPhysical[i], dynamicGenerations[i]);
+
+        for (auto& p : source.projectiles->projectiles)
+            take(firstProjectile + p->handle.slot, *p, &p->velocity, Spectator::Projectile, p->handle.generation, p->team, 1.0f);
+    }
+
+    // Worth a packet: the prediction has drifted or something visible changed
+    bool needsUpdate(const Spectator::EntityState& had, const Spectator::EntityState& now) const {
+        if (!had.present || !now.present) return had.present != now.present;
+        if (had.generation != now.generation || had.kind != now.kind) return true;
+        if (had.team != now.team || had.health != now.health) return true;
+        if (std::abs(now.x - had.predictedX(seq)) > settings.positionTolerance ||
+            std::abs(now.y - had.predictedY(seq)) > settings.positionTolerance)
+            return true;
+        if (std::abs(now.vx - had.vx) > settings.velocityTolerance ||
+            std::abs(now.vy - had.vy) > settings.velocityTolerance)
+            return true;
+        return std::abs(Spectator::angleDelta(had.rotation, now.rotation)) > settings.angleTolerance;
+    }
+
+    float weight(const Spectator::EntityState& had, const Spectator::EntityState& now) const {
+        const Spectator::EntityState& e = now.present ? now : had;
+        float w = e.kind == Spectator::Actor ? settings.actorPriority : settings.projectilePriority;
+        if (!had.present || !now.present || had.generation != now.generation) w *= settings.spawnPriority;
+        return w;
+    }
+
+    static size_t varintSize(uint64_t v) {
+        size_t n = 1;
+        while (v >= 0x80) { v >>= 7; n++; }
+        return n;
+    }
+
+    void sendTo(Client& c, double now) {
+        using namespace Spectator;
+
+        // Baseline: the newest view the client has confirmed, or nothing
+        uint32_t baseSeq = NoSeq;
+        if (c.acked != NoSeq && seq - c.acked < Window && c.viewSeq[slot(c.acked)] == c.acked)
+            baseSeq = c.acked;
+        std::vector<EntityState>& view = c.views[slot(seq)];
+        view = baseSeq != NoSeq ? c.views[slot(baseSeq)] : empty;
+        c.viewSeq[slot(seq)] = seq;
+
+        size_t count = std::max(current.size(), view.size());
+        view.resize(count);
+        c.priority.resize(std::max(c.priority.size(), count), 0.0f);
+
+        candidates.clear();
+        for (size_t id = 0; id < count; id++) {
+            const EntityState& now = stateAt(current, id);
+            if (!needsUpdate(view[id], now)) {
+                c.priority[id] = 0.0f;
+                continue;
+            }
+            c.priority[id] += weight(view[id], now);
+            candidates.push_back({ static_cast<uint32_t>(id), c.priority[id] });
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.priority != b.priority ? a.priority > b.priority : a.id < b.id;
+        });
+
+        // Token bucket: a packet may spend what has built up, up to two packets' worth
+        double perPacket = settings.bytesPerSecond / settings.sendRate;
+        c.budget = std::min(c.budget + perPacket, perPacket * 2.0);
+        size_t limit = std::min(settings.maxPacket, static_cast<size_t>(std::max(c.budget, 0.0)));
+        size_t used = HeaderBytes + 3;
+
+        records.clear();
+        recordBytes.clear();
+        for (const Candidate& candidate : candidates) {
+            size_t start = recordBytes.size();
+            EntityState& held = view[candidate.id];
+            const EntityState& now = stateAt(current, candidate.id);
+            encodeRecord(recordBytes, held, now, seq);
+
+            size_t size = recordBytes.size() - start + varintSize(candidate.id);
+            if (used + size > limit) {
+                recordBytes.resize(start);
+                c.stats.deferred++;
+                continue;
+            }
+            used += size;
+
+            const uint8_t* p = recordBytes.data() + start;
+            applyRecord(held, p, recordBytes.data() + recordBytes.size(), seq);
+            held.generation = now.generation;
+            c.priority[candidate.id] = 0.0f;
+            records.push_back({ candidate.id, static_cast<uint32_t>(start), static_cast<uint32_t>(recordBytes.size() - start) });
+        }
+        std::sort(records.begin(), records.end(), [](const Record& a, const Record& b) { return a.id < b.id; });
+
+        packet.clear();
+        {
+            SnapshotWriter out(packet);
+            out.write(StateMagic);
+            out.write(seq);
+            out.write(baseSeq);
+        }
+        writeVarint(packet, records.size());
+        uint32_t previousId = 0;
+        for (const Record& r : records) {
+            writeVarint(packet, r.id - previousId);
+            previousId = r.id;
+            packet.insert(packet.end(), recordBytes.begin() + r.offset, recordBytes.begin() + r.offset + r.size);
+        }
+
+        link.sendTo(socket, c.address, packet.data(), packet.size(), now);
+        c.budget -= static_cast<double>(packet.size());
+        c.stats.packets++;
+        c.stats.bytes += packet.size();
+        c.stats.records += records.size();
+        measure(c, view);
+    }
+
+    // How far the client's picture is from the world after this packet
+    void measure(Client& c, const std::vector<Spectator::EntityState>& view) {
+        using namespace Spectator;
+        for (size_t id = 0; id < view.size(); id++) {
+            const EntityState& truth = stateAt(current, id);
+            const EntityState& held = view[id];
+            if (truth.present && (!held.present || held.generation != truth.generation)) c.stats.missing++;
+            else if (!truth.present && held.present) c.stats.stale++;
+            else if (truth.present) {
+                glm::vec2 error = held.position(seq) - truth.position(seq);
+                c.stats.positionError += glm::length(error);
+                c.stats.compared++;
+            }
+        }
+    }
+};
+
+
+// Headless observer: rebuilds the server's view from its deltas and acknowledges them
+class SpectatorClient {
+public:
+    LinkConditioner link;
+
+    bool connect(const char* host, uint16_t port) { return socket.open(0) && socket.setPeer(host, port); }
+    bool connect(const char* address) { return socket.open(0) && socket.setPeer(address); }
+    uint16_t localPort() const { return socket.localPort(); }
+
+    // Reads every waiting packet and acks the newest; call every frame
+    void update(double now) {
+        bool got = false;
+        int size;
+        while ((size = socket.receive(receiveBuffer, sizeof(receiveBuffer))) >= 0)
+            got |= readPacket(receiveBuffer, static_cast<size_t>(size));
+
+        // Until the first packet the ack is a hello, repeated in case it was lost
+        if (got || now - lastAck >= 0.25) {
+            uint8_t ack[8];
+            std::memcpy(ack, &Spectator::AckMagic, 4);
+            std::memcpy(ack + 4, &newest, 4);
+            link.send(socket, ack, sizeof(ack), now);
+            lastAck = now;
+        }
+        link.flush(socket, now);
+    }
+
+    // Newest packet held, NoSeq before the first one
+    uint32_t sequence() const { return newest; }
+
+    const std::vector<Spectator::EntityState>& entities() const {
+        static const std::vector<Spectator::EntityState> none;
+        return newest == Spectator::NoSeq ? none : views[slot(newest)];
+    }
+
+    uint64_t packetsReceived() const { return received; }
+    uint64_t packetsRejected() const { return rejected; }
+    uint64_t bytesReceived() const { return bytes; }
+
+private:
+    UdpSocket socket;
+    std::array<std::vector<Spectator::EntityState>, Spectator::Window> views;
+    std::array<uint32_t, Spectator::Window> viewSeq = filledSeqs();
+    std::vector<Spectator::EntityState> decoding;
+    uint32_t newest = Spectator::NoSeq;
+    double lastAck = -1.0;
+    uint64_t received = 0, rejected = 0, bytes = 0;
+    uint8_t receiveBuffer[2048];
+
+    static size_t slot(uint32_t s) { return s % Spectator::Window; }
+
+    static std::array<uint32_t, Spectator::Window> filledSeqs() {
+        std::array<uint32_t, Spectator::Window> seqs;
+        seqs.fill(Spectator::NoSeq);
+        return seqs;
+    }
+
+    bool readPacket(const uint8_t* data, size_t size) {
+        using namespace Spectator;
+        SnapshotReader in(data, size);
+        uint32_t s, baseSeq;
+        if (!in.expect(StateMagic) || !in.read(s) || !in.read(baseSeq)) return reject();
+
+        // Duplicates and packets older than anything a baseline could be
+        if (viewSeq[slot(s)] == s) return false;
+        if (newest != NoSeq && s + Window <= newest) return false;
+        if (baseSeq != NoSeq && viewSeq[slot(baseSeq)] != baseSeq) return reject();
+
+        static const std::vector<EntityState> none;
+        decoding = baseSeq != NoSeq ? views[slot(baseSeq)] : none;
+
+        const uint8_t* p = data + HeaderBytes;
+        const uint8_t* end = data + size;
+        uint64_t count, id = 0, step;
+        if (!readVarint(p, end, count)) return reject();
+        for (uint64_t i = 0; i < count; i++) {
+            if (!readVarint(p, end, step)) return reject();
+            id += step;
+            if (id >= (1u << 20)) return reject();
+            if (id >= decoding.size()) decoding.resize(id + 1);
+            if (!applyRecord(decoding[id], p, end, s)) return reject();
+        }
+        if (p != end) return reject();
+
+        views[slot(s)].swap(decoding);
+        viewSeq[slot(s)] = s;
+        if (newest == NoSeq || s > newest) newest = s;
+        received++;
+        bytes += size;
+        return true;
+    }
+
+    bool reject() {
+        rejected++;
+        return false;
+    }
+};
@@ -0,0 +1,191 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "IControllable.h"
+#include "ship.h"
+#include "FlowField.h"
+
+// SimpleShootingAi for a whole swarm at once. Every pawn is a slot in flat arrays, and
+// update() runs three passes over them: read pawn positions, decide move/aim/fire for
+// all slots in one branch-free loop the compiler can vectorize, then hand the decisions
+// to the pawns. Ships get theirs written directly, with fire only sent when it changes;
+// other pawns go through IControllable like SimpleShootingAi does.
+//
+// Decisions match SimpleShootingAi given the same pawn position, target and settings,
+// flow field included. Like there, a slot's field should be seeded from its own target
+// only; one seeded from several leads to the nearest of them.
+class SwarmController {
+public:
+    // Returns the pawn's slot. Slots move when pawns are removed, see remove()
+    size_t add(IControllable* pawn, float preferredDistance = 500.0f, float maxMoveSpeed = 1.0f) {
+        pawns.push_back(pawn);
+        actors.push_back(dynamic_cast<Actor2D*>(pawn));
+        ships.push_back(dynamic_cast<Ship*>(pawn));
+        posX.push_back(0.0f);
+        posY.push_back(0.0f);
+        flowX.push_back(0.0f);
+        flowY.push_back(0.0f);
+        targetX.push_back(0.0f);
+        targetY.push_back(0.0f);
+        fields.push_back(nullptr);
+        preferred.push_back(preferredDistance);
+        maxSpeed.push_back(maxMoveSpeed);
+        moveX.push_back(0.0f);
+        moveY.push_back(0.0f);
+        aimX.push_back(0.0f);
+        aimY.push_back(0.0f);
+        fire.push_back(0);
+        sentFire.push_back(FireUnknown);
+        return pawns.size() - 1;
+    }
+
+    // The last slot moves into the removed one
+    void remove(IControllable* pawn) {
+        for (size_t i = 0; i < pawns.size(); i++) {
+            if (pawns[i] != pawn) continue;
+            removeAt(i);
+            return;
+        }
+    }
+
+    void removeAt(size_t slot) {
+        size_t last = pawns.size() - 1;
+        pawns[slot] = pawns[last];          pawns.pop_back();
+        actors[slot] = actors[last];        actors.pop_back();
+        ships[slot] = ships[last];          ships.pop_back();
+        posX[slot] = posX[last];            posX.pop_back();
+        posY[slot] = posY[last];            posY.pop_back();
+        flowX[slot] = flowX[last];          flowX.pop_back();
+        flowY[slot] = flowY[last];          flowY.pop_back();
+        targetX[slot] = targetX[last];      targetX.pop_back();
+        targetY[slot] = targetY[last];      targetY.pop_back();
+        fields[slot] = fields[last];        fields.pop_back();
+        preferred[slot] = preferred[last];  preferred.pop_back();
+        maxSpeed[slot] = maxSpeed[last];    maxSpeed.pop_back();
+        moveX[slot] = moveX[last];          moveX.pop_back();
+        moveY[slot] = moveY[last];          moveY.pop_back();
+        aimX[slot] = aimX[last];            aimX.pop_back();
+        aimY[slot] = aimY[last];            aimY.pop_back();
+        fire[slot] = fire[last];            fire.pop_back();
+        sentFire[slot] = sentFire[last];    sentFire.pop_back();
+    }
+
+    size_t size() const { return pawns.size(); }
+    IControllable* pawnAt(size_t slot) const { return pawns[slot]; }
+
+    // Pawns closing in follow the field where it has a direction, see SimpleShootingAi
+    void setTarget(size_t slot, const glm::vec2& position, const FlowField* field = nullptr) {
+        targetX[slot] = position.x;
+        targetY[slot] = position.y;
+        fields[slot] = field;
+    }
+
+    void setPreferredDistance(size_t slot, float distance) { preferred[slot] = distance; }
+    void setMaxMoveSpeed(size_t slot, float speed) { maxSpeed[slot] = speed; }
+
+    void update() {
+        gather();
+        decide();
+        apply();
+    }
+
+    // Last decisions, what was handed to the pawn
+    glm::vec2 moveOf(size_t slot) const { return glm::vec2(moveX[slot], moveY[slot]); }
+    glm::vec2 aimOf(size_t slot) const { return glm::vec2(aimX[slot], aimY[slot]); }
+    bool fireOf(size_t slot) const { return fire[slot] != 0; }
+
+private:
+    static constexpr int8_t FireUnknown = -1;
+
+    void gather() {
+        for (size_t i = 0; i < actors.size(); i++) {
+            glm::vec2 p = actors[i] ? actors[i]->getWorldPosition() : glm::vec2(0.0f);
+            posX[i] = p.x;
+            posY[i] = p.y;
+            glm::vec2 flow = fields[i] ? fields[i]->direction(p) : glm::vec2(0.0f);
+            flowX[i] = flow.x;
+            flowY[i] = flow.y;
+        }
+    }
+
+    // SimpleShootingAi::think() on flat arrays. The arithmetic follows glm's length and
+    // normalize step by step so the results come out bit for bit the same
+    void decide() {
+        const size_t n = pawns.size();
+        const float* px = posX.data();
+        const float* py = posY.data();
+        const float* tx = targetX.data();
+        const float* ty = targetY.data();
+        const float* fx = flowX.data();
+        const float* fy = flowY.data();
+        const float* pd = preferred.data();
+        const float* speed = maxSpeed.data();
+        float* mx = moveX.data();
+        float* my = moveY.data();
+        float* ax = aimX.data();
+        float* ay = aimY.data();
+        uint8_t* shoot = fire.data();
+
+        for (size_t i = 0; i < n; i++) {
+            float dx = tx[i] - px[i];
+            float dy = ty[i] - py[i];
+            float distSqr = dx * dx + dy * dy;
+            float distance = std::sqrt(distSqr);
+            float inv = distance > 0.001f ? 1.0f / std::sqrt(distSqr) : 0.0f;
+            float dirX = dx * inv;
+            float dirY = dy * inv;
+
+            // Toward when too far, away when too close
+            float sign = distance > pd[i] + 20.0f ? 1.0f : (distance < pd[i] - 20.0f ? -1.0f : 0.0f);
+            bool followFlow = sign > 0.0f && (fx[i] != 0.0f || fy[i] != 0.0f);
+            float moveInX = followFlow ? fx[i] : dirX * sign;
+            float moveInY = followFlow ? fy[i] : dirY * sign;
+            float moveLen = std::sqrt(moveInX * moveInX + moveInY * moveInY);
+            mx[i] = moveLen > 1.0f ? moveInX / moveLen * speed[i] : moveInX * speed[i];
+            my[i] = moveLen > 1.0f ? moveInY / moveLen * speed[i] : moveInY * speed[i];
+
+            // No aiming or firing while backing off
+            bool tooClose = distance < pd[i] * 0.7f;
+            ax[i] = tooClose ? 0.0f : dirX;
+            ay[i] = tooClose ? 0.0f : dirY;
+            shoot[i] = !tooClose && distance <= pd[i] * 3.0f;
+        }
+    }
+
+    void apply() {
+        for (size_t i = 0; i < pawns.size(); i++) {
+            if (Ship* ship = ships[i]) {
+                ship->setThrust(glm::vec2(moveX[i], moveY[i]));
+                ship->setDirection(glm::vec2(aimX[i], aimY[i]));
+
+                // Dead ships ignore fire, send it again once the ship is back
+                if (ship->isDead()) sentFire[i] = FireUnknown;
+                else if (sentFire[i] != fire[i]) {
+                    ship->useAbility(0, fire[i] != 0);
+                    sentFire[i] = static_cast<int8_t>(fire[i]);
+                }
+            }
+            else if (pawns[i]) {
+                pawns[i]->setMoveDirection(glm::vec2(moveX[i], moveY[i]));
+                pawns[i]->setAimDirection(glm::vec2(aimX[i], aimY[i]));
+                pawns[i]->useAbility(0, fire[i] != 0);
+            }
+        }
+    }
+
+    // Per slot
+    std::vector<IControllable*> pawns;
+    std::vector<Actor2D*> actors;       // position source, null when the pawn isn't an actor
+    std::vector<Ship*> ships;           // written directly, null for other pawns
+    std::vector<float> posX, posY;
+    std::vector<float> flowX, flowY;    // field direction at the pawn, zero without one
+    std::vector<float> targetX, targetY;
+    std::vector<const FlowField*> fields;   // seeded from the slot's target, null for none
+    std::vector<float> preferred, maxSpeed;
+    std::vector<float> moveX, moveY, aimX, aimY;
+    std::vector<uint8_t> fire;
+    std::vector<int8_t> sentFire;       // last fire given to a ship, FireUnknown to resend
+};
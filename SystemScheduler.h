@@ -0,0 +1,86 @@
+#pragma once
+#include <vector>
+#include <functional>
+#include <algorithm>
+#include <type_traits>
+#include "Registry.h"
+#include "BaseComponent.h"
+#include "Physics.h"
+#include "HealthComponent.h"
+
+
+// Fixed slots for the update passes, lower runs first
+namespace UpdateOrder {
+    constexpr int Physics = 100;
+    constexpr int Constraints = 200;    // position fix-ups that need integrated velocities
+    constexpr int Health = 300;
+}
+
+// True when T declares its own update instead of inheriting the empty BaseComponent one
+template <typename T>
+constexpr bool hasOwnUpdate = !std::is_same_v<decltype(&T::update), void (BaseComponent::*)(double)>;
+
+
+// Runs component updates one type at a time over the registry's columns.
+// Each pass is a single linear loop with a non-virtual call per component,
+// instead of every actor walking its own components through the vtable.
+class SystemScheduler {
+public:
+    using PassFn = std::function<void(Registry&, double)>;
+
+    // Returns false (and registers nothing) when T::update is the empty default
+    template <typename T>
+    bool addComponentPass(int order) {
+        static_assert(std::is_base_of<BaseComponent, T>::value, "T must inherit BaseComponent");
+
+        if constexpr (!hasOwnUpdate<T>) {
+            return false;
+        }
+        else {
+            addPass(order, [](Registry& registry, double dt) {
+                registry.view<T>().each([dt](T& c) {
+                    c.T::update(dt);    // qualified call, no virtual dispatch
+                    });
+                });
+            return true;
+        }
+    }
+
+    // Passes with the same order run in registration order
+    void addPass(int order, PassFn fn) {
+        Pass pass{ order, std::move(fn) };
+        auto it = std::upper_bound(passes.begin(), passes.end(), order,
+            [](int o, const Pass& p) { return o < p.order; });
+        passes.insert(it, std::move(pass));
+    }
+
+    void update(Registry& registry, double dt) {
+        for (auto& pass : passes)
+            pass.fn(registry, dt);
+    }
+
+    size_t passCount() const { return passes.size(); }
+
+private:
+    struct Pass {
+        int order;
+        PassFn fn;
+    };
+
+    std::vector<Pass> passes;
+};
+
+
+// The passes every game world runs after actors have applied their forces
+inline void addGameplayPasses(SystemScheduler& systems) {
+    systems.addComponentPass<PhysicsComponent>(UpdateOrder::Physics);
+
+    systems.addPass(UpdateOrder::Constraints, [](Registry& registry, double) {
+        registry.view<PhysicsComponent, ScreenBoundsComponent>().each(
+            [](PhysicsComponent& physics, ScreenBoundsComponent& bounds) {
+                bounds.apply(physics);
+            });
+        });
+
+    systems.addComponentPass<HealthComponent>(UpdateOrder::Health);     // no-op until health gets an update
+}
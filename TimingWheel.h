@@ -0,0 +1,182 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "Snapshot.h"
+
+
+// Hierarchical timing wheel keyed by expiry tick.
+// Level 0 holds the next SlotCount ticks one bucket per tick, every level above
+// covers SlotCount times the range of the one below and is cascaded down when
+// the lower level wraps. Advancing only touches the entries that are due.
+template <typename T, int SlotBits = 6, int Levels = 3>
+class TimingWheel {
+public:
+    static constexpr uint64_t SlotCount = 1ull << SlotBits;
+    static constexpr uint64_t SlotMask = SlotCount - 1;
+    static constexpr uint64_t MaxDelay = (1ull << (SlotBits * Levels)) - 1;
+
+    TimingWheel() { clear(); }
+
+    uint64_t currentTick() const { return now; }
+    size_t size() const { return count; }
+
+    // Entries scheduled at or before the current tick fire on the next advance
+    void schedule(uint64_t expiryTick, const T& value) {
+        if (expiryTick <= now) expiryTick = now + 1;
+        if (expiryTick - now > MaxDelay) expiryTick = now + MaxDelay;
+
+        uint32_t node = allocNode();
+        nodes[node].expiry = expiryTick;
+        nodes[node].value = value;
+        insert(node);
+        count++;
+    }
+
+    // Step to targetTick, calling onExpire for every entry that became due
+    template <typename F>
+    void advance(uint64_t targetTick, F&& onExpire) {
+        while (now < targetTick) {
+            now++;
+
+            // Pull the next bucket of every level whose lower level just wrapped
+            for (int level = 1; level < Levels; level++) {
+                if ((now & ((1ull << (SlotBits * level)) - 1)) != 0)
+                    break;
+                cascade(level);
+            }
+
+            // Detach the due bucket first, the callback may schedule new entries
+            uint32_t node = buckets[0][now & SlotMask];
+            buckets[0][now & SlotMask] = None;
+
+            while (node != None) {
+                uint32_t next = nodes[node].next;
+                T value = nodes[node].value;
+                freeNode(node);
+                count--;
+                onExpire(value);
+                node = next;
+            }
+        }
+    }
+
+    void clear() {
+        for (auto& level : buckets)
+            for (auto& head : level)
+                head = None;
+        nodes.clear();
+        freeList = None;
+        count = 0;
+    }
+
+    void reset(uint64_t tick = 0) {
+        clear();
+        now = tick;
+    }
+
+    // Room for this many pending entries before the node storage has to grow
+    void reserve(size_t entries) {
+        nodes.reserve(entries);
+    }
+
+    // Visit every pending entry with its expiry tick
+    template <typename F>
+    void forEach(F&& fn) const {
+        for (auto& level : buckets)
+            for (uint32_t head : level)
+                for (uint32_t node = head; node != None; node = nodes[node].next)
+                    fn(nodes[node].expiry, nodes[node].value);
+    }
+
+    // Nodes are written field by field so padding never reaches the snapshot
+    void saveState(SnapshotWriter& out) const {
+        out.write(now);
+        out.write(static_cast<uint64_t>(count));
+        out.write(freeList);
+        out.write(buckets);
+        out.write(static_cast<uint32_t>(nodes.size()));
+        for (const Node& n : nodes) {
+            out.write(n.expiry);
+            out.write(n.value);
+            out.write(n.next);
+        }
+    }
+
+    bool loadState(SnapshotReader& in) {
+        uint64_t storedCount = 0;
+        uint32_t nodeCount = 0;
+        in.read(now);
+        in.read(storedCount);
+        in.read(freeList);
+        in.read(buckets);
+        if (!in.read(nodeCount)) return false;
+
+        count = static_cast<size_t>(storedCount);
+        nodes.resize(nodeCount);
+        for (Node& n : nodes) {
+            in.read(n.expiry);
+            in.read(n.value);
+            in.read(n.next);
+        }
+        return in.good();
+    }
+
+private:
+    static constexpr uint32_t None = 0xFFFFFFFF;
+
+    // Buckets are intrusive lists threaded through one node array, so moving an
+    // entry between buckets is a relink and a bucket never owns memory
+    struct Node {
+        uint64_t expiry;
+        T value;
+        uint32_t next;
+    };
+
+    std::vector<Node> nodes;
+    uint32_t freeList = None;
+    uint32_t buckets[Levels][SlotCount];
+    uint64_t now = 0;
+    size_t count = 0;
+
+    uint32_t allocNode() {
+        if (freeList != None) {
+            uint32_t node = freeList;
+            freeList = nodes[node].next;
+            return node;
+        }
+        nodes.push_back(Node{});
+        return static_cast<uint32_t>(nodes.size() - 1);
+    }
+
+    void freeNode(uint32_t node) {
+        nodes[node].next = freeList;
+        freeList = node;
+    }
+
+    void insert(uint32_t node) {
+        uint64_t expiry = nodes[node].expiry;
+        uint64_t delta = expiry - now;
+
+        int level = 0;
+        while (level < Levels - 1 && delta >= (1ull << (SlotBits * (level + 1))))
+            level++;
+
+        uint32_t& head = buckets[level][(expiry >> (SlotBits * level)) & SlotMask];
+        nodes[node].next = head;
+        head = node;
+    }
+
+    void cascade(int level) {
+        // Everything in this bucket is due within the lower levels' range
+        uint32_t& head = buckets[level][(now >> (SlotBits * level)) & SlotMask];
+        uint32_t node = head;
+        head = None;
+
+        while (node != None) {
+            uint32_t next = nodes[node].next;
+            insert(node);
+            node = next;
+        }
+    }
+};
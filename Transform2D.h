@@ -9,6 +9,7 @@
 #include <glm/gtx/matrix_operation.hpp>
 
 #include "SpriteRenderer.h"
+#include "Snapshot.h"
 
 using namespace glm;
 
@@ -163,4 +164,38 @@ public:
 
 	// ---------------- Virtual ----------------
     virtual void update(double dt) {}
+
+    // ---------------- Snapshots ----------------
+
+    // This transform's state followed by its children's, depth first.
+    // Restoring expects the same hierarchy that was saved.
+    void saveState(SnapshotWriter& out) const {
+        saveOwnState(out);
+        out.write(static_cast<uint32_t>(children.size()));
+        for (auto& c : children)
+            c->saveState(out);
+    }
+
+    bool loadState(SnapshotReader& in) {
+        loadOwnState(in);
+        markDirty();
+        if (!in.expect(static_cast<uint32_t>(children.size()))) return false;
+        for (auto& c : children)
+            if (!c->loadState(in)) return false;
+        return in.good();
+    }
+
+protected:
+    // Subclasses with simulation state extend these, calling the base first
+    virtual void saveOwnState(SnapshotWriter& out) const {
+        out.write(position);
+        out.write(rotation);
+        out.write(scale);
+    }
+
+    virtual void loadOwnState(SnapshotReader& in) {
+        in.read(position);
+        in.read(rotation);
+        in.read(scale);
+    }
 };
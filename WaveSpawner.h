@@ -0,0 +1,293 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "World.h"
+#include "ShipFactory.h"
+#include "Guns.h"
+#include "Random.h"
+
+// What one kind of enemy looks like and hits with
+struct EnemyKind {
+    std::string name;
+    std::string sprite = "enemy_ship_basic";
+    float scale = 50.0f;
+    float health = 100.0f;
+    float damage = 25.0f;
+    float shotInterval = 1.0f;
+};
+
+enum class SpawnPattern { Line, Circle, Grid, Random };
+
+struct Wave {
+    double interval = 0.0;      // seconds after the previous wave started
+    int count = 10;
+    std::vector<std::pair<int, int>> mix;   // kind index, weight; empty for the first kind only
+    SpawnPattern pattern = SpawnPattern::Line;
+    glm::vec2 center = glm::vec2(960.0f, 540.0f);
+    float size = 400.0f;        // line length, circle radius, grid or random square side
+    int perTick = 0;            // most ships activated in one update, 0 for the whole wave at once
+};
+
+// Wave table, one entry per line, kinds before the waves that use them:
+//   kind grunt sprite=enemy_ship_basic scale=50 health=100 damage=25 shot_interval=1
+//   wave interval=2 count=500 pattern=circle x=960 y=540 size=420 mix=grunt:3,heavy:1 per_tick=0
+//   seed = 1
+struct WaveTable {
+    std::vector<EnemyKind> kinds;
+    std::vector<Wave> waves;
+    uint64_t seed = 1;
+
+    int largestWave() const {
+        int largest = 0;
+        for (const Wave& w : waves) largest = std::max(largest, w.count);
+        return largest;
+    }
+
+    // Most ships the table can have alive at once, every wave overlapping
+    int totalShips() const {
+        int total = 0;
+        for (const Wave& w : waves) total += w.count;
+        return total;
+    }
+
+    int kindIndex(const std::string& name) const {
+        for (size_t i = 0; i < kinds.size(); i++)
+            if (kinds[i].name == name) return static_cast<int>(i);
+        return -1;
+    }
+
+    static bool load(const char* path, WaveTable& table, std::string& error) {
+        std::ifstream file(path);
+        if (!file) {
+            error = std::string("Couldn't open wave table ") + path;
+            return false;
+        }
+
+        std::string line;
+        for (int lineNumber = 1; std::getline(file, line); lineNumber++) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream in(line);
+            std::string type;
+            if (!(in >> type)) continue;
+
+            auto fail = [&](const std::string& what) {
+                error = "Line " + std::to_string(lineNumber) + ": " + what;
+                return false;
+            };
+
+            if (type.rfind("seed", 0) == 0) {
+                size_t eq = line.find('=');
+                if (eq == std::string::npos) return fail("expected seed = value");
+                table.seed = std::strtoull(line.c_str() + eq + 1, nullptr, 10);
+                continue;
+            }
+
+            if (type == "kind") {
+                EnemyKind kind;
+                if (!(in >> kind.name)) return fail("kind without a name");
+                for (std::string item; in >> item;) {
+                    size_t eq = item.find('=');
+                    if (eq == std::string::npos) return fail("expected key=value, got " + item);
+                    std::string key = item.substr(0, eq), value = item.substr(eq + 1);
+                    if (key == "sprite") kind.sprite = value;
+                    else if (key == "scale") kind.scale = std::strtof(value.c_str(), nullptr);
+                    else if (key == "health") kind.health = std::strtof(value.c_str(), nullptr);
+                    else if (key == "damage") kind.damage = std::strtof(value.c_str(), nullptr);
+                    else if (key == "shot_interval") kind.shotInterval = std::strtof(value.c_str(), nullptr);
+                    else return fail("unknown kind setting " + key);
+                }
+                table.kinds.push_back(kind);
+                continue;
+            }
+
+            if (type == "wave") {
+                Wave wave;
+                for (std::string item; in >> item;) {
+                    size_t eq = item.find('=');
+                    if (eq == std::string::npos) return fail("expected key=value, got " + item);
+                    std::string key = item.substr(0, eq), value = item.substr(eq + 1);
+                    if (key == "interval") wave.interval = std::strtod(value.c_str(), nullptr);
+                    else if (key == "count") wave.count = std::max(0, std::atoi(value.c_str()));
+                    else if (key == "x") wave.center.x = std::strtof(value.c_str(), nullptr);
+                    else if (key == "y") wave.center.y = std::strtof(value.c_str(), nullptr);
+                    else if (key == "size") wave.size = std::strtof(value.c_str(), nullptr);
+                    else if (key == "per_tick") wave.perTick = std::max(0, std::atoi(value.c_str()));
+                    else if (key == "pattern") {
+                        if (value == "line") wave.pattern = SpawnPattern::Line;
+                        else if (value == "circle") wave.pattern = SpawnPattern::Circle;
+                        else if (value == "grid") wave.pattern = SpawnPattern::Grid;
+                        else if (value == "random") wave.pattern = SpawnPattern::Random;
+                        else return fail("unknown pattern " + value);
+                    }
+                    else if (key == "mix") {
+                        std::istringstream entries(value);
+                        for (std::string entry; std::getline(entries, entry, ',');) {
+                            size_t colon = entry.find(':');
+                            int kind = table.kindIndex(entry.substr(0, colon));
+                            if (kind < 0) return fail("unknown kind " + entry.substr(0, colon));
+                            int weight = colon == std::string::npos ? 1 : std::atoi(entry.c_str() + colon + 1);
+                            if (weight > 0) wave.mix.push_back({ kind, weight });
+                        }
+                    }
+                    else return fail("unknown wave setting " + key);
+                }
+                if (table.kinds.empty()) return fail("wave before any kind");
+                table.waves.push_back(wave);
+                continue;
+            }
+
+            return fail("expected kind, wave or seed");
+        }
+        return true;
+    }
+};
+
+
+// Plays a wave table: starts each wave on its interval, places its ships by pattern
+// with the kinds interleaved by weight, and hands dead ones back to the world's enemy
+// pool on the next update. prewarm() assembles the largest wave's worth of enemies up
+// front, so a wave only resets and enables ships that already exist.
+class WaveSpawner {
+public:
+    std::function<void(Ship&)> onSpawn;     // e.g. hand it to an AI
+    std::function<void(Ship&)> onDespawn;   // before it goes back to the pool
+
+    struct Stats {
+        uint64_t spawned = 0;
+        uint64_t recycled = 0;
+        int lastSpawns = 0;             // in the last update
+        double lastSpawnSeconds = 0.0;
+        double worstSpawnSeconds = 0.0;
+    };
+
+    WaveSpawner(World& world, WaveTable table) : world(world), table(std::move(table)) {}
+
+    void prewarm() {
+        ShipFactory::prewarmEnemies(world, static_cast<size_t>(table.largestWave()));
+        live.reserve(table.largestWave());
+    }
+
+    void update(double dt) {
+        // Dead ships from last tick go back first so this tick can reuse them
+        for (size_t i = 0; i < live.size();) {
+            if (!live[i]->isDead()) {
+                i++;
+                continue;
+            }
+            if (onDespawn) onDespawn(*live[i]);
+            ShipFactory::despawnEnemy(world, std::move(live[i]));
+            live[i] = std::move(live.back());
+            live.pop_back();
+            stats.recycled++;
+        }
+
+        clock += dt;
+        while (next < table.waves.size() && clock >= waveStart + table.waves[next].interval) {
+            waveStart += table.waves[next].interval;
+            pending.push_back({ static_cast<int>(next), 0 });
+            next++;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        stats.lastSpawns = 0;
+        for (size_t p = 0; p < pending.size();) {
+            Pending& wave = pending[p];
+            const Wave& w = table.waves[wave.wave];
+            int end = w.perTick > 0 ? std::min(w.count, wave.spawned + w.perTick) : w.count;
+            stats.lastSpawns += end - wave.spawned;
+            for (; wave.spawned < end; wave.spawned++)
+                spawn(wave.wave, w, wave.spawned);
+
+            if (wave.spawned >= w.count) pending.erase(pending.begin() + p);
+            else p++;
+        }
+        if (stats.lastSpawns > 0) {
+            stats.lastSpawnSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            stats.worstSpawnSeconds = std::max(stats.worstSpawnSeconds, stats.lastSpawnSeconds);
+        }
+    }
+
+    // Ships of all started waves still alive, in no particular order
+    const std::vector<std::shared_ptr<Ship>>& active() const { return live; }
+
+    int wavesStarted() const { return static_cast<int>(next); }
+    bool finished() const { return next == table.waves.size() && pending.empty() && live.empty(); }
+    const Stats& spawnStats() const { return stats; }
+
+private:
+    struct Pending {
+        int wave;
+        int spawned;
+    };
+
+    void spawn(int waveIndex, const Wave& w, int i) {
+        const EnemyKind& kind = table.kinds[kindFor(w, i)];
+        auto ship = ShipFactory::spawnEnemy(world, placeFor(waveIndex, w, i), 0.0f, glm::vec2(kind.scale), kind.sprite);
+        ship->setMaxHealth(kind.health);
+        if (auto gun = std::dynamic_pointer_cast<EnemyGun>(ship->hardpoints[0]->weapon)) {
+            gun->damage = kind.damage;
+            gun->shotInterval = kind.shotInterval;
+        }
+
+        stats.spawned++;
+        if (onSpawn) onSpawn(*ship);
+        live.push_back(std::move(ship));
+    }
+
+    // Kinds interleaved by weight: with grunt:3,heavy:1 every fourth ship is heavy
+    int kindFor(const Wave& w, int i) const {
+        if (w.mix.empty()) return 0;
+        int total = 0;
+        for (auto& [kind, weight] : w.mix) total += weight;
+        int slot = i % total;
+        for (auto& [kind, weight] : w.mix) {
+            if (slot < weight) return kind;
+            slot -= weight;
+        }
+        return w.mix.back().first;
+    }
+
+    glm::vec2 placeFor(int waveIndex, const Wave& w, int i) const {
+        switch (w.pattern) {
+        case SpawnPattern::Line: {
+            float t = w.count > 1 ? float(i) / float(w.count - 1) - 0.5f : 0.0f;
+            return w.center + glm::vec2(t * w.size, 0.0f);
+        }
+        case SpawnPattern::Circle: {
+            float angle = 6.2831853f * float(i) / float(std::max(1, w.count));
+            return w.center + glm::vec2(std::cos(angle), std::sin(angle)) * w.size;
+        }
+        case SpawnPattern::Grid: {
+            int columns = static_cast<int>(std::ceil(std::sqrt(float(w.count))));
+            float spacing = columns > 1 ? w.size / float(columns - 1) : 0.0f;
+            return w.center + (glm::vec2(i % columns, i / columns) - float(columns - 1) * 0.5f) * spacing;
+        }
+        case SpawnPattern::Random:
+        default: {
+            // Same spot for the same ship of the same wave, however the wave is spread over ticks
+            Pcg32 rng(table.seed, static_cast<uint64_t>(waveIndex) * 0x10000u + static_cast<uint64_t>(i));
+            return w.center + glm::vec2(rng.uniform(-0.5f, 0.5f), rng.uniform(-0.5f, 0.5f)) * w.size;
+        }
+        }
+    }
+
+    World& world;
+    WaveTable table;
+
+    double clock = 0.0;
+    double waveStart = 0.0;
+    size_t next = 0;                    // first wave not started
+    std::vector<Pending> pending;       // started, not all spawned yet
+    std::vector<std::shared_ptr<Ship>> live;
+    Stats stats;
+};
@@ -2,30 +2,182 @@
 #include "Actor.h"
 #include "ProjectileSystem.h"
 #include "Events.h"
-#include <random>
 #include "Physics.h"
+#include "Random.h"
 
-#include "Services.h"
+#include "World.h"
 #include "EventBus.h"
 #include "ProjectileSystem.h"
 
 
+enum class FireMode {
+    Projectile, // spawns a projectile entity per shot
+    Hitscan     // resolved instantly with a ray query, only a tracer is drawn
+};
+
+
 class Weapon : public Actor2D{
 protected:
+
+    // Topmost transform this weapon is mounted on (usually the ship)
+    Transform2D* mountRoot() {
+        Transform2D* root = nullptr;
+        auto p = parent.lock();
+        while (p) {
+            root = p.get();
+            p = p->parent.lock();
+        }
+        return root;
+    }
+
+    // Per-weapon generator, seeded from the world so runs can be replayed
+    Pcg32 rng = world ? world->random->makeStream() : Pcg32();
+    NormalSampleBuffer spreadSamples;
+
+    // Normal-distributed spread angle in radians
+    float nextSpread() {
+        return spreadSamples.next(rng) * deviation;
+    }
+
+    // Ages (seconds since due) of the shots collected this tick, reused between ticks
+    std::vector<float> dueShots;
+    std::vector<std::shared_ptr<Projectile>> projectileBatch;
+
+    // Shot clock: fractional time carries over between ticks so the fire rate
+    // does not depend on the frame rate
+    void advanceShotClock(double dt) {
+        nextShot -= dt;
+    }
+
+    // Trigger released or weapon busy: don't bank shots while idle
+    void holdFire() {
+        if (nextShot < 0.0) nextShot = 0.0;
+    }
+
+    // Collect every shot due this tick, oldest first
+    size_t collectDueShots() {
+        dueShots.clear();
+        if (shotInterval <= 0.0) return 0;
+
+        while (nextShot <= 0.0 && dueShots.size() < maxShotsPerTick) {
+            dueShots.push_back(static_cast<float>(-nextShot));
+            nextShot += shotInterval;
+        }
+
+        // Drop whatever is left after a long hitch
+        holdFire();
+        return dueShots.size();
+    }
+
+    // Spawn the collected shots as laser projectiles, each advanced by its sub-tick age
+    void emitProjectiles(vec2 dir, float speed, float lifetime, vec2 scale, const std::string& spriteName) {
+        vec2 origin = getWorldPosition();
+        vec2 velocity = dir * speed;
+
+        for (float age : dueShots)
+            spawnLaser(origin + velocity * age, velocity, lifetime - age, scale, spriteName);
+
+        flushProjectiles();
+    }
+
+    // Take a recycled projectile from the projectile system and queue it for the batch
+    void spawnLaser(vec2 position, vec2 velocity, float lifetime, vec2 scale, const std::string& spriteName) {
+        if (!world) return;
+
+        auto projectile = world->projectiles->acquireLaser();
+        shotsFired++;
+        projectile->reset(position, velocity, lifetime, damage, team);
+        projectile->init();
+        projectile->scale = scale;
+        projectile->spriteName = spriteName;
+        projectileBatch.push_back(std::move(projectile));
+    }
+
+    void flushProjectiles() {
+        if (projectileBatch.empty()) return;
+
+        if (world)
+            world->projectiles->addProjectiles(projectileBatch);
+        projectileBatch.clear();
+    }
+
+    // Resolve a shot immediately against the collision system
+    void fireHitscan(vec2 origin, vec2 dir, float speed, const std::string& tracerSprite, vec2 tracerScale, float age = 0.0f) {
+        float distance = range;
+        Transform2D* shooter = mountRoot();
+        shotsFired++;
+
+        RaycastHit hit;
+        if (world &&
+            world->collisions->raycast(origin, dir, range, hitMask, hit, shooter)) {
+            distance = hit.distance;
+
+            applyLaserHit(world, hit.collider->userData, dir * speed, damage, knockbackScale, team, shooter);
+        }
+
+        if (world) {
+            world->projectiles->addTracer(Tracer{
+                .origin = origin,
+                .direction = dir,
+                .length = distance,
+                .speed = speed,
+                .scale = tracerScale,
+                .spriteName = tracerSprite,
+                .age = age
+                });
+        }
+    }
 	
 public:
-	double shotInterval;
-	double nextShot;
+	double shotInterval = 1.0;
+	double nextShot = 0.0;
+    size_t maxShotsPerTick = 256;
+
+    float damage = 0.0f;
+    int team = 0;
+    float deviation = 0.0f;
+    float recoil = 0.0f;
+
+    FireMode fireMode = FireMode::Projectile;
+    float range = 3000.0f;          // hitscan reach
+    float knockbackScale = 1.0f / 100.0f;
+    int hitMask = CollisionLayer::All - CollisionLayer::Projectile;
 
-    float damage;
-    int team;
-    float deviation;
-    float recoil;
+    // Stat only, not part of snapshots: re-simulated ticks count again
+    uint64_t shotsFired = 0;
 
 
+    void seedRng(uint64_t seed, uint64_t stream = 1) {
+        rng.seed(seed, stream);
+        spreadSamples.reset();
+    }
+
     virtual void startFiring() {};
     virtual void stopFiring() {};
 
+    // Back to a weapon nobody has fired yet, for ships going back to their pool.
+    // Stats and the random stream are kept
+    virtual void resetForPool() {
+        nextShot = 0.0;
+        dueShots.clear();
+        projectileBatch.clear();
+    }
+
+protected:
+    // Shot clock and the random stream; shots in flight belong to the projectile system
+    void saveOwnState(SnapshotWriter& out) const override {
+        Actor2D::saveOwnState(out);
+        out.write(nextShot);
+        out.write(rng);
+        spreadSamples.saveState(out);
+    }
+
+    void loadOwnState(SnapshotReader& in) override {
+        Actor2D::loadOwnState(in);
+        in.read(nextShot);
+        in.read(rng);
+        spreadSamples.loadState(in);
+    }
 };
 
 
@@ -0,0 +1,111 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// A few threads kept around for short data-parallel jobs, so a job doesn't pay for
+// starting threads. parallelFor hands out indices one at a time and the calling thread
+// takes its share too. One job at a time, from one thread.
+class WorkerPool {
+public:
+    // Threads working on a job, the caller included; 0 for one per hardware thread
+    explicit WorkerPool(unsigned threadCount = 0) {
+        if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < threadCount; i++)
+            threads.emplace_back([this] { run(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) t.join();
+    }
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Threads working on a job, the caller included
+    unsigned size() const { return static_cast<unsigned>(threads.size()) + 1; }
+
+    // fn(i) for every i below count, returns once all calls have
+    void parallelFor(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) return;
+        if (threads.empty() || count == 1) {
+            for (size_t i = 0; i < count; i++) fn(i);
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            // A helper that woke late for the previous job may still be looking at it
+            done.wait(lock, [this] { return active == 0; });
+            job = &fn;
+            jobCount = count;
+            next.store(0, std::memory_order_relaxed);
+            remaining = count;
+            generation++;
+        }
+        wake.notify_all();
+
+        work(fn, count);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done.wait(lock, [this] { return remaining == 0 && active == 0; });
+        job = nullptr;
+    }
+
+private:
+    void run() {
+        uint64_t seen = 0;
+        std::unique_lock<std::mutex> lock(mutex);
+        for (;;) {
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+            if (!job) continue;
+
+            const std::function<void(size_t)>& fn = *job;
+            size_t count = jobCount;
+            active++;
+            lock.unlock();
+            work(fn, count);
+            lock.lock();
+            if (--active == 0) done.notify_all();
+        }
+    }
+
+    void work(const std::function<void(size_t)>& fn, size_t count) {
+        size_t finished = 0;
+        for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+            fn(i);
+            finished++;
+        }
+        if (finished == 0) return;
+
+        std::lock_guard<std::mutex> lock(mutex);
+        remaining -= finished;
+        if (remaining == 0) done.notify_all();
+    }
+
+    std::vector<std::thread> threads;
+    std::mutex mutex;
+    std::condition_variable wake, done;
+
+    // Guarded by mutex
+    const std::function<void(size_t)>* job = nullptr;
+    size_t jobCount = 0;
+    size_t remaining = 0;
+    unsigned active = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+
+    std::atomic<size_t> next{ 0 };
+};
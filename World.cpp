@@ -0,0 +1,23 @@
+#include "World.h"
+#include "EventBus.h"
+#include "Registry.h"
+#include "DamageSystem.h"
+#include "Random.h"
+#include "CollisionSystem.h"
+#include "ProjectileSystem.h"
+#include "Ship.h"
+#include "Pool.h"
+
+World::World(uint64_t seed)
+    : eventBus(std::make_unique<EventBus>()),
+      registry(std::make_unique<Registry>()),
+      damage(std::make_unique<DamageSystem>()),
+      random(std::make_unique<RandomService>(seed)),
+      collisions(std::make_unique<CollisionSystem>()),
+      projectiles(std::make_unique<ProjectileSystem>()),
+      ships(std::make_unique<ObjectPool<Ship>>(32)),
+      enemyShips(std::make_unique<ObjectPool<Ship>>(32)) {
+    projectiles->world = this;
+}
+
+World::~World() = default;
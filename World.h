@@ -0,0 +1,64 @@
+#pragma once
+#include <memory>
+#include <cstdint>
+
+class EventBus;
+class ProjectileSystem;
+class CollisionSystem;
+class RandomService;
+class Registry;
+class DamageSystem;
+class Ship;
+template <typename T> class ObjectPool;
+
+// One simulation: its events, entities, projectiles, colliders, random streams,
+// damage queue and pooled ships. Worlds share nothing, so separate matches can run
+// side by side, one per thread.
+//
+// Actors join the world that is current on their thread when they are constructed
+// and reach it through Actor2D::world (components through BaseComponent::world)
+// from then on. Input, assets and sound stay app-wide in Services.
+class World {
+public:
+    // The playfield ships stay in, the same on every machine whatever its display;
+    // peers and replays only agree when they simulate the same one
+    static constexpr float ArenaWidth = 1920.0f;
+    static constexpr float ArenaHeight = 1080.0f;
+
+    explicit World(uint64_t seed);
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
+
+    // Destroyed bottom to top, pooled ships and projectiles before the colliders and
+    // entities they hold. Actors created outside the pools have to go before the world.
+    std::unique_ptr<EventBus> eventBus;
+    std::unique_ptr<Registry> registry;
+    std::unique_ptr<DamageSystem> damage;
+    std::unique_ptr<RandomService> random;
+    std::unique_ptr<CollisionSystem> collisions;
+    std::unique_ptr<ProjectileSystem> projectiles;
+    std::unique_ptr<ObjectPool<Ship>> ships;
+    std::unique_ptr<ObjectPool<Ship>> enemyShips;  // armed, see ShipFactory::prewarmEnemies
+
+    // World new actors on this thread join
+    static World* current() { return currentWorld; }
+    static void makeCurrent(World* world) { currentWorld = world; }
+
+    // Makes a world current on this thread until the scope ends
+    class Scope {
+    public:
+        explicit Scope(World& world) : previous(currentWorld) { currentWorld = &world; }
+        ~Scope() { currentWorld = previous; }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        World* previous;
+    };
+
+private:
+    inline static thread_local World* currentWorld = nullptr;
+};
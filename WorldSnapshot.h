@@ -0,0 +1,127 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include "Snapshot.h"
+#include "Transform2D.h"
+#include "World.h"
+#include "Random.h"
+#include "ProjectileSystem.h"
+#include "CollisionSystem.h"
+#include "DamageSystem.h"
+
+// The whole simulation in one flat buffer: tracked actor hierarchies (transforms,
+// physics, health, weapon clocks and heat), the projectile pool, the world PRNG and
+// the contact table. Taken and restored between ticks, into the same world it was
+// taken from or one built the same way (same actors, same collider registration order).
+class WorldSnapshot {
+public:
+    static constexpr uint32_t Magic = 0x56335753;   // "SW3V"
+
+    explicit WorldSnapshot(World& world) : world(world) {}
+
+    // Root of a hierarchy to include, in a fixed order. Roots can come and go between
+    // ticks (checksums follow them), but a snapshot only restores with the roots it was
+    // saved with
+    void track(Transform2D* root) { roots.push_back(root); }
+    void untrack(Transform2D* root) {
+        auto it = std::find(roots.begin(), roots.end(), root);
+        if (it != roots.end()) roots.erase(it);
+    }
+    void clearTracked() { roots.clear(); }
+
+    bool save(std::vector<uint8_t>& out) const {
+        out.clear();
+        SnapshotWriter writer(out);
+        writer.write(Magic);
+
+        writer.write(static_cast<uint32_t>(roots.size()));
+        for (Transform2D* root : roots)
+            root->saveState(writer);
+
+        world.random->saveState(writer);
+        if (!world.projectiles->saveState(writer)) return false;
+        world.collisions->saveState(writer);
+        return true;
+    }
+
+    // A failed restore leaves the world partly loaded, only restore snapshots of this world
+    bool restore(const std::vector<uint8_t>& data) const {
+        SnapshotReader reader(data);
+        if (!reader.expect(Magic)) return false;
+        if (!reader.expect(static_cast<uint32_t>(roots.size()))) return false;
+
+        for (Transform2D* root : roots)
+            if (!root->loadState(reader)) return false;
+
+        world.random->loadState(reader);
+        if (!world.projectiles->loadState(reader)) return false;
+        // Contacts last, every collider they point at is in place by now
+        if (!world.collisions->loadState(reader)) return false;
+        world.damage->clear();
+
+        return reader.good() && reader.atEnd();
+    }
+
+    uint64_t checksum() {
+        save(scratch);
+        return snapshotChecksum(scratch);
+    }
+
+private:
+    World& world;
+    std::vector<Transform2D*> roots;
+    std::vector<uint8_t> scratch;
+};
+
+
+// Per-tick checksums of a run. Writing one while recording input and checking
+// it on replay points at the first tick where the two simulations part ways.
+class ChecksumTrace {
+public:
+    bool openWrite(const char* path) {
+        file.open(path, std::ios::binary | std::ios::trunc);
+        verifying = false;
+        ticks = 0;
+        return bool(file);
+    }
+
+    bool openVerify(const char* path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) return false;
+        expected.clear();
+        uint64_t value;
+        while (in.read(reinterpret_cast<char*>(&value), sizeof(value)))
+            expected.push_back(value);
+        verifying = true;
+        ticks = 0;
+        divergedAt = -1;
+        return true;
+    }
+
+    bool isOpen() const { return verifying || file.is_open(); }
+
+    // False the first time a verified tick differs
+    bool tick(uint64_t value) {
+        uint64_t t = ticks++;
+        if (!verifying) {
+            if (file.is_open()) file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+            return true;
+        }
+        if (divergedAt >= 0 || t >= expected.size()) return true;
+        if (expected[t] == value) return true;
+        divergedAt = static_cast<int64_t>(t);
+        return false;
+    }
+
+    int64_t firstDivergentTick() const { return divergedAt; }
+    uint64_t tickCount() const { return ticks; }
+
+private:
+    std::ofstream file;
+    std::vector<uint64_t> expected;
+    bool verifying = false;
+    uint64_t ticks = 0;
+    int64_t divergedAt = -1;
+};
@@ -28,9 +28,12 @@ using namespace glm;
 class Ship : public PhysicalActor2D, public IControllable
 {
 
-    std::shared_ptr<HealthComponent> health;
+    ComponentRef<HealthComponent> health;
 
 public:    
+    static constexpr float DefaultMaxHealth = 100.0f;
+    static constexpr float DefaultArmor = 10.0f;
+
     // Ship parameters
     float baseThrust = 3000.0f;
     float bonusThrustMultiplier = 1.2f;
@@ -45,22 +48,22 @@ public:
     glm::vec2 thrustDir = glm::vec2(0.0f);   // local thrust 
     glm::vec2 targetRot = glm::vec2(0.0f);   // desired facing
 
-    glm::vec2 screenMin = glm::vec2(0.0f);
-    glm::vec2 screenMax = glm::vec2(0.0f);
 
     std::vector<std::shared_ptr<Hardpoint>> hardpoints;
     std::unordered_map<int, std::vector<std::shared_ptr<Hardpoint>>> actionMap;
 
+    std::shared_ptr<Collider2D> collider;   // body collider, kept when the ship is recycled
+
     Ship() {
         physics->mass = 10.0f;
         physics->friction = 0.1f;
         physics->angularFriction = 1.0f;
 
-        health = addComponent<HealthComponent>(100.0f, 10.0f, 0);
+        health = addComponent<HealthComponent>(DefaultMaxHealth, DefaultArmor, 0);
 
         // Subscribe to DeathEvent to mark ship as destroyed
-        if (Services::eventBus) {
-            Services::eventBus->process<DeathEvent>([this](const DeathEvent& e) {
+        if (world) {
+            world->eventBus->process<DeathEvent>([this](const DeathEvent& e) {
                 if (e.target == health.get()) {
                     for (auto hp : hardpoints)
                         hp->stopFiring();
@@ -83,12 +86,28 @@ public:
             float rotThrust = applyRotationThrust(targetRot, thrustDir, dt);
         }
 
-		PhysicalActor2D::update(dt);
+        // Integration and border bounces run afterwards as batched component passes
+        markDirty();
+    }
 
-        if (screenMin != screenMax)
-            borderCollision(screenMin, screenMax, 0.5f, -0.06f);
+    // Parent the body collider and tell it who it belongs to
+    void attachCollider(const std::shared_ptr<Collider2D>& c) {
+        collider = c;
+        addChild(c);
 
-        markDirty();
+        c->userData.owner = this;
+        c->userData.entity = getEntity();
+        c->userData.physics = this;
+        c->userData.health = health;
+    }
+
+    void setTeam(int team) {
+        health->setTeam(team);
+    }
+
+    // Bounce off the edges of this rectangle
+    void setScreenBounds(const glm::vec2& min, const glm::vec2& max) {
+        addComponent<ScreenBoundsComponent>(min, max, 0.5f, -0.06f);
     }
 
     void setThrust(const glm::vec2& input) {
@@ -132,24 +151,67 @@ public:
     bool isDead() const { return health->isDead(); }
     void applyDamage(float amount, void* source = nullptr) { health->applyDamage(amount, source); }
     void heal(float amount) { health->heal(amount); }
-    void respawnHealth() { health->respawn(); }
+    void respawnHealth(bool announce = true) { health->respawn(announce); }
+
+    // New maximum, starting out full
+    void setMaxHealth(float maxHp) {
+        health->setMaxHealth(maxHp);
+        health->health = maxHp;
+    }
 
 
-    void respawn(glm::vec2 pos, float rot = 0.0f) {
+    void respawn(glm::vec2 pos, float rot = 0.0f, bool announce = true) {
         position = pos;
         
-        respawnHealth();
+        respawnHealth(announce);
         resetPhysics();
         markDirty();
     }
 
 
+    // Called by ObjectPool when the ship is handed back. Idle ships keep their entity
+    // but leave the physics and bounds passes, ShipFactory puts them back on spawn
+    void resetForPool() {
+        for (auto& hp : hardpoints) {
+            hp->stopFiring();
+            if (hp->weapon)
+                hp->weapon->resetForPool();
+        }
+
+        // Whatever a spawner made of it, the next spawn starts from a stock ship
+        health->maxHealth = DefaultMaxHealth;
+        health->armor = DefaultArmor;
+
+        thrustDir = glm::vec2(0.0f);
+        targetRot = glm::vec2(0.0f);
+        rotation = 0.0f;
+        if (physics) resetPhysics();
+        suspendPhysics();
+        removeComponent<ScreenBoundsComponent>();
+
+        if (collider)
+            collider->setEnabled(false);
+    }
+
     void addHardpoint(const std::shared_ptr<Hardpoint>& hp, int actionGroup) {
         hardpoints.push_back(hp);
         addChild(hp);
         actionMap[actionGroup].push_back(hp);
     }
 
+protected:
+    void saveOwnState(SnapshotWriter& out) const override {
+        PhysicalActor2D::saveOwnState(out);
+        out.write(thrustDir);
+        out.write(targetRot);
+    }
+
+    void loadOwnState(SnapshotReader& in) override {
+        PhysicalActor2D::loadOwnState(in);
+        in.read(thrustDir);
+        in.read(targetRot);
+    }
+
 private:
 
     // -----------------------------------------
@@ -198,27 +260,6 @@ private:
         return torque;
     }
 
-    void borderCollision(const glm::vec2& screenMin, const glm::vec2& screenMax, float restitution = 0.5f, float spinFactor = 0.3f) {
-		vec2 velocity = physics->velocity;
-		float angularVelocity = physics->angularVelocity;
-
-        // X-axis
-        if (position.x < screenMin.x) { position.x = screenMin.x; 
-            if (velocity.x < 0.0f) { velocity.x = -velocity.x * restitution; angularVelocity += velocity.y * spinFactor; } }
-        else if (position.x > screenMax.x) { position.x = screenMax.x; 
-            if (velocity.x > 0.0f) { velocity.x = -velocity.x * restitution; angularVelocity -= velocity.y * spinFactor; } }
-
-        // Y-axis
-        if (position.y < screenMin.y) { position.y = screenMin.y; 
-            if (velocity.y < 0.0f) { velocity.y = -velocity.y * restitution; angularVelocity -= velocity.x * spinFactor; } }
-        else if (position.y > screenMax.y) { position.y = screenMax.y; 
-            if (velocity.y > 0.0f) { velocity.y = -velocity.y * restitution; angularVelocity += velocity.x * spinFactor; } }
-
-		physics->velocity = velocity;
-		physics->angularVelocity = angularVelocity;
-    }
-
-
     //void produceParticles(float thrust, double dt) {
     //    if (thrust < 0.001f)
     //        return;